@@ -124,6 +124,16 @@ uint16_t XY( uint8_t x, uint8_t y)
 }
 
 
+// The same layouts can also be built into an XYMap once, in setup(), which
+// turns the coordinate math into a table lookup.  The 2D library functions
+// (blur2d, blurBox2d, fill_2dnoise8, ...) take the map directly:
+//
+//    XYMap xymap( kMatrixWidth, kMatrixHeight);
+//    xymap.setSerpentine();    // or setRowMajor(), setPanels(...), setFunction(...)
+//    leds[ xymap( x, y) ] = CHSV( random8(), 255, 255);
+//    blur2d( leds, xymap, 64);
+
+
 // Once you've gotten the basics working (AND NOT UNTIL THEN!)
 // here's a helpful technique that can be tricky to set up, but 
 // then helps you avoid the needs for sprinkling array-bound-checking
@@ -28,6 +28,14 @@ uint32_t _frame_cnt=0;
 /// @todo Include in FASTLED_DEBUG_COUNT_FRAME_RETRIES block?
 uint32_t _retry_cnt=0;
 
+#if FASTLED_PROFILE
+/// Run a statement, recording how long it takes in a CTimingStats
+#define PROFILE_TIME(stats, statement) do { uint32_t nProfileStart = micros(); statement; (stats).record(micros() - nProfileStart); } while(0)
+#else
+/// Run a statement (and time it, when FASTLED_PROFILE is turned on)
+#define PROFILE_TIME(stats, statement) do { statement; } while(0)
+#endif
+
 // uint32_t CRGB::Squant = ((uint32_t)((__TIME__[4]-'0') * 28))<<16 | ((__TIME__[6]-'0')*50)<<8 | ((__TIME__[7]-'0')*28);
 
 CFastLED::CFastLED() {
@@ -37,6 +45,11 @@ CFastLED::CFastLED() {
 	m_nFPS = 0;
 	m_pPowerFunc = NULL;
 	m_nPowerData = 0xFFFFFFFF;
+	m_bAsyncShow = false;
+	m_pRecorder = NULL;
+#if FASTLED_PROFILE
+	m_nShowEndMicros = 0;
+#endif
 }
 
 CLEDController &CFastLED::addLeds(CLEDController *pLed,
@@ -51,25 +64,260 @@ CLEDController &CFastLED::addLeds(CLEDController *pLed,
 	return *pLed;
 }
 
+CLEDController &CFastLED::addLeds(CLEDController *pLed,
+								  struct CRGB16 *data,
+								  int nLedsOrOffset, int nLedsIfOffset) {
+	int nOffset = (nLedsIfOffset > 0) ? nLedsOrOffset : 0;
+	int nLeds = (nLedsIfOffset > 0) ? nLedsIfOffset : nLedsOrOffset;
+
+	pLed->init();
+	pLed->setLeds(data + nOffset, nLeds);
+	FastLED.setMaxRefreshRate(pLed->getMaxRefreshRate(),true);
+	return *pLed;
+}
+
 void CFastLED::show(uint8_t scale) {
+#if FASTLED_PROFILE
+	uint32_t nShowStart = micros();
+	if(m_ShowStats.getCount()) { m_RenderStats.record(nShowStart - m_nShowEndMicros); }
+#endif
+
 	// guard against showing too rapidly
-	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
+	PROFILE_TIME(m_WaitStats, waitForFrameWindow());
 	lastshow = micros();
 
-	// If we have a function for computing power, use it!
-	if(m_pPowerFunc) {
-		scale = (*m_pPowerFunc)(scale, m_nPowerData);
-	}
+	// record the leds at the brightness asked for, before it's limited for power on this setup
+	if(m_pRecorder) { m_pRecorder->recordFrame(scale); }
+
+	bool bRails;
+	PROFILE_TIME(m_PowerStats, {
+		// controllers on their own supply rail are limited from the requested brightness
+		bRails = calculate_max_brightness_for_power_rails(scale);
+
+		// If we have a function for computing power, use it!
+		if(m_pPowerFunc) {
+			scale = (*m_pPowerFunc)(scale, m_nPowerData);
+		}
+	});
 
 	CLEDController *pCur = CLEDController::head();
 	while(pCur) {
 		uint8_t d = pCur->getDither();
 		if(m_nFPS < 100) { pCur->setDither(0); }
-		pCur->showLeds(scale);
+		uint8_t s = (bRails && pCur->getPowerRail()) ? pCur->getPowerRail()->getBrightness() : scale;
+		// only wait on this controller's previous frame when we're about to overwrite it
+		if(pCur->needsShow(s)) {
+			if(m_bAsyncShow) { PROFILE_TIME(pCur->m_TransmitStats, pCur->waitForShowComplete()); }
+			PROFILE_TIME(pCur->m_EncodeStats, pCur->beginShowLeds(s));
+		}
+		// the leds can change before the next show, unless the sketch promises to flag them
+		if(pCur->m_ChangeDetect != CHANGE_DETECT_MANUAL) { pCur->m_bScanned = false; }
 		pCur->setDither(d);
 		pCur = pCur->next();
 	}
+
+	// every controller is under way now, so the strips go out concurrently and
+	// waiting here takes as long as the longest one rather than the sum of them
+	if(!m_bAsyncShow) {
+		endShow();
+	}
 	countFPS();
+
+#if FASTLED_PROFILE
+	m_nShowEndMicros = micros();
+	m_ShowStats.record(m_nShowEndMicros - nShowStart);
+#endif
+}
+
+uint32_t CFastLED::getMicrosUntilNextFrame() {
+	uint32_t elapsed = micros() - lastshow;
+	return (elapsed < m_nMinMicros) ? (m_nMinMicros - elapsed) : 0;
+}
+
+void CFastLED::waitForFrameWindow() {
+	while(getMicrosUntilNextFrame()) {
+		yield();
+	}
+}
+
+void CFastLED::endShow() {
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		PROFILE_TIME(pCur->m_TransmitStats, pCur->endShow());
+		pCur = pCur->next();
+	}
+}
+
+void CFastLED::waitForShowComplete() {
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		PROFILE_TIME(pCur->m_TransmitStats, pCur->waitForShowComplete());
+		pCur = pCur->next();
+	}
+}
+
+CLEDController & CLEDController::setLeds(CRGB16 *data, int nLeds) {
+	m_Data = NULL;
+	m_Data16 = data;
+	m_nLeds = nLeds;
+	m_bScanned = false;
+
+	// a byte of leftover error for each channel of every lane
+	size_t nBytes = abs(size()) * 3;
+	free(m_pData16Buffer);
+	m_pData16Buffer = nBytes ? (uint8_t*)malloc(nBytes) : NULL;
+	m_bData16Output = false;
+	if(m_pData16Buffer == NULL) {
+		// no leds, or no memory for them, so there's nothing to show
+		m_nLeds = 0;
+		return *this;
+	}
+	memset8(m_pData16Buffer, 0, nBytes);
+	return *this;
+}
+
+void CLEDController::showLeds16(uint8_t brightness, bool begin) {
+	if(m_pData16Buffer == NULL) {
+		return;
+	}
+
+	// the errors line up with the leds, so a reversed strip's start at its last led in memory too
+	uint8_t *pErr = m_pData16Buffer;
+	if(m_nLeds < 0) {
+		pErr += (abs(size()) - 1) * 3;
+	}
+	if(begin) {
+		beginShow16(m_Data16, pErr, m_nLeds, getAdjustment(brightness));
+	} else {
+		show16(m_Data16, pErr, m_nLeds, getAdjustment(brightness));
+	}
+}
+
+const CRGB *CLEDController::quantize16(const CRGB16 *data, uint8_t *err, int nLeds, CRGB scale) {
+	// quantize every lane, from the lowest address, in memory order
+	int n = abs(size());
+	int nFirst = (nLeds < 0) ? (1 - n) : 0;
+	if(!m_bData16Output) {
+		// with a spare led on the end, for clockless drivers that load the byte after the last one
+		uint8_t *pBuffer = (uint8_t*)realloc(m_pData16Buffer, n * (3 + sizeof(CRGB)) + sizeof(CRGB));
+		if(pBuffer == NULL) {
+			return NULL;
+		}
+		m_pData16Buffer = pBuffer;
+		m_bData16Output = true;
+		// the realloc may have moved the errors
+		err = pBuffer + ((nLeds < 0) ? (n - 1) * 3 : 0);
+	}
+	CRGB *pOut = (CRGB*)(m_pData16Buffer + n * 3);
+
+	PixelController<RGB> pixels(data + nFirst, err + nFirst * 3, n, scale);
+	uint8_t *p = (uint8_t*)pOut;
+	while(pixels.has(1)) {
+		*p++ = pixels.quantize<0>(pixels, 0, scale.raw[0]);
+		*p++ = pixels.quantize<1>(pixels, 0, scale.raw[1]);
+		*p++ = pixels.quantize<2>(pixels, 0, scale.raw[2]);
+		pixels.advanceData();
+	}
+	return pOut - nFirst;
+}
+
+/// One step of a FNV-1a hash, cheap enough to run over the whole strip every frame
+static inline uint32_t hash_byte(uint32_t hash, uint8_t b) {
+	return (hash ^ b) * 16777619UL;
+}
+
+void CLEDController::scanLeds() {
+	uint32_t r = 0, g = 0, b = 0;
+	uint32_t hash = 2166136261UL;
+	// size() covers every lane of a block controller, and is negative for a reversed strip,
+	// whose data pointer is at its last led in memory
+	const int nLeds = abs(size());
+	const int nFirst = (size() < 0) ? (1 - nLeds) : 0;
+	if(m_Data16) {
+		const CRGB16 *p = m_Data16 + nFirst;
+		const CRGB16 *end = p + nLeds;
+		while(p < end) {
+			if(m_ChangeDetect == CHANGE_DETECT_HASH) {
+				for(uint8_t c = 0; c < 3; ++c) {
+					hash = hash_byte(hash_byte(hash, p->raw[c] & 0xFF), p->raw[c] >> 8);
+				}
+			}
+			r += p->r >> 8;
+			g += p->g >> 8;
+			b += p->b >> 8;
+			++p;
+		}
+	} else if(m_Data) {
+		const uint8_t *p = (const uint8_t*)(m_Data + nFirst);
+		const uint8_t *end = p + (nLeds * sizeof(CRGB));
+		if(m_ChangeDetect == CHANGE_DETECT_HASH) {
+			while(p < end) {
+				hash = hash_byte(hash, p[0]); r += p[0];
+				hash = hash_byte(hash, p[1]); g += p[1];
+				hash = hash_byte(hash, p[2]); b += p[2];
+				p += 3;
+			}
+		} else {
+			while(p < end) {
+				r += p[0];
+				g += p[1];
+				b += p[2];
+				p += 3;
+			}
+		}
+	}
+	m_ChannelSums[0] = r;
+	m_ChannelSums[1] = g;
+	m_ChannelSums[2] = b;
+	m_nScanHash = hash;
+	m_bScanned = true;
+}
+
+bool CLEDController::needsShow(uint8_t brightness) {
+	if(m_ChangeDetect == CHANGE_DETECT_NONE || !canSkipShow()) {
+		return true;
+	}
+
+	bool show = m_bDirty;
+	uint32_t now = millis();
+	if(m_nRefreshMillis && ((now - m_nLastShowMillis) >= m_nRefreshMillis)) {
+		show = true;
+	}
+
+	CRGB adj = getAdjustment(brightness);
+	if(adj != m_LastAdjustment) {
+		show = true;
+	}
+
+	// error diffusion changes the output of a static frame too, unless every channel scales to a whole 8 bit value
+	if(m_Data16 && !show) {
+		int n = abs(size());
+		const CRGB16 *p = m_Data16 + ((m_nLeds < 0) ? (1 - n) : 0);
+		const CRGB16 *end = p + n;
+		while(p < end && !show) {
+			for(uint8_t c = 0; c < 3; ++c) {
+				if(scale16by8(p->raw[c], adj.raw[c]) & 0xFF) { show = true; }
+			}
+			++p;
+		}
+	}
+
+	uint32_t hash = 0;
+	if(m_ChangeDetect == CHANGE_DETECT_HASH) {
+		if(!m_bScanned) { scanLeds(); }
+		hash = m_nScanHash;
+		if(hash != m_nLastHash) {
+			show = true;
+		}
+	}
+
+	if(show) {
+		m_bDirty = false;
+		m_nLastShowMillis = now;
+		m_nLastHash = hash;
+		m_LastAdjustment = adj;
+	}
+	return show;
 }
 
 int CFastLED::count() {
@@ -95,23 +343,40 @@ CLEDController & CFastLED::operator[](int x) {
 }
 
 void CFastLED::showColor(const struct CRGB & color, uint8_t scale) {
-	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
+#if FASTLED_PROFILE
+	uint32_t nShowStart = micros();
+	if(m_ShowStats.getCount()) { m_RenderStats.record(nShowStart - m_nShowEndMicros); }
+#endif
+
+	PROFILE_TIME(m_WaitStats, waitForFrameWindow());
 	lastshow = micros();
 
 	// If we have a function for computing power, use it!
-	if(m_pPowerFunc) {
-		scale = (*m_pPowerFunc)(scale, m_nPowerData);
-	}
+	PROFILE_TIME(m_PowerStats, if(m_pPowerFunc) { scale = (*m_pPowerFunc)(scale, m_nPowerData); });
 
 	CLEDController *pCur = CLEDController::head();
 	while(pCur) {
 		uint8_t d = pCur->getDither();
 		if(m_nFPS < 100) { pCur->setDither(0); }
-		pCur->showColor(color, scale);
+		if(m_bAsyncShow) { PROFILE_TIME(pCur->m_TransmitStats, pCur->waitForShowComplete()); }
+		PROFILE_TIME(pCur->m_EncodeStats, pCur->beginShowColor(color, scale));
+		// the strip no longer shows the led data
+		pCur->setDirty();
 		pCur->setDither(d);
 		pCur = pCur->next();
 	}
+
+	// every controller is under way now, so the strips go out concurrently and
+	// waiting here takes as long as the longest one rather than the sum of them
+	if(!m_bAsyncShow) {
+		endShow();
+	}
 	countFPS();
+
+#if FASTLED_PROFILE
+	m_nShowEndMicros = micros();
+	m_ShowStats.record(m_nShowEndMicros - nShowStart);
+#endif
 }
 
 void CFastLED::clear(bool writeData) {
@@ -131,16 +396,26 @@ void CFastLED::clearData() {
 
 void CFastLED::delay(unsigned long ms) {
 	unsigned long start = millis();
+	bool bShown = false;
         do {
 #ifndef FASTLED_ACCURATE_CLOCK
 		// make sure to allow at least one ms to pass to ensure the clock moves
 		// forward
 		::delay(1);
 #endif
-		show();
+		// only show when it won't have to wait for the refresh rate, and let other tasks run otherwise
+		if(getMicrosUntilNextFrame() == 0) {
+			show();
+			bShown = true;
+		}
 		yield();
 	}
 	while((millis()-start) < ms);
+
+	// always show at least once, even if the refresh rate didn't allow it in time
+	if(!bShown) {
+		show();
+	}
 }
 
 void CFastLED::setTemperature(const struct CRGB & temp) {
@@ -234,6 +509,84 @@ void CFastLED::countFPS(int nFrames) {
 	}
 }
 
+#if FASTLED_PROFILE
+void CFastLED::resetProfile() {
+	m_RenderStats.reset();
+	m_WaitStats.reset();
+	m_PowerStats.reset();
+	m_ShowStats.reset();
+
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		pCur->m_EncodeStats.reset();
+		pCur->m_TransmitStats.reset();
+		pCur = pCur->next();
+	}
+}
+
+/// A line of the profiling report, passed to the writer whenever it fills up
+class CProfileLine {
+	char mLine[81];
+	uint8_t mLen;
+	void (*mWriteLine)(const char *line);
+
+public:
+	CProfileLine(void (*writeLine)(const char *line)) : mLen(0), mWriteLine(writeLine) {}
+
+	CProfileLine & add(const char *str) {
+		while(*str && mLen < sizeof(mLine) - 1) { mLine[mLen++] = *str++; }
+		return *this;
+	}
+
+	CProfileLine & add(uint32_t n) {
+		char digits[11];
+		uint8_t i = sizeof(digits) - 1;
+		digits[i] = 0;
+		do { digits[--i] = '0' + (n % 10); n /= 10; } while(n);
+		return add(digits + i);
+	}
+
+	/// Write out the line if there's less than the given room left on it
+	void wrap(uint8_t room) { if(mLen > sizeof(mLine) - 1 - room) { flush(); add("   "); } }
+
+	void flush() {
+		mLine[mLen] = 0;
+		mWriteLine(mLine);
+		mLen = 0;
+	}
+};
+
+/// Write out the statistics and the (nonempty) histogram buckets of a stage
+static void dump_timing_stats(CProfileLine & line, const CTimingStats & stats) {
+	line.add(" n=").add(stats.getCount()).add(" min=").add(stats.getMin()).add(" avg=").add(stats.getAverage())
+		.add(" max=").add(stats.getMax()).add(" us");
+	line.flush();
+	bool empty = true;
+	for(uint8_t i = 0; i < FASTLED_PROFILE_BUCKETS; ++i) {
+		if(stats.getBucket(i)) {
+			if(empty) { line.add("   "); } else { line.wrap(20); }
+			line.add(" ").add(i == FASTLED_PROFILE_BUCKETS - 1 ? ">=" : "").add(CTimingStats::getBucketStart(i)).add("us:").add(stats.getBucket(i));
+			empty = false;
+		}
+	}
+	if(!empty) { line.flush(); }
+}
+
+void CFastLED::dumpProfile(void (*writeLine)(const char *line)) {
+	CProfileLine line(writeLine);
+	line.add("render:"); dump_timing_stats(line, m_RenderStats);
+	line.add("wait:"); dump_timing_stats(line, m_WaitStats);
+	line.add("power:"); dump_timing_stats(line, m_PowerStats);
+	line.add("show:"); dump_timing_stats(line, m_ShowStats);
+
+	CLEDController *pCur = CLEDController::head();
+	for(uint32_t i = 0; pCur; ++i, pCur = pCur->next()) {
+		line.add("controller ").add(i).add(" encode:"); dump_timing_stats(line, pCur->getEncodeStats());
+		line.add("controller ").add(i).add(" transmit:"); dump_timing_stats(line, pCur->getTransmitStats());
+	}
+}
+#endif
+
 void CFastLED::setMaxRefreshRate(uint16_t refresh, bool constrain) {
 	if(constrain) {
 		// if we're constraining, the new value of m_nMinMicros _must_ be higher than previously (because we're only
@@ -248,10 +601,12 @@ void CFastLED::setMaxRefreshRate(uint16_t refresh, bool constrain) {
 	}
 }
 
+#if !defined(FASTLED_HOST)
 /// Called at program exit when run in a desktop environment. 
 /// Extra C definition that some environments may need. 
 /// @returns 0 to indicate success
 extern "C" int atexit(void (* /*func*/ )()) { return 0; }
+#endif
 
 #ifdef FASTLED_NEEDS_YIELD
 extern "C" void yield(void) { }
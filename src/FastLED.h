@@ -57,6 +57,7 @@
 // Utility functions
 #include "fastled_delay.h"
 #include "bitswap.h"
+#include "clockless_timing.h"
 
 #include "controller.h"
 #include "fastpin.h"
@@ -69,9 +70,14 @@
 #include "lib8tion.h"
 #include "pixeltypes.h"
 #include "hsv2rgb.h"
+#include "xymap.h"
 #include "colorutils.h"
 #include "pixelset.h"
 #include "colorpalettes.h"
+#include "compositor.h"
+#include "frame_scheduler.h"
+#include "dmx_receiver.h"
+#include "frame_stream.h"
 
 #include "noise.h"
 #include "power_mgt.h"
@@ -219,6 +225,8 @@ enum EBlockChipsets {
 /// @returns the brightness scale, limited to max power
 typedef uint8_t (*power_func)(uint8_t scale, uint32_t data);
 
+class CFrameRecorder;
+
 /// High level controller interface for FastLED.
 /// This class manages controllers, global settings, and trackings such as brightness
 /// and refresh rates, and provides access functions for driving led data to controllers
@@ -232,6 +240,22 @@ class CFastLED {
 	uint32_t m_nMinMicros;    ///< minimum µs between frames, used for capping frame rates
 	uint32_t m_nPowerData;    ///< max power use parameter
 	power_func m_pPowerFunc;  ///< function for overriding brightness when using FastLED.show();
+	bool     m_bAsyncShow;    ///< whether show() returns while controllers are still writing out data
+	CFrameRecorder *m_pRecorder;  ///< records every frame shown, see setRecorder()
+#if FASTLED_PROFILE
+	CTimingStats m_RenderStats;  ///< time between show() returning and the next show(), see getRenderStats()
+	CTimingStats m_WaitStats;    ///< time spent waiting for the maximum refresh rate, see getWaitStats()
+	CTimingStats m_PowerStats;   ///< time spent limiting the brightness for power, see getPowerStats()
+	CTimingStats m_ShowStats;    ///< time spent in show() (or showColor()) overall, see getShowStats()
+	uint32_t m_nShowEndMicros;   ///< micros() when show() last returned
+#endif
+
+	/// Finish the show started on each controller with CLEDController::beginShowLeds()
+	void endShow();
+
+	/// Wait for the next frame to be allowed by the maximum refresh rate, yielding to other
+	/// tasks rather than spinning
+	void waitForFrameWindow();
 
 public:
 	CFastLED();
@@ -250,6 +274,16 @@ public:
 	/// @returns a reference to the added controller
 	static CLEDController &addLeds(CLEDController *pLed, struct CRGB *data, int nLedsOrOffset, int nLedsIfOffset = 0);
 
+	/// Add a CLEDController instance driven from 16 bit per channel led data.  The data is quantized to
+	/// the strip's 8 bits on each show, with temporal error diffusion.
+	/// @see CLEDController::setLeds(CRGB16*, int)
+	/// @param pLed the led controller being added
+	/// @param data base pointer to an array of CRGB16 data structures
+	/// @param nLedsOrOffset number of leds (3 argument version) or offset into the data array
+	/// @param nLedsIfOffset number of leds (4 argument version)
+	/// @returns a reference to the added controller
+	static CLEDController &addLeds(CLEDController *pLed, struct CRGB16 *data, int nLedsOrOffset, int nLedsIfOffset = 0);
+
 	/// @name Adding SPI-based controllers
 	/// Add an SPI based CLEDController instance to the world.
 	///
@@ -324,6 +358,13 @@ public:
 		}
 	}
 
+	/// Add an SPI based CLEDController instance driven from 16 bit led data
+	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER > static CLEDController &addLeds(struct CRGB16 *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		int nOffset = (nLedsIfOffset > 0) ? nLedsOrOffset : 0;
+		int nLeds = (nLedsIfOffset > 0) ? nLedsIfOffset : nLedsOrOffset;
+		return addLeds<CHIPSET, DATA_PIN, CLOCK_PIN, RGB_ORDER>((CRGB*)NULL, 0).setLeds(data + nOffset, nLeds);
+	}
+
 #ifdef SPI_DATA
 	template<ESPIChipsets CHIPSET> static CLEDController &addLeds(struct CRGB *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
 		return addLeds<CHIPSET, SPI_DATA, SPI_CLOCK, RGB>(data, nLedsOrOffset, nLedsIfOffset);
@@ -383,6 +424,27 @@ public:
 		return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset);
 	}
 
+	/// Add a clockless based CLEDController instance driven from 16 bit led data
+	template<template<uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+	static CLEDController &addLeds(struct CRGB16 *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		static CHIPSET<DATA_PIN, RGB_ORDER> c;
+		return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset);
+	}
+
+	/// Add a clockless based CLEDController instance driven from 16 bit led data
+	template<template<uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN>
+	static CLEDController &addLeds(struct CRGB16 *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		static CHIPSET<DATA_PIN, RGB> c;
+		return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset);
+	}
+
+	/// Add a clockless based CLEDController instance driven from 16 bit led data
+	template<template<uint8_t DATA_PIN> class CHIPSET, uint8_t DATA_PIN>
+	static CLEDController &addLeds(struct CRGB16 *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		static CHIPSET<DATA_PIN> c;
+		return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset);
+	}
+
 #if defined(__FASTLED_HAS_FIBCC) && (__FASTLED_HAS_FIBCC == 1)
 	template<uint8_t NUM_LANES, template<uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER=RGB>
 	static CLEDController &addLeds(struct CRGB *data, int nLeds) {
@@ -588,6 +650,29 @@ public:
 	/// Update all our controllers with the current led colors
 	void show() { show(m_Scale); }
 
+	/// Enable or disable asynchronous show.  When enabled, controllers that can write out in the
+	/// background (e.g. the ESP32 RMT driver) encode the frame into their own buffer, start the
+	/// transmission, and return without waiting for it to finish - so the next frame can be
+	/// rendered into the leds array while the current one is still going out on the wire.  Each
+	/// controller is only waited on right before its buffer is needed again by the next show().
+	/// @note Controllers that bit-bang their data out are unaffected, they always block in show()
+	/// @param async true to let show() return while data is still being written
+	void setAsyncShow(bool async = true) { m_bAsyncShow = async; }
+
+	/// Is asynchronous show enabled?
+	/// @see setAsyncShow()
+	bool isAsyncShow() { return m_bAsyncShow; }
+
+	/// Record the leds of every frame shown with show() from now on, e.g. to render a show on
+	/// the host and play it back on a small MCU.  Frames shown with showColor() aren't recorded.
+	/// @see CFrameRecorder
+	/// @param pRecorder the recorder, or NULL to stop recording
+	void setRecorder(CFrameRecorder *pRecorder) { m_pRecorder = pRecorder; }
+
+	/// Block until all controllers have finished writing out the data from the last show().
+	/// Only needed with setAsyncShow(), e.g. before sleeping or reconfiguring pins.
+	void waitForShowComplete();
+
 	/// Clear the leds, wiping the local array of data. Optionally you can also
 	/// send the cleared data to the LEDs.
 	/// @param writeData whether or not to write out to the leds as well
@@ -607,7 +692,8 @@ public:
 
 	/// Delay for the given number of milliseconds.  Provided to allow the library to be used on platforms
 	/// that don't have a delay function (to allow code to be more portable). 
-	/// @note This will call show() constantly to drive the dithering engine (and will call show() at least once).
+	/// @note This will call show() as often as the maximum refresh rate allows, to drive the dithering engine (and
+	/// will call show() at least once).  In between it yields to other tasks.
 	/// @param ms the number of milliseconds to pause for
 	void delay(unsigned long ms);
 
@@ -635,6 +721,13 @@ public:
 	/// @param constrain constrain refresh rate to the slowest speed yet set
 	void setMaxRefreshRate(uint16_t refresh, bool constrain=false);
 
+	/// Get how long it is until show() can write out another frame without waiting, going by the
+	/// maximum refresh rate.  Sketches that have other work to do can use this to call show() only when
+	/// it won't wait (see also CFrameScheduler).
+	/// @see setMaxRefreshRate()
+	/// @returns the time left in µs, or 0 if a frame can be shown now
+	uint32_t getMicrosUntilNextFrame();
+
 	/// For debugging, this will keep track of time between calls to countFPS(). Every
 	/// `nFrames` calls, it will update an internal counter for the current FPS.
 	/// @todo Make this a rolling counter
@@ -645,6 +738,43 @@ public:
 	/// @returns the most recently computed FPS value
 	uint16_t getFPS() { return m_nFPS; }
 
+#if FASTLED_PROFILE
+	/// @name Profiling
+	/// Timings of the stages of show(), when FASTLED_PROFILE is turned on.  The time taken by each
+	/// controller is in CLEDController::getEncodeStats() and CLEDController::getTransmitStats().
+	/// @{
+
+	/// Get the time between show() returning and show() being called again, i.e., the time the
+	/// sketch spends rendering a frame
+	/// @returns the timing statistics
+	const CTimingStats & getRenderStats() const { return m_RenderStats; }
+
+	/// Get the time show() spends waiting so as not to go over the maximum refresh rate
+	/// @see setMaxRefreshRate()
+	/// @returns the timing statistics
+	const CTimingStats & getWaitStats() const { return m_WaitStats; }
+
+	/// Get the time show() spends limiting the brightness for power
+	/// @returns the timing statistics
+	const CTimingStats & getPowerStats() const { return m_PowerStats; }
+
+	/// Get the time spent in show() overall, from being called to returning
+	/// @returns the timing statistics
+	const CTimingStats & getShowStats() const { return m_ShowStats; }
+
+	/// Forget the timings recorded so far, for FastLED and all of the controllers
+	void resetProfile();
+
+	/// Print the timings recorded so far, a line at a time.  For example, to print them over serial:
+	///
+	///     FastLED.dumpProfile([](const char *line) { Serial.println(line); });
+	///
+	/// @param writeLine function called with each line of the report
+	void dumpProfile(void (*writeLine)(const char *line));
+
+	/// @} Profiling
+#endif
+
 	/// Get how many controllers have been registered
 	/// @returns the number of controllers (strips) that have been added with addLeds()
 	int count();
@@ -8,6 +8,91 @@
 
 FASTLED_NAMESPACE_BEGIN
 
+/// Transpose an 8x8 bit matrix, held in two words. 
+/// On the way in, each byte is a lane: lanes 7..4 in @p x and lanes 3..0 in @p y,
+/// lowest lane in the lowest byte. On the way out, each byte is a bit plane, with
+/// lane j in bit j: the planes of bits 7..4 in @p x and of bits 3..0 in @p y, highest
+/// bit in the highest byte. This is the kernel that all of the transpose functions share.
+/// Based on code found here: https://web.archive.org/web/20190108225554/http://www.hackersdelight.org/hdcodetxt/transpose8.c.txt
+/// @param x lanes 7..4 in, planes 7..4 out
+/// @param y lanes 3..0 in, planes 3..0 out
+__attribute__((always_inline)) inline void transpose8x8(uint32_t & x, uint32_t & y) {
+  uint32_t t;
+
+  // pre-transform x
+  t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >>14)) & 0x0000CCCC;  x = x ^ t ^ (t <<14);
+
+  // pre-transform y
+  t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+  t = (y ^ (y >>14)) & 0x0000CCCC;  y = y ^ t ^ (t <<14);
+
+  // final transform
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+}
+
+/// Transpose a 4x4 byte matrix. 
+/// Byte k of word g in @p in0 .. @p in3 goes to byte g of word 3-k in @p out0 .. @p out3,
+/// so that, with the bit planes from transpose8x8() for up to 4 groups of lanes, each
+/// output word is one plane for all of the lanes, highest bit first.
+__attribute__((always_inline)) inline void transpose4x4bytes(uint32_t in0, uint32_t in1, uint32_t in2, uint32_t in3,
+                                                             uint32_t & out0, uint32_t & out1, uint32_t & out2, uint32_t & out3) {
+  // pair up the groups: bytes 2 and 0, and bytes 3 and 1, of groups 0 and 1 (and 2 and 3)
+  uint32_t even01 = (in0 & 0x00FF00FF) | ((in1 << 8) & 0xFF00FF00);
+  uint32_t odd01 = ((in0 >> 8) & 0x00FF00FF) | (in1 & 0xFF00FF00);
+  uint32_t even23 = (in2 & 0x00FF00FF) | ((in3 << 8) & 0xFF00FF00);
+  uint32_t odd23 = ((in2 >> 8) & 0x00FF00FF) | (in3 & 0xFF00FF00);
+
+  // then the pairs
+  out0 = (odd01 >> 16) | (odd23 & 0xFFFF0000);
+  out1 = (even01 >> 16) | (even23 & 0xFFFF0000);
+  out2 = (odd01 & 0x0000FFFF) | (odd23 << 16);
+  out3 = (even01 & 0x0000FFFF) | (even23 << 16);
+}
+
+/// Transpose one byte from each of 8, 16, 24, or 32 lanes into 8 bit planes. 
+/// This is the bit rotation that parallel output needs: plane k holds one bit from
+/// every lane, with lane j in bit j, ready to be written to the output port (or
+/// shifted into place in a DMA word) in one go.
+/// @tparam LANES the number of lanes: 8, 16, 24, or 32
+/// @tparam MSB if true, plane 0 holds bit 7 of each lane (the order WS2812 style
+/// chipsets send the bits in); if false, plane 0 holds bit 0
+/// @tparam m the stride between lanes in @p A, in bytes (e.g. 3 to take one color
+/// channel from a row of CRGBs)
+/// @tparam n the stride between planes in @p B, in planes
+/// @tparam PLANE the type of a plane, wide enough for @p LANES bits (deduced)
+/// @param A the byte for each lane
+/// @param B the 8 bit planes
+template<int LANES, bool MSB = true, int m = 1, int n = 1, typename PLANE>
+__attribute__((always_inline)) inline void transposeLanes(const uint8_t *A, PLANE *B) {
+  static_assert(LANES == 8 || LANES == 16 || LANES == 24 || LANES == 32, "transposeLanes handles 8, 16, 24, or 32 lanes");
+  static_assert(sizeof(PLANE) * 8 >= LANES, "the plane type is too narrow for this many lanes");
+
+  // transpose each group of 8 lanes, the missing groups are all 0
+  uint32_t hi[4] = { 0, 0, 0, 0 }, lo[4] = { 0, 0, 0, 0 };
+  for(int g = 0; g < LANES / 8; ++g) {
+    const uint8_t *p = A + (8 * g * m);
+    lo[g] = (uint32_t)p[0] | ((uint32_t)p[m] << 8) | ((uint32_t)p[2*m] << 16) | ((uint32_t)p[3*m] << 24);
+    hi[g] = (uint32_t)p[4*m] | ((uint32_t)p[5*m] << 8) | ((uint32_t)p[6*m] << 16) | ((uint32_t)p[7*m] << 24);
+    transpose8x8(hi[g], lo[g]);
+  }
+
+  // then gather each plane's byte from every group
+  uint32_t p7, p6, p5, p4, p3, p2, p1, p0;
+  transpose4x4bytes(hi[0], hi[1], hi[2], hi[3], p7, p6, p5, p4);
+  transpose4x4bytes(lo[0], lo[1], lo[2], lo[3], p3, p2, p1, p0);
+
+  if(MSB) {
+    B[0] = p7;    B[n] = p6;    B[2*n] = p5;  B[3*n] = p4;
+    B[4*n] = p3;  B[5*n] = p2;  B[6*n] = p1;  B[7*n] = p0;
+  } else {
+    B[0] = p0;    B[n] = p1;    B[2*n] = p2;  B[3*n] = p3;
+    B[4*n] = p4;  B[5*n] = p5;  B[6*n] = p6;  B[7*n] = p7;
+  }
+}
+
 
 #if defined(FASTLED_ARM) || defined(FASTLED_ESP8266) || defined(FASTLED_DOXYGEN)
 /// Structure representing 8 bits of access
@@ -188,24 +273,13 @@ void transpose8x1_noinline(unsigned char *A, unsigned char *B);
 
 /// @copydoc transpose8x1_noinline()
 __attribute__((always_inline)) inline void transpose8x1(unsigned char *A, unsigned char *B) {
-  uint32_t x, y, t;
+  uint32_t x, y;
 
   // Load the array and pack it into x and y.
   y = *(unsigned int*)(A);
   x = *(unsigned int*)(A+4);
 
-  // pre-transform x
-  t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
-  t = (x ^ (x >>14)) & 0x0000CCCC;  x = x ^ t ^ (t <<14);
-
-  // pre-transform y
-  t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
-  t = (y ^ (y >>14)) & 0x0000CCCC;  y = y ^ t ^ (t <<14);
-
-  // final transform
-  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
-  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
-  x = t;
+  transpose8x8(x, y);
 
   *((uint32_t*)B) = y;
   *((uint32_t*)(B+4)) = x;
@@ -214,24 +288,13 @@ __attribute__((always_inline)) inline void transpose8x1(unsigned char *A, unsign
 /// Simplified form of bits rotating function. 
 /// Based on code found here: https://web.archive.org/web/20190108225554/http://www.hackersdelight.org/hdcodetxt/transpose8.c.txt
 __attribute__((always_inline)) inline void transpose8x1_MSB(unsigned char *A, unsigned char *B) {
-  uint32_t x, y, t;
+  uint32_t x, y;
 
   // Load the array and pack it into x and y.
   y = *(unsigned int*)(A);
   x = *(unsigned int*)(A+4);
 
-  // pre-transform x
-  t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
-  t = (x ^ (x >>14)) & 0x0000CCCC;  x = x ^ t ^ (t <<14);
-
-  // pre-transform y
-  t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
-  t = (y ^ (y >>14)) & 0x0000CCCC;  y = y ^ t ^ (t <<14);
-
-  // final transform
-  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
-  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
-  x = t;
+  transpose8x8(x, y);
 
   B[7] = y; y >>= 8;
   B[6] = y; y >>= 8;
@@ -248,7 +311,7 @@ __attribute__((always_inline)) inline void transpose8x1_MSB(unsigned char *A, un
 /// Based on code found here: https://web.archive.org/web/20190108225554/http://www.hackersdelight.org/hdcodetxt/transpose8.c.txt
 template<int m, int n>
 __attribute__((always_inline)) inline void transpose8(unsigned char *A, unsigned char *B) {
-  uint32_t x, y, t;
+  uint32_t x, y;
 
   // Load the array and pack it into x and y.
   if(m == 1) {
@@ -259,18 +322,7 @@ __attribute__((always_inline)) inline void transpose8(unsigned char *A, unsigned
     y = (A[4*m]<<24) | (A[5*m]<<16) | (A[6*m]<<8) | A[7*m];
   }
 
-  // pre-transform x
-  t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
-  t = (x ^ (x >>14)) & 0x0000CCCC;  x = x ^ t ^ (t <<14);
-
-  // pre-transform y
-  t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
-  t = (y ^ (y >>14)) & 0x0000CCCC;  y = y ^ t ^ (t <<14);
-
-  // final transform
-  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
-  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
-  x = t;
+  transpose8x8(x, y);
 
   B[7*n] = y; y >>= 8;
   B[6*n] = y; y >>= 8;
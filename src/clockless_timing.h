@@ -0,0 +1,211 @@
+#ifndef __INC_CLOCKLESS_TIMING_H
+#define __INC_CLOCKLESS_TIMING_H
+
+#include "FastLED.h"
+
+/// @file clockless_timing.h
+/// Compile time conversion of clockless chipset timings into the pulses a driver sends
+///
+/// The clockless chipsets in chipsets.h give their timings as three intervals, T1, T2
+/// and T3, in cycles of the clockless clock (see @ref ClocklessChipsets). Each driver
+/// needs them as something else: a number of ticks of a timer, PWM or PIO clock, or a
+/// number of equal length pulses for a parallel output. The templates here do those
+/// conversions at compile time, so that drivers don't have to at startup, and report
+/// how far the result is from the chipset's timing so that a driver can refuse (with a
+/// static_assert) a combination that won't work. They only use integer constants, so
+/// they don't need C++11 constexpr.
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Largest error allowed on any edge of a converted bit, in nanoseconds.
+/// The WS281x datasheets allow 150ns (and most chipsets are happy with more).
+#ifndef FASTLED_CLOCKLESS_MAX_ERROR_NS
+#define FASTLED_CLOCKLESS_MAX_ERROR_NS 150
+#endif
+
+/// @cond
+// The larger of the sizes of two errors
+template<int32_t A, int32_t B>
+struct ClocklessMaxError {
+    static const uint32_t VALUE = (uint32_t)((A < 0 ? -A : A) > (B < 0 ? -B : B) ? (A < 0 ? -A : A) : (B < 0 ? -B : B));
+};
+/// @endcond
+
+/// The timing of a clockless chipset, in nanoseconds.
+/// @tparam _T1 time the line is high for a zero bit
+/// @tparam _T2 time the line stays high for a one bit, after T1
+/// @tparam _T3 time the line is low at the end of a one bit
+/// @tparam CLOCK_HZ the clock the times are counted in (CLOCKLESS_FREQUENCY for
+/// the chipsets in chipsets.h, or 1000000000 for times that are already nanoseconds)
+template<int _T1, int _T2, int _T3, uint32_t CLOCK_HZ>
+struct CClocklessTiming {
+    static const int T1 = _T1;                    ///< T1, in clock cycles
+    static const int T2 = _T2;                    ///< T2, in clock cycles
+    static const int T3 = _T3;                    ///< T3, in clock cycles
+    static const uint32_t CLOCK = CLOCK_HZ;       ///< the clock T1, T2 and T3 are counted in
+
+    /// time the line is high for a zero bit (the first edge)
+    static const uint32_t T0H_NS = (uint32_t)((((uint64_t)T1 * 1000000000ULL) + (CLOCK_HZ / 2)) / CLOCK_HZ);
+    /// time the line is high for a one bit (the second edge)
+    static const uint32_t T1H_NS = (uint32_t)((((uint64_t)(T1 + T2) * 1000000000ULL) + (CLOCK_HZ / 2)) / CLOCK_HZ);
+    /// length of a bit
+    static const uint32_t PERIOD_NS = (uint32_t)((((uint64_t)(T1 + T2 + T3) * 1000000000ULL) + (CLOCK_HZ / 2)) / CLOCK_HZ);
+
+    static_assert(T1 > 0 && T2 > 0 && T3 > 0, "clockless timings must be positive");
+};
+
+/// A clockless chipset's timing, rounded to the ticks of a timer.
+/// Each edge is rounded to the nearest tick, so the errors don't add up over a bit.
+/// @tparam TIMING the chipset's timing, a CClocklessTiming
+/// @tparam TICK_HZ the rate of the timer
+template<class TIMING, uint32_t TICK_HZ>
+struct CClocklessTicks {
+    static const uint32_t TICK = TICK_HZ;   ///< the rate of the timer
+
+    /// ticks the line is high for a zero bit
+    static const uint32_t T0H = (uint32_t)(((uint64_t)TIMING::T1 * TICK_HZ + (TIMING::CLOCK / 2)) / TIMING::CLOCK);
+    /// ticks the line is high for a one bit
+    static const uint32_t T1H = (uint32_t)(((uint64_t)(TIMING::T1 + TIMING::T2) * TICK_HZ + (TIMING::CLOCK / 2)) / TIMING::CLOCK);
+    /// ticks in a bit
+    static const uint32_t PERIOD = (uint32_t)(((uint64_t)(TIMING::T1 + TIMING::T2 + TIMING::T3) * TICK_HZ + (TIMING::CLOCK / 2)) / TIMING::CLOCK);
+
+    /// @name The intervals between the edges, in ticks, for drivers that time T1, T2 and T3 separately
+    /// @{
+    static const uint32_t T1 = T0H;           ///< T1, in ticks
+    static const uint32_t T2 = T1H - T0H;     ///< T2, in ticks
+    static const uint32_t T3 = PERIOD - T1H;  ///< T3, in ticks
+    /// @}
+
+    /// @name How far each edge is from the chipset's timing, in nanoseconds (positive is late)
+    /// @{
+    static const int32_t T0H_ERROR_NS = (int32_t)(((uint64_t)T0H * 1000000000ULL + (TICK_HZ / 2)) / TICK_HZ) - (int32_t)TIMING::T0H_NS;
+    static const int32_t T1H_ERROR_NS = (int32_t)(((uint64_t)T1H * 1000000000ULL + (TICK_HZ / 2)) / TICK_HZ) - (int32_t)TIMING::T1H_NS;
+    static const int32_t PERIOD_ERROR_NS = (int32_t)(((uint64_t)PERIOD * 1000000000ULL + (TICK_HZ / 2)) / TICK_HZ) - (int32_t)TIMING::PERIOD_NS;
+    /// @}
+
+    /// the largest error on any edge, in nanoseconds
+    static const uint32_t MAX_ERROR_NS = ClocklessMaxError<ClocklessMaxError<T0H_ERROR_NS, T1H_ERROR_NS>::VALUE, PERIOD_ERROR_NS>::VALUE;
+
+    /// true if the three intervals are all at least a tick, and no edge is off by more
+    /// than FASTLED_CLOCKLESS_MAX_ERROR_NS
+    static const bool VALID = T0H > 0 && T1H > T0H && PERIOD > T1H && MAX_ERROR_NS <= FASTLED_CLOCKLESS_MAX_ERROR_NS;
+};
+
+/// @cond
+// The largest pulse length, at most I, that T1, T2 and T3 are all whole multiples of,
+// give or take P cycles (1 if none is)
+template<int T1, int T2, int T3, int P, int I>
+struct ClocklessCommonPulse {
+    static const int VALUE = (T1 % I <= P && T2 % I <= P && T3 % I <= P) ? I : ClocklessCommonPulse<T1, T2, T3, P, I - 1>::VALUE;
+};
+template<int T1, int T2, int T3, int P>
+struct ClocklessCommonPulse<T1, T2, T3, P, 1> {
+    static const int VALUE = 1;
+};
+
+// Loosen the precision P until there is a common pulse length, and not too many pulses
+template<int T1, int T2, int T3, int MAX_PULSES, int P, int SMALLEST,
+         bool FOUND = (ClocklessCommonPulse<T1, T2, T3, P, SMALLEST>::VALUE != 1
+                       && T1 / ClocklessCommonPulse<T1, T2, T3, P, SMALLEST>::VALUE
+                          + T2 / ClocklessCommonPulse<T1, T2, T3, P, SMALLEST>::VALUE
+                          + T3 / ClocklessCommonPulse<T1, T2, T3, P, SMALLEST>::VALUE <= MAX_PULSES)
+                      || P >= SMALLEST>
+struct ClocklessPulseSearch {
+    static const int PULSE = ClocklessPulseSearch<T1, T2, T3, MAX_PULSES, P + 1, SMALLEST>::PULSE;
+};
+template<int T1, int T2, int T3, int MAX_PULSES, int P, int SMALLEST>
+struct ClocklessPulseSearch<T1, T2, T3, MAX_PULSES, P, SMALLEST, true> {
+    static const int PULSE = ClocklessCommonPulse<T1, T2, T3, P, SMALLEST>::VALUE;
+};
+/// @endcond
+
+/// A clockless chipset's timing, as a pattern of equal length pulses.
+/// This is for drivers that send a bit as a number of samples, all the same length,
+/// like the ESP32 I2S driver: a bit is PULSES_PER_BIT pulses, the first ONES_FOR_ZERO
+/// of them high for a zero bit and the first ONES_FOR_ONE high for a one bit. The pulse
+/// length is the largest one that T1, T2, and T3 are all (close to) multiples of, with
+/// no more than MAX_PULSES pulses in a bit; the driver then runs its clock at
+/// PULSES_PER_BIT times the bit rate, so the bit period is kept and the edges move.
+/// @tparam TIMING the chipset's timing, a CClocklessTiming
+/// @tparam MAX_PULSES the most pulses a bit can take
+template<class TIMING, int MAX_PULSES>
+struct CClocklessPulses {
+    /// @cond
+    static const int SMALLEST = (TIMING::T1 < TIMING::T2)
+        ? (TIMING::T1 < TIMING::T3 ? TIMING::T1 : TIMING::T3)
+        : (TIMING::T2 < TIMING::T3 ? TIMING::T2 : TIMING::T3);
+    /// @endcond
+
+    /// length of a pulse, in clock cycles
+    static const int PULSE = ClocklessPulseSearch<TIMING::T1, TIMING::T2, TIMING::T3, MAX_PULSES, 0, SMALLEST>::PULSE;
+    /// pulses in a bit
+    static const int PULSES_PER_BIT = TIMING::T1 / PULSE + TIMING::T2 / PULSE + TIMING::T3 / PULSE;
+    /// pulses that are high for a zero bit
+    static const int ONES_FOR_ZERO = TIMING::T1 / PULSE;
+    /// pulses that are high for a one bit
+    static const int ONES_FOR_ONE = TIMING::T1 / PULSE + TIMING::T2 / PULSE;
+
+    /// @name The pulse rate, as a fraction, in Hz: PULSES_PER_BIT pulses in each bit period
+    /// @{
+    static const uint64_t PULSE_HZ_NUM = (uint64_t)PULSES_PER_BIT * TIMING::CLOCK;           ///< numerator
+    static const uint32_t PULSE_HZ_DEN = TIMING::T1 + TIMING::T2 + TIMING::T3;               ///< denominator
+    /// @}
+
+    /// @name How far each edge is from the chipset's timing, in nanoseconds (positive is late)
+    /// @{
+    static const int32_t T0H_ERROR_NS = (int32_t)((ONES_FOR_ZERO * TIMING::PERIOD_NS + PULSES_PER_BIT / 2) / PULSES_PER_BIT) - (int32_t)TIMING::T0H_NS;
+    static const int32_t T1H_ERROR_NS = (int32_t)((ONES_FOR_ONE * TIMING::PERIOD_NS + PULSES_PER_BIT / 2) / PULSES_PER_BIT) - (int32_t)TIMING::T1H_NS;
+    /// @}
+
+    /// the largest error on any edge, in nanoseconds
+    static const uint32_t MAX_ERROR_NS = ClocklessMaxError<T0H_ERROR_NS, T1H_ERROR_NS>::VALUE;
+
+    /// true if the pattern fits in MAX_PULSES, has all three intervals, and no edge is
+    /// off by more than FASTLED_CLOCKLESS_MAX_ERROR_NS
+    static const bool VALID = PULSES_PER_BIT <= MAX_PULSES && ONES_FOR_ZERO > 0 && ONES_FOR_ONE > ONES_FOR_ZERO
+                              && PULSES_PER_BIT > ONES_FOR_ONE && MAX_ERROR_NS <= FASTLED_CLOCKLESS_MAX_ERROR_NS;
+};
+
+/// @cond
+// Best b/a, a from A down to 1, for REM/DEN: the one with the smallest error, and
+// the smallest a for a tie
+template<uint64_t REM, uint64_t DEN, int A>
+struct FractionalDividerSearch {
+    typedef FractionalDividerSearch<REM, DEN, A - 1> Smaller;
+    static const uint32_t B_HERE = (uint32_t)((REM * A * 2 + DEN) / (DEN * 2));
+    static const uint64_t ERROR_HERE = (REM * A > B_HERE * DEN) ? (REM * A - B_HERE * DEN) : (B_HERE * DEN - REM * A);
+    // the error of b/a is ERROR/(DEN*a), so compare ERROR_HERE/A with Smaller's
+    static const bool BETTER = ERROR_HERE * Smaller::BEST_A < Smaller::ERROR * A;
+    static const int BEST_A = BETTER ? A : Smaller::BEST_A;
+    static const uint32_t B = BETTER ? B_HERE : Smaller::B;
+    static const uint64_t ERROR = BETTER ? ERROR_HERE : Smaller::ERROR;
+};
+template<uint64_t REM, uint64_t DEN>
+struct FractionalDividerSearch<REM, DEN, 0> {
+    static const int BEST_A = 1;
+    static const uint32_t B = 0;
+    static const uint64_t ERROR = REM;
+};
+/// @endcond
+
+/// A clock divider with a fractional part, N + B/A, for a NUM/DEN division.
+/// For peripherals with an integer and a fractional divider, like the ESP32 I2S clock,
+/// this picks the fraction with a denominator of at most MAX_A that comes closest.
+/// @tparam NUM the source clock (times DEN)
+/// @tparam DEN the target rate's denominator, NUM/DEN is the division wanted
+/// @tparam MAX_A the largest denominator the peripheral takes
+template<uint64_t NUM, uint64_t DEN, int MAX_A>
+struct CFractionalDivider {
+    /// @cond
+    typedef FractionalDividerSearch<NUM % DEN, DEN, MAX_A> Search;
+    // rounding the fraction up to 1 carries into N
+    static const bool CARRY = Search::B >= (uint32_t)Search::BEST_A;
+    /// @endcond
+    static const uint32_t N = (uint32_t)(NUM / DEN) + (CARRY ? 1 : 0);  ///< integer part of the divider
+    static const uint32_t A = CARRY ? 1 : Search::BEST_A;                ///< denominator of the fractional part
+    static const uint32_t B = CARRY ? 0 : Search::B;                    ///< numerator of the fractional part
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -5,6 +5,7 @@
 /// Utility functions for color fill, palettes, blending, and more
 
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
 
 #include "FastLED.h"
@@ -29,6 +30,14 @@ void fill_solid( struct CHSV * targetArray, int numToFill,
     }
 }
 
+void fill_solid( struct CRGB16 * targetArray, int numToFill,
+                 const struct CRGB16& color)
+{
+    for( int i = 0; i < numToFill; ++i) {
+        targetArray[i] = color;
+    }
+}
+
 
 // void fill_solid( struct CRGB* targetArray, int numToFill,
 // 				 const struct CHSV& hsvColor)
@@ -150,6 +159,46 @@ void fill_gradient_RGB( CRGB* leds,
     }
 }
 
+void fill_gradient_RGB( CRGB16* leds,
+                   uint16_t startpos, CRGB16 startcolor,
+                   uint16_t endpos,   CRGB16 endcolor )
+{
+    // if the points are in the wrong order, straighten them
+    if( endpos < startpos ) {
+        uint16_t t = endpos;
+        CRGB16 tc = endcolor;
+        endcolor = startcolor;
+        endpos = startpos;
+        startpos = t;
+        startcolor = tc;
+    }
+
+    // step in 16.16 fixed point, there's no headroom left in 16 bits.  The
+    // steps can be negative, which the unsigned adds below wrap around to.
+    uint16_t pixeldistance = endpos - startpos;
+    int32_t divisor = pixeldistance ? pixeldistance : 1;
+
+    uint32_t rdelta = (uint32_t)((((int64_t)endcolor.r - startcolor.r) * 65536) / divisor);
+    uint32_t gdelta = (uint32_t)((((int64_t)endcolor.g - startcolor.g) * 65536) / divisor);
+    uint32_t bdelta = (uint32_t)((((int64_t)endcolor.b - startcolor.b) * 65536) / divisor);
+
+    uint32_t r = (uint32_t)startcolor.r << 16;
+    uint32_t g = (uint32_t)startcolor.g << 16;
+    uint32_t b = (uint32_t)startcolor.b << 16;
+    for( uint16_t i = startpos; i <= endpos; ++i) {
+        leds[i] = CRGB16( r >> 16, g >> 16, b >> 16);
+        r += rdelta;
+        g += gdelta;
+        b += bdelta;
+    }
+}
+
+void fill_gradient_RGB( CRGB16* leds, uint16_t numLeds, const CRGB16& c1, const CRGB16& c2)
+{
+    uint16_t last = numLeds - 1;
+    fill_gradient_RGB( leds, 0, c1, last, c2);
+}
+
 #if 0
 void fill_gradient( const CHSV& c1, const CHSV& c2)
 {
@@ -213,11 +262,97 @@ void fill_gradient_RGB( CRGB* leds, uint16_t numLeds, const CRGB& c1, const CRGB
 
 
 
+#if !defined(__AVR__)
+// Bulk scaling runs over the channel bytes as one flat buffer, rather than led by led.
+// Where there's a vector unit, the compiler vectorizes the plain byte loop, which beats
+// anything done by hand in a general purpose register.  Otherwise (ESP32, Cortex-M,
+// etc...) it works on a machine word of bytes at a time (SWAR), with each byte widened
+// to a 16 bit lane so that one multiply scales half of the word without carrying into
+// the neighboring lane.  8 bit AVRs have no wide multiply, so they stay with the
+// per-led loops (and their assembly scale8).  BULK_SCALE8_SWAR can be set in the build to
+// pick one way or the other, which is how the host tests check the SWAR path.
+// On the x86-64 host (tests/bench/bench_scale.cpp), bulk nscale8() measures about 0.97x
+// the per-led loop, i.e. no gain, since the compiler vectorizes that loop as it is; the
+// gain there is in nscale8_video(), about 4x, whose per-led branches don't vectorize.
+#define BULK_SCALE8 1
+#ifndef BULK_SCALE8_SWAR
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define BULK_SCALE8_SWAR 0
+#else
+#define BULK_SCALE8_SWAR 1
+#endif
+#endif
+
+#if BULK_SCALE8_SWAR == 1
+#if UINTPTR_MAX > 0xFFFFFFFF
+typedef uint64_t swar_t;
+#define SWAR_LANES 0x00FF00FF00FF00FFULL
+#define SWAR_ONES  0x0001000100010001ULL
+#else
+typedef uint32_t swar_t;
+#define SWAR_LANES 0x00FF00FFUL
+#define SWAR_ONES  0x00010001UL
+#endif
+#endif
+
+/// Scale each byte of a buffer to (mult / 256) of itself, bit-identical to the scalar
+/// scale8 (or scale8_video) semantics.
+/// @tparam VIDEO whether to bump every nonzero byte by one, as nscale8_video() does
+/// @param p the bytes to scale
+/// @param count the number of bytes
+/// @param mult the multiplier, 0-256
+/// @param bump for VIDEO, whether nonzero bytes are bumped (i.e., the scale is nonzero)
+template<bool VIDEO>
+static void bulk_scale8( uint8_t* p, uint32_t count, uint16_t mult, bool bump)
+{
+#if BULK_SCALE8_SWAR == 1
+    // single bytes until the pointer is word aligned
+    while( count && ((uintptr_t)p & (sizeof(swar_t) - 1))) {
+        uint8_t x = *p;
+        *p++ = (((uint16_t)x * mult) >> 8) + ((VIDEO && bump && x) ? 1 : 0);
+        --count;
+    }
+
+    while( count >= sizeof(swar_t)) {
+        swar_t w;
+        memcpy( &w, __builtin_assume_aligned( p, sizeof(swar_t)), sizeof(swar_t));
+        swar_t lo = w & SWAR_LANES;
+        swar_t hi = (w >> 8) & SWAR_LANES;
+        // x * mult is at most 255 * 256, so it fits in its lane
+        swar_t rlo = ((lo * mult) >> 8) & SWAR_LANES;
+        swar_t rhi = (hi * mult) & ~(swar_t)SWAR_LANES;
+        if( VIDEO && bump) {
+            // x + 255 carries into bit 8 of the lane iff x is nonzero.  The scaled
+            // value is at most 254 then, so adding one can't overflow.
+            rlo += ((lo + SWAR_LANES) >> 8) & SWAR_ONES;
+            rhi += (((hi + SWAR_LANES) >> 8) & SWAR_ONES) << 8;
+        }
+        w = rlo | rhi;
+        memcpy( __builtin_assume_aligned( p, sizeof(swar_t)), &w, sizeof(swar_t));
+        p += sizeof(swar_t);
+        count -= sizeof(swar_t);
+    }
+#endif
+
+    while( count) {
+        uint8_t x = *p;
+        *p++ = (((uint16_t)x * mult) >> 8) + ((VIDEO && bump && x) ? 1 : 0);
+        --count;
+    }
+}
+#else
+#define BULK_SCALE8 0
+#endif
+
 void nscale8_video( CRGB* leds, uint16_t num_leds, uint8_t scale)
 {
+#if BULK_SCALE8 == 1
+    bulk_scale8<true>( (uint8_t*)leds, (uint32_t)num_leds * 3, scale, scale != 0);
+#else
     for( uint16_t i = 0; i < num_leds; ++i) {
         leds[i].nscale8_video( scale);
     }
+#endif
 }
 
 void fade_video(CRGB* leds, uint16_t num_leds, uint8_t fadeBy)
@@ -250,9 +385,17 @@ void nscale8_raw( CRGB* leds, uint16_t num_leds, uint8_t scale)
 
 void nscale8( CRGB* leds, uint16_t num_leds, uint8_t scale)
 {
+#if BULK_SCALE8 == 1
+#if (FASTLED_SCALE8_FIXED == 1)
+    bulk_scale8<false>( (uint8_t*)leds, (uint32_t)num_leds * 3, (uint16_t)scale + 1, false);
+#else
+    bulk_scale8<false>( (uint8_t*)leds, (uint32_t)num_leds * 3, scale, false);
+#endif
+#else
     for( uint16_t i = 0; i < num_leds; ++i) {
         leds[i].nscale8( scale);
     }
+#endif
 }
 
 void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask)
@@ -270,6 +413,18 @@ void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask)
 }
 
 
+void fadeToBlackBy( CRGB16* leds, uint16_t num_leds, fract16 fadeBy)
+{
+    nscale16( leds, num_leds, 65535 - fadeBy);
+}
+
+void nscale16( CRGB16* leds, uint16_t num_leds, fract16 scale)
+{
+    for( uint16_t i = 0; i < num_leds; ++i) {
+        leds[i].nscale16( scale);
+    }
+}
+
 CRGB& nblend( CRGB& existing, const CRGB& overlay, fract8 amountOfOverlay )
 {
     if( amountOfOverlay == 0) {
@@ -331,6 +486,26 @@ CRGB* blend( const CRGB* src1, const CRGB* src2, CRGB* dest, uint16_t count, fra
 
 
 
+CRGB16& nblend( CRGB16& existing, const CRGB16& overlay, fract16 amountOfOverlay )
+{
+    existing = existing.lerp16( overlay, amountOfOverlay);
+    return existing;
+}
+
+void nblend( CRGB16* existing, const CRGB16* overlay, uint16_t count, fract16 amountOfOverlay)
+{
+    for( uint16_t i = count; i; --i) {
+        nblend( *existing, *overlay, amountOfOverlay);
+        ++existing;
+        ++overlay;
+    }
+}
+
+CRGB16 blend( const CRGB16& p1, const CRGB16& p2, fract16 amountOfP2 )
+{
+    return p1.lerp16( p2, amountOfP2);
+}
+
 CHSV& nblend( CHSV& existing, const CHSV& overlay, fract8 amountOfOverlay, TGradientDirectionCode directionCode)
 {
     if( amountOfOverlay == 0) {
@@ -497,6 +672,158 @@ void blurColumns(CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount)
 
 
 
+#if defined(__AVR__)
+/// Largest radius for blurBox2d(), which sets how much history is kept for each line
+#define BLUR_MAX_RADIUS 7
+/// Number of columns blurColumns() works through side by side
+#define BLUR_BLOCK 8
+/// Number of lines blurBox2d() works through side by side
+#define BLUR_BOX_BLOCK 2
+#else
+#define BLUR_MAX_RADIUS 63
+#define BLUR_BLOCK 64
+#define BLUR_BOX_BLOCK 4
+#endif
+
+/// Index in the LED array of the pixel at a row-major position in a mapped matrix
+static inline uint32_t blur_index( const uint16_t* xymap, uint32_t pos)
+{
+    return xymap ? xymap[pos] : pos;
+}
+
+void blur2d( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap)
+{
+    blurRows(leds, width, height, blur_amount, xymap);
+    blurColumns(leds, width, height, blur_amount, xymap);
+}
+
+void blurRows( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap)
+{
+    uint8_t keep = 255 - blur_amount;
+    uint8_t seep = blur_amount >> 1;
+    for( uint16_t row = 0; row < height; ++row) {
+        uint32_t base = (uint32_t)row * width;
+        CRGB carryover = CRGB::Black;
+        uint32_t prev = 0;
+        for( uint16_t i = 0; i < width; ++i) {
+            uint32_t idx = blur_index( xymap, base + i);
+            CRGB cur = leds[idx];
+            CRGB part = cur;
+            part.nscale8( seep);
+            cur.nscale8( keep);
+            cur += carryover;
+            if( i) leds[prev] += part;
+            leds[idx] = cur;
+            carryover = part;
+            prev = idx;
+        }
+    }
+}
+
+void blurColumns(CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap)
+{
+    uint8_t keep = 255 - blur_amount;
+    uint8_t seep = blur_amount >> 1;
+    CRGB carryover[BLUR_BLOCK];
+    // a block of columns at a time, walking down them a row at a time
+    for( uint16_t col0 = 0; col0 < width; col0 += BLUR_BLOCK) {
+        uint16_t cols = (width - col0 < BLUR_BLOCK) ? (width - col0) : BLUR_BLOCK;
+        for( uint16_t c = 0; c < cols; ++c) {
+            carryover[c] = CRGB::Black;
+        }
+        for( uint16_t i = 0; i < height; ++i) {
+            uint32_t base = (uint32_t)i * width + col0;
+            for( uint16_t c = 0; c < cols; ++c) {
+                uint32_t idx = blur_index( xymap, base + c);
+                CRGB cur = leds[idx];
+                CRGB part = cur;
+                part.nscale8( seep);
+                cur.nscale8( keep);
+                cur += carryover[c];
+                if( i) leds[blur_index( xymap, base + c - width)] += part;
+                leds[idx] = cur;
+                carryover[c] = part;
+            }
+        }
+    }
+}
+
+/// Box blur a block of lines side by side.  Pixel k of line l is at the row-major
+/// position first + (l * lineStep) + (k * pixelStep).
+static void blur_box_lines( CRGB* leds, const uint16_t* xymap, uint8_t radius,
+                            uint32_t first, uint8_t lines, uint32_t lineStep,
+                            uint16_t len, uint32_t pixelStep)
+{
+    // the original values of the last radius+1 pixels, which have been overwritten
+    // by the time they drop out of the running sum
+    CRGB history[BLUR_BOX_BLOCK][BLUR_MAX_RADIUS + 1];
+    uint16_t sum[BLUR_BOX_BLOCK][3];
+
+    // reciprocal of the window size, rounded up so that a window of all the same
+    // value averages back to that value
+    uint16_t window = 2 * radius + 1;
+    uint32_t recip = (65536UL + window - 1) / window;
+
+    for( uint8_t l = 0; l < lines; ++l) {
+        uint32_t pos = first + l * lineStep;
+        CRGB edge = leds[blur_index( xymap, pos)];
+        for( uint8_t c = 0; c < 3; ++c) {
+            sum[l][c] = edge.raw[c] * (radius + 1);
+        }
+        for( uint16_t k = 1; k <= radius; ++k) {
+            CRGB px = leds[blur_index( xymap, pos + ((k < len) ? k : len - 1) * pixelStep)];
+            for( uint8_t c = 0; c < 3; ++c) {
+                sum[l][c] += px.raw[c];
+            }
+        }
+    }
+
+    uint8_t slot = 0;
+    for( uint16_t k = 0; k < len; ++k) {
+        // the pixel leaving the window next, max(k - radius, 0), and the one entering it
+        uint8_t behind = (k >= radius) ? ((slot == radius) ? 0 : slot + 1) : 0;
+        uint16_t ahead = ((uint32_t)k + radius + 1 < len) ? k + radius + 1 : len - 1;
+        for( uint8_t l = 0; l < lines; ++l) {
+            uint32_t pos = first + l * lineStep;
+            uint32_t idx = blur_index( xymap, pos + k * pixelStep);
+            history[l][slot] = leds[idx];
+            leds[idx] = CRGB( (sum[l][0] * recip) >> 16, (sum[l][1] * recip) >> 16, (sum[l][2] * recip) >> 16);
+            if( k + 1 < len) {
+                CRGB in = leds[blur_index( xymap, pos + ahead * pixelStep)];
+                const CRGB & out = history[l][behind];
+                for( uint8_t c = 0; c < 3; ++c) {
+                    sum[l][c] += in.raw[c] - out.raw[c];
+                }
+            }
+        }
+        slot = (slot == radius) ? 0 : slot + 1;
+    }
+}
+
+void blurBox2d( CRGB* leds, uint16_t width, uint16_t height, uint8_t radius, const uint16_t* xymap)
+{
+    if( radius > BLUR_MAX_RADIUS) radius = BLUR_MAX_RADIUS;
+    if( radius == 0 || width == 0 || height == 0) return;
+
+    for( uint16_t row0 = 0; row0 < height; row0 += BLUR_BOX_BLOCK) {
+        uint8_t rows = (height - row0 < BLUR_BOX_BLOCK) ? (height - row0) : BLUR_BOX_BLOCK;
+        blur_box_lines( leds, xymap, radius, (uint32_t)row0 * width, rows, width, width, 1);
+    }
+    for( uint16_t col0 = 0; col0 < width; col0 += BLUR_BOX_BLOCK) {
+        uint8_t cols = (width - col0 < BLUR_BOX_BLOCK) ? (width - col0) : BLUR_BOX_BLOCK;
+        blur_box_lines( leds, xymap, radius, col0, cols, 1, height, width);
+    }
+}
+
+void blurGaussian2d( CRGB* leds, uint16_t width, uint16_t height, uint8_t radius, const uint16_t* xymap)
+{
+    blurBox2d( leds, width, height, radius, xymap);
+    blurBox2d( leds, width, height, radius, xymap);
+    blurBox2d( leds, width, height, radius, xymap);
+}
+
+
+
 // CRGB HeatColor( uint8_t temperature)
 //
 // Approximates a 'black body radiation' spectrum for
@@ -1134,6 +1461,43 @@ CHSV ColorFromPalette( const CHSVPalette256& pal, uint8_t index, uint8_t brightn
 }
 
 
+/// Shared implementation of ColorFromPaletteRGB16() for palettes of 2^BITS entries
+template<int BITS>
+static CRGB16 ColorFromPaletteRGB16( const CRGB* entries, uint16_t index, uint16_t brightness, TBlendType blendType)
+{
+    const uint8_t last = (1 << BITS) - 1;
+    uint8_t hi = index >> (16 - BITS);
+    // the part of the index between this entry and the next, scaled up to 16 bits
+    uint16_t lo = (uint16_t)(index << BITS);
+
+    CRGB16 rgb( entries[hi]);
+    if( lo && (blendType != NOBLEND) && !((hi == last) && (blendType == LINEARBLEND_NOWRAP))) {
+        const CRGB& next = entries[(hi + 1) & last];
+        rgb = rgb.lerp16( CRGB16( next), lo);
+    }
+
+    if( brightness != 65535) {
+        rgb.nscale16( brightness);
+    }
+    return rgb;
+}
+
+CRGB16 ColorFromPaletteRGB16( const CRGBPalette16& pal, uint16_t index, uint16_t brightness, TBlendType blendType)
+{
+    return ColorFromPaletteRGB16<4>( pal.entries, index, brightness, blendType);
+}
+
+CRGB16 ColorFromPaletteRGB16( const CRGBPalette32& pal, uint16_t index, uint16_t brightness, TBlendType blendType)
+{
+    return ColorFromPaletteRGB16<5>( pal.entries, index, brightness, blendType);
+}
+
+CRGB16 ColorFromPaletteRGB16( const CRGBPalette256& pal, uint16_t index, uint16_t brightness, TBlendType blendType)
+{
+    return ColorFromPaletteRGB16<8>( pal.entries, index, brightness, blendType);
+}
+
+
 void UpscalePalette(const struct CRGBPalette16& srcpal16, struct CRGBPalette256& destpal256)
 {
     for( int i = 0; i < 256; ++i) {
@@ -7,6 +7,7 @@
 #include "FastLED.h"
 #include "pixeltypes.h"
 #include "fastled_progmem.h"
+#include "xymap.h"
 
 FASTLED_NAMESPACE_BEGIN
 
@@ -29,6 +30,10 @@ void fill_solid( struct CRGB * targetArray, int numToFill,
 void fill_solid( struct CHSV* targetArray, int numToFill,
 				 const struct CHSV& color);
 
+/// @copydoc fill_solid()
+void fill_solid( struct CRGB16* targetArray, int numToFill,
+				 const struct CRGB16& color);
+
 
 /// Fill a range of LEDs with a rainbow of colors. 
 /// The colors making up the rainbow are at full saturation and full
@@ -281,6 +286,24 @@ void fill_gradient_RGB( CRGB* leds, uint16_t numLeds, const CRGB& c1, const CRGB
 /// @param c4 the end color for the gradient
 void fill_gradient_RGB( CRGB* leds, uint16_t numLeds, const CRGB& c1, const CRGB& c2, const CRGB& c3, const CRGB& c4);
 
+/// Fill a range of 16 bit LEDs with a smooth RGB gradient between two RGB colors. 
+/// @see fill_gradient_RGB(CRGB*, uint16_t, CRGB, uint16_t, CRGB)
+/// @param leds a pointer to the LED array to fill
+/// @param startpos the starting position in the array
+/// @param startcolor the starting color for the gradient
+/// @param endpos the ending position in the array
+/// @param endcolor the end color for the gradient
+void fill_gradient_RGB( CRGB16* leds,
+                       uint16_t startpos, CRGB16 startcolor,
+                       uint16_t endpos,   CRGB16 endcolor );
+
+/// Fill a range of 16 bit LEDs with a smooth RGB gradient between two RGB colors. 
+/// @param leds a pointer to the LED array to fill
+/// @param numLeds the number of LEDs to fill
+/// @param c1 the starting color in the gradient
+/// @param c2 the end color for the gradient
+void fill_gradient_RGB( CRGB16* leds, uint16_t numLeds, const CRGB16& c1, const CRGB16& c2);
+
 /// @} ColorFills
 
 
@@ -338,6 +361,19 @@ void nscale8(       CRGB* leds, uint16_t num_leds, uint8_t scale);
 /// @param colormask the color mask to fade with
 void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask);
 
+/// Reduce the brightness of an array of 16 bit pixels all at once. 
+/// This function will eventually fade all the way to black.
+/// @param leds a pointer to the LED array to fade
+/// @param num_leds the number of LEDs to fade
+/// @param fadeBy how much to fade each LED, in 65536ths
+void fadeToBlackBy( CRGB16* leds, uint16_t num_leds, fract16 fadeBy);
+
+/// Scale the brightness of an array of 16 bit pixels all at once. 
+/// @param leds a pointer to the LED array to scale
+/// @param num_leds the number of LEDs to scale
+/// @param scale how much to scale each LED, in 65536ths
+void nscale16( CRGB16* leds, uint16_t num_leds, fract16 scale);
+
 /// @} ColorFades
 
 
@@ -399,6 +435,25 @@ void  nblend( CRGB* existing, CRGB* overlay, uint16_t count, fract8 amountOfOver
 void  nblend( CHSV* existing, CHSV* overlay, uint16_t count, fract8 amountOfOverlay,
              TGradientDirectionCode directionCode = SHORTEST_HUES);
 
+/// Computes a new 16 bit color blended some fraction of the way between two other colors.
+/// @param p1 the first color to blend
+/// @param p2 the second color to blend
+/// @param amountOfP2 the fraction of p2 to blend into p1, in 65536ths
+CRGB16  blend( const CRGB16& p1, const CRGB16& p2, fract16 amountOfP2 );
+
+/// Destructively modifies one 16 bit color, blending in a given fraction of an overlay color
+/// @param existing the color to modify
+/// @param overlay the color to blend into existing
+/// @param amountOfOverlay the fraction of overlay to blend into existing, in 65536ths
+CRGB16& nblend( CRGB16& existing, const CRGB16& overlay, fract16 amountOfOverlay );
+
+/// Destructively blends a given fraction of a 16 bit color array into an existing color array
+/// @param existing the color array to modify
+/// @param overlay the color array to blend into existing
+/// @param count the number of colors to process
+/// @param amountOfOverlay the fraction of overlay to blend into existing, in 65536ths
+void  nblend( CRGB16* existing, const CRGB16* overlay, uint16_t count, fract16 amountOfOverlay);
+
 /// @} ColorBlends
 
 
@@ -452,6 +507,84 @@ void blurRows( CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount);
 /// @copydetails blurRows()
 void blurColumns(CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount);
 
+/// @name Mapped Blurs
+/// Blurs for matrices of any layout, using a precomputed index map instead of calling XY() for every
+/// pixel, and taking sizes over 255.  The map holds the index in the LED array of each pixel, in
+/// row-major order: `xymap[y * width + x]` is the LED at (x, y).  Pass NULL for a matrix that is
+/// laid out row-major already, which may have more than 65536 pixels; a map's indices are 16 bit,
+/// so a mapped matrix can't.  Columns are processed a block at a time, a row of the block after
+/// another, so that the memory being worked on stays close together.
+/// @{
+
+/// Two-dimensional blur filter, the same as blur2d(CRGB*, uint8_t, uint8_t, fract8) but with an index map
+/// @param leds a pointer to the LED array to blur
+/// @param width the width of the matrix
+/// @param height the height of the matrix
+/// @param blur_amount the amount of blur to apply
+/// @param xymap the index of each pixel in the LED array, or NULL for row-major
+void blur2d( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap);
+
+/// Perform a blur1d() on every row of a mapped matrix
+/// @copydetails blur2d(CRGB*, uint16_t, uint16_t, fract8, const uint16_t*)
+void blurRows( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap);
+
+/// Perform a blur1d() on every column of a mapped matrix
+/// @copydetails blur2d(CRGB*, uint16_t, uint16_t, fract8, const uint16_t*)
+void blurColumns(CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap);
+
+/// Box blur: every pixel becomes the average of the square of (2 * radius + 1)
+/// pixels around it, using running sums so that the cost doesn't grow with the
+/// radius.  Pixels past the edges repeat the edge pixel, so light is (roughly)
+/// conserved and repeated blurs don't fade to black.
+/// @param leds a pointer to the LED array to blur
+/// @param width the width of the matrix
+/// @param height the height of the matrix
+/// @param radius the blur radius, capped at 63 (7 on AVR)
+/// @param xymap the index of each pixel in the LED array, or NULL for row-major
+void blurBox2d( CRGB* leds, uint16_t width, uint16_t height, uint8_t radius, const uint16_t* xymap = NULL);
+
+/// Approximate Gaussian blur, made of three box blurs.  The result has a standard
+/// deviation of about sqrt(radius * (radius + 1)) pixels.
+/// @copydetails blurBox2d()
+void blurGaussian2d( CRGB* leds, uint16_t width, uint16_t height, uint8_t radius, const uint16_t* xymap = NULL);
+
+/// Two-dimensional blur filter, over a matrix laid out by an XYMap
+/// @param leds a pointer to the LED array to blur
+/// @param xymap the layout of the matrix
+/// @param blur_amount the amount of blur to apply
+/// @see blur2d(CRGB*, uint8_t, uint8_t, fract8)
+inline void blur2d( CRGB* leds, const XYMap& xymap, fract8 blur_amount) {
+    blur2d( leds, xymap.getWidth(), xymap.getHeight(), blur_amount, xymap.getTable());
+}
+
+/// Perform a blur1d() on every row of a matrix laid out by an XYMap
+/// @copydetails blur2d(CRGB*, const XYMap&, fract8)
+inline void blurRows( CRGB* leds, const XYMap& xymap, fract8 blur_amount) {
+    blurRows( leds, xymap.getWidth(), xymap.getHeight(), blur_amount, xymap.getTable());
+}
+
+/// Perform a blur1d() on every column of a matrix laid out by an XYMap
+/// @copydetails blur2d(CRGB*, const XYMap&, fract8)
+inline void blurColumns( CRGB* leds, const XYMap& xymap, fract8 blur_amount) {
+    blurColumns( leds, xymap.getWidth(), xymap.getHeight(), blur_amount, xymap.getTable());
+}
+
+/// Box blur a matrix laid out by an XYMap, see blurBox2d(CRGB*, uint16_t, uint16_t, uint8_t, const uint16_t*)
+/// @param leds a pointer to the LED array to blur
+/// @param xymap the layout of the matrix
+/// @param radius the blur radius
+inline void blurBox2d( CRGB* leds, const XYMap& xymap, uint8_t radius) {
+    blurBox2d( leds, xymap.getWidth(), xymap.getHeight(), radius, xymap.getTable());
+}
+
+/// Gaussian blur a matrix laid out by an XYMap, see blurGaussian2d(CRGB*, uint16_t, uint16_t, uint8_t, const uint16_t*)
+/// @copydetails blurBox2d(CRGB*, const XYMap&, uint8_t)
+inline void blurGaussian2d( CRGB* leds, const XYMap& xymap, uint8_t radius) {
+    blurGaussian2d( leds, xymap.getWidth(), xymap.getHeight(), radius, xymap.getTable());
+}
+
+/// @} Mapped Blurs
+
 /// @} ColorBlurs
 
 
@@ -1950,6 +2083,31 @@ CHSV ColorFromPalette( const CHSVPalette32& pal,
                       uint8_t brightness=255,
                       TBlendType blendType=LINEARBLEND);
 
+/// Get a 16 bit color from a palette, for use with CRGB16 leds. 
+/// Works like ColorFromPalette(), but with a 16 bit index, brightness and blend, so
+/// slowly moving through a palette doesn't step from one 8 bit color to the next.
+/// @param pal the palette to retrieve the color from
+/// @param index the position in the palette to retrieve the color for (0-65535)
+/// @param brightness optional brightness value to scale the resulting color, in 65536ths
+/// @param blendType whether to take the palette entries directly (NOBLEND)
+/// or blend linearly between palette entries (LINEARBLEND)
+CRGB16 ColorFromPaletteRGB16( const CRGBPalette16& pal,
+                             uint16_t index,
+                             uint16_t brightness=65535,
+                             TBlendType blendType=LINEARBLEND);
+
+/// @copydoc ColorFromPaletteRGB16(const CRGBPalette16&, uint16_t, uint16_t, TBlendType)
+CRGB16 ColorFromPaletteRGB16( const CRGBPalette32& pal,
+                             uint16_t index,
+                             uint16_t brightness=65535,
+                             TBlendType blendType=LINEARBLEND);
+
+/// @copydoc ColorFromPaletteRGB16(const CRGBPalette16&, uint16_t, uint16_t, TBlendType)
+CRGB16 ColorFromPaletteRGB16( const CRGBPalette256& pal,
+                             uint16_t index,
+                             uint16_t brightness=65535,
+                             TBlendType blendType=LINEARBLEND);
+
 
 /// Fill a range of LEDs with a sequence of entries from a palette
 /// @tparam PALETTE the type of the palette used (auto-deduced)
@@ -2042,6 +2200,168 @@ void map_data_into_colors_through_palette(
 }
 
 
+/// Samples a palette through a cached table of all 256 of its colors, so that filling
+/// many leds from a palette costs a table lookup per led, instead of the blend and
+/// brightness scaling that ColorFromPalette() does on every call.
+///
+/// The table is built from the palette the first time it's used, and then only rebuilt
+/// when the palette's colors, the blend type, or the brightness change.  The sampler keeps
+/// a copy of the colors it built the table from to spot changes, so there's nothing to do
+/// when the palette is reassigned or cross-faded with nblendPaletteTowardPalette().
+/// The colors are exactly the ones ColorFromPalette() returns.
+///
+///     CRGBPalette16 currentPalette = RainbowColors_p;
+///     CPaletteSampler<CRGBPalette16> sampler(currentPalette);
+///     ...
+///     nblendPaletteTowardPalette(currentPalette, targetPalette);
+///     fill_palette(leds, NUM_LEDS, startIndex, 3, sampler, brightness);
+///
+/// @note The table and the copy of the palette take about 800 bytes of ram (for a
+/// CRGBPalette16), which is a lot on an AVR.  Use it for long strips or big matrices,
+/// where the lookups save the most.
+/// @tparam PALETTE the type of the palette, CRGBPalette16 or CRGBPalette32
+template<typename PALETTE>
+class CPaletteSampler {
+    const PALETTE & mPalette;   ///< the palette being sampled
+    PALETTE mBuiltFrom;         ///< the colors of the palette when the table was built
+    CRGB mTable[256];           ///< the color for every index, at mBrightness
+    TBlendType mBlendType;      ///< how the palette is blended
+    uint8_t mBrightness;        ///< the brightness the table was built at
+    bool mValid;                ///< whether the table has been built
+
+    // not copyable, the palette is referenced
+    CPaletteSampler(const CPaletteSampler &);
+    CPaletteSampler & operator=(const CPaletteSampler &);
+
+public:
+    /// Create a sampler for a palette.  The table isn't built until it's first used.
+    /// @param pal the palette to sample, which has to outlive the sampler
+    /// @param blendType how to blend between the palette's entries
+    CPaletteSampler(const PALETTE & pal, TBlendType blendType = LINEARBLEND)
+        : mPalette(pal), mBlendType(blendType), mBrightness(255), mValid(false) {}
+
+    /// Change how the palette is blended
+    /// @param blendType whether to take the palette entries directly (NOBLEND)
+    /// or blend linearly between palette entries (LINEARBLEND)
+    void setBlendType(TBlendType blendType) {
+        if( blendType != mBlendType) {
+            mBlendType = blendType;
+            mValid = false;
+        }
+    }
+
+    /// Get how the palette is blended
+    TBlendType getBlendType() const { return mBlendType; }
+
+    /// Force the table to be rebuilt the next time it's used
+    void invalidate() { mValid = false; }
+
+    /// Get the table of colors, rebuilding it first if the palette (or the blend type,
+    /// or the brightness) has changed since it was last built
+    /// @param brightness brightness value used to scale the colors
+    /// @returns the color for each of the 256 palette indices
+    const CRGB * getTable(uint8_t brightness = 255) {
+        if( !mValid || brightness != mBrightness || !(mBuiltFrom == mPalette)) {
+            mBuiltFrom = mPalette;
+            mBrightness = brightness;
+            for( uint16_t i = 0; i < 256; ++i) {
+                mTable[i] = ColorFromPalette( mBuiltFrom, (uint8_t)i, brightness, mBlendType);
+            }
+            mValid = true;
+        }
+        return mTable;
+    }
+
+    /// Get a color from the palette.  This checks the palette for changes on every call,
+    /// so for more than a few colors, use getTable() once and then index it.
+    /// @param index the position in the palette, 0-255
+    /// @param brightness brightness value used to scale the color
+    /// @returns the color, the same as ColorFromPalette() would give
+    CRGB sample(uint8_t index, uint8_t brightness = 255) { return getTable(brightness)[index]; }
+};
+
+/// Fill a range of LEDs with a sequence of entries from a palette, using the sampler's
+/// table of colors
+/// @see fill_palette(CRGB*, uint16_t, uint8_t, uint8_t, const PALETTE&, uint8_t, TBlendType)
+/// @param L pointer to the LED array to fill
+/// @param N number of LEDs to fill in the array
+/// @param startIndex the starting color index in the palette
+/// @param incIndex how much to increment the palette color index per LED
+/// @param sampler the sampler of the palette to pull colors from
+/// @param brightness brightness value used to scale the resulting color
+template <typename PALETTE>
+void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
+                  CPaletteSampler<PALETTE>& sampler, uint8_t brightness=255)
+{
+    const CRGB* table = sampler.getTable( brightness);
+    uint8_t colorIndex = startIndex;
+    for( uint16_t i = 0; i < N; ++i) {
+        L[i] = table[colorIndex];
+        colorIndex += incIndex;
+    }
+}
+
+/// Fill a range of LEDs with a sequence of entries from a palette, so that the entire
+/// palette smoothly covers the range of LEDs, using the sampler's table of colors
+/// @see fill_palette_circular(CRGB*, uint16_t, uint8_t, const PALETTE&, uint8_t, TBlendType, bool)
+/// @param L pointer to the LED array to fill
+/// @param N number of LEDs to fill in the array
+/// @param startIndex the starting color index in the palette
+/// @param sampler the sampler of the palette to pull colors from
+/// @param brightness brightness value used to scale the resulting color
+/// @param reversed whether to progress through the palette backwards
+template <typename PALETTE>
+void fill_palette_circular(CRGB* L, uint16_t N, uint8_t startIndex,
+                           CPaletteSampler<PALETTE>& sampler, uint8_t brightness=255,
+                           bool reversed=false)
+{
+    if (N == 0) return;  // avoiding div/0
+
+    const CRGB* table = sampler.getTable( brightness);
+    const uint16_t colorChange = 65535 / N;              // color change for each LED, * 256 for precision
+    uint16_t colorIndex = ((uint16_t) startIndex) << 8;  // offset for color index, with precision (*256)
+
+    for (uint16_t i = 0; i < N; ++i) {
+        L[i] = table[colorIndex >> 8];
+        if (reversed) colorIndex -= colorChange;
+        else colorIndex += colorChange;
+    }
+}
+
+/// Maps an array of palette color indexes into an array of LED colors, using the
+/// sampler's table of colors
+/// @see map_data_into_colors_through_palette(uint8_t*, uint16_t, CRGB*, const PALETTE&, uint8_t, uint8_t, TBlendType)
+/// @param dataArray the source array, containing color indexes for the palette
+/// @param dataCount the number of data elements in the array
+/// @param targetColorArray the LED array to store the resulting colors into. Must be
+/// at least as long as `dataCount`.
+/// @param sampler the sampler of the palette to pull colors from
+/// @param brightness optional brightness value used to scale the resulting color
+/// @param opacity optional opacity value for the new color
+template <typename PALETTE>
+void map_data_into_colors_through_palette(
+	uint8_t *dataArray, uint16_t dataCount,
+	CRGB* targetColorArray,
+	CPaletteSampler<PALETTE>& sampler,
+	uint8_t brightness=255,
+	uint8_t opacity=255)
+{
+	const CRGB* table = sampler.getTable( brightness);
+	if( opacity == 255 ) {
+		for( uint16_t i = 0; i < dataCount; ++i) {
+			targetColorArray[i] = table[dataArray[i]];
+		}
+		return;
+	}
+	for( uint16_t i = 0; i < dataCount; ++i) {
+		CRGB rgb = table[dataArray[i]];
+		targetColorArray[i].nscale8( 256 - opacity);
+		rgb.nscale8_video( opacity);
+		targetColorArray[i] += rgb;
+	}
+}
+
+
 /// Alter one palette by making it slightly more like a "target palette".
 /// Used for palette cross-fades.
 ///
@@ -0,0 +1,109 @@
+/// Disables pragma messages and warnings
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+#include <string.h>
+
+/// @file compositor.cpp
+/// Layer compositing, see compositor.h
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Number of leds composited at a time, small enough that a block of the output stays
+/// in the cache (or registers) while every layer is stacked onto it
+#if defined(__AVR__)
+#define COMPOSITE_BLOCK 16
+#else
+#define COMPOSITE_BLOCK 64
+#endif
+
+/// Fade a channel of a layer toward black by its opacity
+/// @param c the channel
+/// @param scale the opacity + 1
+/// @returns the faded channel
+LIB8STATIC_ALWAYS_INLINE uint8_t layer_fade( uint8_t c, uint16_t scale) { return ((uint16_t)c * scale) >> 8; }
+
+/// Combine a span of a layer with the leds below it.  This works on the channels as one flat
+/// run of bytes, since every mode treats the channels the same.
+/// @param dst the leds below the layer, which get the result
+/// @param src the layer
+/// @param count the number of leds
+/// @param mode how the layer is combined
+/// @param opacity the opacity of the layer, 1-255
+static void composite_span( CRGB *dst, const CRGB *src, uint16_t count, TBlendMode mode, uint8_t opacity)
+{
+    uint8_t *d = (uint8_t*)dst;
+    const uint8_t *s = (const uint8_t*)src;
+    uint16_t bytes = count * 3;
+    uint16_t scale = (uint16_t)opacity + 1;
+
+    switch(mode) {
+        case LAYER_BLEND_ALPHA:
+            if(opacity == 255) {
+                memmove8( d, s, bytes);
+            } else {
+                for( uint16_t i = 0; i < bytes; ++i) { d[i] = blend8( d[i], s[i], opacity); }
+            }
+            break;
+        case LAYER_BLEND_ADD:
+            for( uint16_t i = 0; i < bytes; ++i) { d[i] = qadd8( d[i], layer_fade( s[i], scale)); }
+            break;
+        case LAYER_BLEND_SCREEN:
+            // 255 - (255 - d) * (255 - s) / 255
+            for( uint16_t i = 0; i < bytes; ++i) {
+                uint8_t x = layer_fade( s[i], scale);
+                d[i] = 255 - (((uint16_t)(255 - d[i]) * (uint16_t)(256 - x)) >> 8);
+            }
+            break;
+        case LAYER_BLEND_MULTIPLY:
+            // the layer fades toward white, rather than black
+            for( uint16_t i = 0; i < bytes; ++i) {
+                uint8_t x = 255 - layer_fade( 255 - s[i], scale);
+                d[i] = ((uint16_t)d[i] * (uint16_t)(x + 1)) >> 8;
+            }
+            break;
+        case LAYER_BLEND_MAX:
+            for( uint16_t i = 0; i < bytes; ++i) {
+                uint8_t x = layer_fade( s[i], scale);
+                d[i] = (x > d[i]) ? x : d[i];
+            }
+            break;
+    }
+}
+
+int8_t CCompositor::addLayer(const CRGB *leds, TBlendMode mode, uint8_t opacity, uint16_t start, uint16_t count) {
+    if(mNumLayers == COMPOSITOR_MAX_LAYERS) { return -1; }
+
+    Layer & layer = mLayers[mNumLayers];
+    layer.mLeds = leds;
+    layer.mStart = start;
+    layer.mCount = count;
+    layer.mMode = mode;
+    layer.mOpacity = opacity;
+    return mNumLayers++;
+}
+
+void CCompositor::composite(CRGB *leds, uint16_t numLeds, bool overExisting) {
+    for(uint16_t first = 0; first < numLeds; first += COMPOSITE_BLOCK) {
+        uint16_t last = first + COMPOSITE_BLOCK;
+        if(last > numLeds || last < first) { last = numLeds; }
+
+        if(!overExisting) {
+            memset8( leds + first, 0, (last - first) * sizeof(CRGB));
+        }
+
+        for(uint8_t i = 0; i < mNumLayers; ++i) {
+            const Layer & layer = mLayers[i];
+            if(layer.mOpacity == 0 || layer.mLeds == NULL) { continue; }
+
+            // the part of this block that the layer covers
+            uint32_t layerEnd = layer.mCount ? (uint32_t)layer.mStart + layer.mCount : numLeds;
+            uint16_t lo = (layer.mStart > first) ? layer.mStart : first;
+            uint16_t hi = (layerEnd < last) ? (uint16_t)layerEnd : last;
+            if(lo >= hi) { continue; }
+
+            composite_span( leds + lo, layer.mLeds + (lo - layer.mStart), hi - lo, layer.mMode, layer.mOpacity);
+        }
+    }
+}
+
+FASTLED_NAMESPACE_END
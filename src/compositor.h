@@ -0,0 +1,136 @@
+#ifndef __INC_COMPOSITOR_H
+#define __INC_COMPOSITOR_H
+
+/// @file compositor.h
+/// Stacking led buffers ("layers") into one with blend modes, in a single pass
+
+#include "FastLED.h"
+
+FASTLED_NAMESPACE_BEGIN
+
+/// @defgroup Compositor Layer Compositing
+/// Stacking led buffers into one, with a blend mode and an opacity for each.
+/// @{
+
+/// The most layers a CCompositor can stack
+#ifndef COMPOSITOR_MAX_LAYERS
+#if defined(__AVR__)
+#define COMPOSITOR_MAX_LAYERS 4
+#else
+#define COMPOSITOR_MAX_LAYERS 8
+#endif
+#endif
+
+/// How a layer is combined with the layers below it.  The layer's opacity fades its
+/// color toward the one that would leave the layers below unchanged, so an opacity of
+/// 0 always hides the layer.
+typedef enum {
+    LAYER_BLEND_ALPHA=0,     ///< cover the layers below, the same as nblend() with the opacity
+    LAYER_BLEND_ADD=1,       ///< add to the layers below, saturating, the same as `+=`
+    LAYER_BLEND_SCREEN=2,    ///< brighten the layers below, without ever saturating
+    LAYER_BLEND_MULTIPLY=3,  ///< darken the layers below, with white leaving them unchanged
+    LAYER_BLEND_MAX=4        ///< the brighter of the layer and the layers below, per channel
+} TBlendMode;
+
+/// Stacks led buffers on top of each other into an output buffer.  Effects that draw a
+/// background and then nblend(), += or fade other buffers onto it make a full pass over
+/// the leds for every step.  The compositor does all of the layers a block of leds at a
+/// time instead, so the output is written once, and every layer is read once:
+///
+///     CRGB background[NUM_LEDS], waves[NUM_LEDS], sparkles[NUM_LEDS];
+///     CCompositor compositor;
+///     compositor.addLayer(background);
+///     compositor.addLayer(waves, LAYER_BLEND_SCREEN, 192);
+///     compositor.addLayer(sparkles, LAYER_BLEND_ADD);
+///     ...
+///     compositor.composite(leds, NUM_LEDS);
+///
+/// A layer can cover just a span of the output, so that a small buffer can be stacked
+/// somewhere on a long strip.  Spans of the output that no layer covers (and layers with
+/// an opacity of 0) are skipped entirely.
+/// @note The layers are referenced, not copied, so they have to outlive the compositor
+class CCompositor {
+    /// A buffer in the stack
+    struct Layer {
+        const CRGB *mLeds;    ///< the layer's leds, mLeds[0] is output led mStart
+        uint16_t mStart;      ///< the first output led that the layer covers
+        uint16_t mCount;      ///< the number of output leds that the layer covers
+        TBlendMode mMode;     ///< how the layer is combined with the layers below
+        uint8_t mOpacity;     ///< the opacity of the layer, 0-255
+    };
+
+    Layer mLayers[COMPOSITOR_MAX_LAYERS];  ///< the layers, bottom first
+    uint8_t mNumLayers;                     ///< the number of layers in use
+
+public:
+    /// Create a compositor with no layers
+    CCompositor() : mNumLayers(0) {}
+
+    /// Add a layer on top of the others
+    /// @param leds the layer's leds
+    /// @param mode how the layer is combined with the layers below
+    /// @param opacity the opacity of the layer
+    /// @param start the first output led that the layer covers
+    /// @param count the number of output leds that the layer covers (and the size of leds),
+    /// or 0 to cover the rest of the output
+    /// @returns the index of the layer, or -1 if there are already COMPOSITOR_MAX_LAYERS
+    int8_t addLayer(const CRGB *leds, TBlendMode mode = LAYER_BLEND_ALPHA, uint8_t opacity = 255, uint16_t start = 0, uint16_t count = 0);
+
+    /// Remove all of the layers
+    void clearLayers() { mNumLayers = 0; }
+
+    /// Get the number of layers
+    uint8_t getNumLayers() const { return mNumLayers; }
+
+    /// Set the opacity of a layer
+    /// @param layer the index of the layer
+    /// @param opacity the opacity, 0 to hide the layer
+    void setOpacity(uint8_t layer, uint8_t opacity) { if(layer < mNumLayers) { mLayers[layer].mOpacity = opacity; } }
+
+    /// Get the opacity of a layer
+    /// @param layer the index of the layer
+    uint8_t getOpacity(uint8_t layer) const { return (layer < mNumLayers) ? mLayers[layer].mOpacity : 0; }
+
+    /// Set how a layer is combined with the layers below it
+    /// @param layer the index of the layer
+    /// @param mode the blend mode
+    void setBlendMode(uint8_t layer, TBlendMode mode) { if(layer < mNumLayers) { mLayers[layer].mMode = mode; } }
+
+    /// Set the leds of a layer, e.g. to swap buffers
+    /// @param layer the index of the layer
+    /// @param leds the layer's leds
+    void setLeds(uint8_t layer, const CRGB *leds) { if(layer < mNumLayers) { mLayers[layer].mLeds = leds; } }
+
+    /// Move a layer to cover a different span of the output
+    /// @param layer the index of the layer
+    /// @param start the first output led that the layer covers
+    /// @param count the number of output leds that the layer covers, or 0 for the rest of the output
+    void setSpan(uint8_t layer, uint16_t start, uint16_t count = 0) { if(layer < mNumLayers) { mLayers[layer].mStart = start; mLayers[layer].mCount = count; } }
+
+    /// Stack the layers into an output buffer
+    /// @param leds the output buffer
+    /// @param numLeds the number of leds in the output buffer
+    /// @param overExisting whether to stack the layers on what's already in the buffer (skipping
+    /// the spans that no layer covers), rather than on black
+    void composite(CRGB *leds, uint16_t numLeds, bool overExisting = false);
+
+    /// Stack the layers straight into a controller's led buffer.  The output is the buffer in
+    /// memory order, all of its lanes for a block controller, and from the lowest address for
+    /// a reversed strip (one with a negative size), the same as compositing into the array.
+    /// @param controller the controller
+    /// @param overExisting whether to stack the layers on what's already in the buffer, rather than on black
+    /// @returns false if the controller has no buffer, or has 16 bit leds, which the layers can't be stacked into
+    bool composite(CLEDController &controller, bool overExisting = false) {
+        if(controller.leds16() || !controller.leds()) { return false; }
+        int n = controller.size();
+        CRGB *first = (n < 0) ? (controller.leds() + n + 1) : controller.leds();
+        composite(first, abs(n), overExisting);
+        return true;
+    }
+};
+
+/// @} Compositor
+
+FASTLED_NAMESPACE_END
+
+#endif
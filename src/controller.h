@@ -8,7 +8,9 @@
 #include "led_sysdefs.h"
 #include "pixeltypes.h"
 #include "color.h"
+#include "fastled_profile.h"
 #include <stddef.h>
+#include <stdlib.h>
 
 FASTLED_NAMESPACE_BEGIN
 
@@ -47,6 +49,28 @@ FASTLED_NAMESPACE_BEGIN
 /// The dither setting, either DISABLE_DITHER or BINARY_DITHER
 typedef uint8_t EDitherMode;
 
+/// Always send the leds on every show (the default)
+#define CHANGE_DETECT_NONE 0x00
+/// Skip sending the leds when neither the led data nor the brightness/correction has changed, detected with a hash of the data
+#define CHANGE_DETECT_HASH 0x01
+/// Only send the leds on show when they have been flagged with CLEDController::setDirty()
+#define CHANGE_DETECT_MANUAL 0x02
+/// The change detection setting, one of CHANGE_DETECT_NONE, CHANGE_DETECT_HASH, or CHANGE_DETECT_MANUAL
+typedef uint8_t EChangeDetectMode;
+
+#ifndef FASTLED_PIXEL_LUT
+/// Whether PixelController uses per-frame lookup tables for dithering and scaling (see fastled_config.h)
+#define FASTLED_PIXEL_LUT 0
+#endif
+
+#ifndef FASTLED_CRGB16
+/// Whether the drivers quantize CRGB16 leds as they load them, rather than in a pass of their own (see fastled_config.h)
+#define FASTLED_CRGB16 0
+#endif
+
+class CPowerModel;
+class CPowerRail;
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // LED Controller interface definition
@@ -56,17 +80,35 @@ typedef uint8_t EDitherMode;
 /// Base definition for an LED controller.  Pretty much the methods that every LED controller object will make available.
 /// If you want to pass LED controllers around to methods, make them references to this type, keeps your code saner. However,
 /// most people won't be seeing/using these objects directly at all.
-/// @note That the methods for eventual checking of background writing of data (I'm looking at you, Teensy 3.0 DMA controller!)
-/// are not yet implemented.
+/// @note Controllers that write their data out in the background can split a show into beginShowLeds() and endShow(),
+/// and use waitForShowComplete() as the fence for reusing their buffers.
 class CLEDController {
 protected:
     friend class CFastLED;
     CRGB *m_Data;              ///< pointer to the LED data used by this controller
+    CRGB16 *m_Data16;          ///< pointer to the 16 bit LED data used by this controller, if any @see setLeds(CRGB16*, int)
+    uint8_t *m_pData16Buffer;  ///< the error diffusion residuals for m_Data16, followed by the 8 bit output for controllers that need it
+    bool m_bData16Output;      ///< whether m_pData16Buffer has room for the 8 bit output, see quantize16()
     CLEDController *m_pNext;   ///< pointer to the next LED controller in the linked list
     CRGB m_ColorCorrection;    ///< CRGB object representing the color correction to apply to the strip on show()  @see setCorrection
     CRGB m_ColorTemperature;   ///< CRGB object representing the color temperature to apply to the strip on show() @see setTemperature
     EDitherMode m_DitherMode;  ///< the current dither mode of the controller
     int m_nLeds;               ///< the number of LEDs in the LED data array
+    EChangeDetectMode m_ChangeDetect;  ///< the current change detection mode of the controller @see setChangeDetection
+    bool m_bDirty;             ///< whether the leds need to be sent on the next show, regardless of change detection
+    uint16_t m_nRefreshMillis; ///< resend the leds at least this often, even if unchanged (0 for never)
+    uint32_t m_nLastShowMillis;  ///< millis() when the leds were last sent
+    uint32_t m_nLastHash;      ///< hash of the led data last sent, for CHANGE_DETECT_HASH
+    CRGB m_LastAdjustment;     ///< color adjustment the leds were last sent with
+    const CPowerModel *m_pPowerModel;  ///< power drawn by this controller's leds, NULL for DefaultPowerModel
+    CPowerRail *m_pPowerRail;  ///< the supply this controller is on, NULL for the global power limit
+    uint32_t m_ChannelSums[3]; ///< the red, green, and blue values summed over the leds, when m_bScanned
+    uint32_t m_nScanHash;      ///< hash of the led data taken along with m_ChannelSums, for CHANGE_DETECT_HASH
+    bool m_bScanned;           ///< whether m_ChannelSums and m_nScanHash are up to date with the led data
+#if FASTLED_PROFILE
+    CTimingStats m_EncodeStats;    ///< time spent in beginShowLeds()/beginShowColor(), see getEncodeStats()
+    CTimingStats m_TransmitStats;  ///< time spent waiting for the leds to be written out, see getTransmitStats()
+#endif
     static CLEDController *m_pHead;  ///< pointer to the first LED controller in the linked list
     static CLEDController *m_pTail;  ///< pointer to the last LED controller in the linked list
 
@@ -82,9 +124,55 @@ protected:
     /// @param scale the rgb scaling to apply to each led before writing it out
     virtual void show(const struct CRGB *data, int nLeds, CRGB scale) = 0;
 
+    /// Read through the led data once, summing each channel for the power limiter and hashing it
+    /// for change detection at the same time
+    void scanLeds();
+
+    /// Write the passed in 16 bit RGB data out to the LEDs managed by this controller, quantizing it to
+    /// 8 bits as it's read and carrying the rounding error over to the next frame
+    /// @param data the rgb data to write out to the strip
+    /// @param err the error residuals, 3 bytes per LED, lined up with data (so for a reversed strip,
+    /// the residuals of the last LED in memory)
+    /// @param nLeds the number of LEDs being written out
+    /// @param scale the rgb scaling to apply to each led before writing it out
+    virtual void show16(const struct CRGB16 *data, uint8_t *err, int nLeds, CRGB scale) = 0;
+
+    /// First phase of a two phase show16(), see beginShow(const struct CRGB*, int, CRGB)
+    /// @copydetails show16()
+    virtual void beginShow16(const struct CRGB16 *data, uint8_t *err, int nLeds, CRGB scale) { show16(data, err, nLeds, scale); }
+
+    /// Show (or begin showing) m_Data16
+    /// @param brightness the brightness of the LEDs
+    /// @param begin whether to only begin the show, see beginShowLeds()
+    void showLeds16(uint8_t brightness, bool begin);
+
+    /// Quantize 16 bit RGB data into an 8 bit buffer, for controllers that can't read it as they go
+    /// (see CPixelLEDController::showsPixels16()), or for every controller if FASTLED_CRGB16 isn't set.
+    /// This takes an extra pass over the leds.
+    /// @copydetails show16()
+    /// @returns the 8 bit data lined up with data, or NULL if the buffer couldn't be allocated
+    const CRGB *quantize16(const struct CRGB16 *data, uint8_t *err, int nLeds, CRGB scale);
+
+    /// First phase of a two phase show: encode the passed in RGB data and start writing it out,
+    /// without waiting for the write to finish.  endShow() completes the show.  Controllers that can't
+    /// write in the background just do the whole show here.
+    /// @param data the rgb data to write out to the strip
+    /// @param nLeds the number of LEDs being written out
+    /// @param scale the rgb scaling to apply to each led before writing it out
+    /// @see show(const struct CRGB*, int, CRGB)
+    virtual void beginShow(const struct CRGB *data, int nLeds, CRGB scale) { show(data, nLeds, scale); }
+
+    /// First phase of a two phase showColor, see beginShow(const struct CRGB*, int, CRGB)
+    /// @param data the CRGB color to set the LEDs to
+    /// @param nLeds the number of LEDs to set to this color
+    /// @param scale the rgb scaling value for outputting color
+    virtual void beginShowColor(const struct CRGB & data, int nLeds, CRGB scale) { showColor(data, nLeds, scale); }
+
 public:
     /// Create an led controller object, add it to the chain of controllers
-    CLEDController() : m_Data(NULL), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0) {
+    CLEDController() : m_Data(NULL), m_Data16(NULL), m_pData16Buffer(NULL), m_bData16Output(false), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0),
+                       m_ChangeDetect(CHANGE_DETECT_NONE), m_bDirty(true), m_nRefreshMillis(0), m_nLastShowMillis(0), m_nLastHash(0),
+                       m_pPowerModel(NULL), m_pPowerRail(NULL), m_nScanHash(0), m_bScanned(false) {
         m_pNext = NULL;
         if(m_pHead==NULL) { m_pHead = this; }
         if(m_pTail != NULL) { m_pTail->m_pNext = this; }
@@ -124,7 +212,11 @@ public:
     /// @param brightness the brightness of the LEDs
     /// @see show(const struct CRGB*, int, uint8_t)
     void showLeds(uint8_t brightness=255) {
-        show(m_Data, m_nLeds, getAdjustment(brightness));
+        if(m_Data16) {
+            showLeds16(brightness, false);
+        } else {
+            show(m_Data, m_nLeds, getAdjustment(brightness));
+        }
     }
 
     /// @copybrief showColor(const struct CRGB&, int, CRGB)
@@ -136,6 +228,32 @@ public:
         showColor(data, m_nLeds, getAdjustment(brightness));
     }
 
+    /// Encode the data for the LEDs managed by this controller, and start writing it out.  This lets
+    /// CFastLED::show() get every controller going before waiting on any of them, so the time taken is
+    /// that of the longest strip rather than the sum of all of them.  Must be followed by endShow().
+    /// @param brightness the brightness of the LEDs
+    /// @see showLeds()
+    void beginShowLeds(uint8_t brightness=255) {
+        if(m_Data16) {
+            showLeds16(brightness, true);
+        } else {
+            beginShow(m_Data, m_nLeds, getAdjustment(brightness));
+        }
+    }
+
+    /// Start setting all the LEDs managed by this controller to a given color.  Must be followed by endShow().
+    /// @param data the CRGB color to set the LEDs to
+    /// @param brightness the brightness of the LEDs
+    /// @see showColor(const struct CRGB&, uint8_t)
+    void beginShowColor(const struct CRGB & data, uint8_t brightness=255) {
+        beginShowColor(data, m_nLeds, getAdjustment(brightness));
+    }
+
+    /// Second phase of a two phase show: wait for whatever a plain show() would have waited for
+    /// before returning.  For most controllers this is the same as waitForShowComplete(); controllers
+    /// whose show() never blocked (e.g. RP2040 DMA) don't wait here either.
+    virtual void endShow() { }
+
     /// Get the first LED controller in the linked list of controllers
     /// @returns CLEDController::m_pHead
     static CLEDController *head() { return m_pHead; }
@@ -148,18 +266,129 @@ public:
     /// @param data pointer to the LED data
     /// @param nLeds the number of LEDs in the LED data
     CLEDController & setLeds(CRGB *data, int nLeds) {
+        free(m_pData16Buffer);
+        m_pData16Buffer = NULL;
+        m_bData16Output = false;
         m_Data = data;
+        m_Data16 = NULL;
         m_nLeds = nLeds;
+        m_bScanned = false;
         return *this;
     }
 
+    /// Set a 16 bit per channel array of LEDs to be used by this controller.  On each show the
+    /// 16 bit data is scaled by the brightness and color adjustment and quantized to the strip's
+    /// 8 bits, carrying each channel's rounding error over to the next frame (temporal error
+    /// diffusion).  That takes the place of the controller's binary dithering.
+    /// @note This allocates an error buffer, 3 bytes per LED, and the leds are quantized into an
+    /// 8 bit buffer before they're shown, which takes 3 more bytes per LED.  With FASTLED_CRGB16
+    /// set, the drivers quantize the leds as they read them (see PixelController::quantize()),
+    /// except for those that read the led bytes directly (AVR and some ARM clockless drivers,
+    /// SmartMatrix).  leds() returns NULL.
+    /// @param data pointer to the LED data
+    /// @param nLeds the number of LEDs in the LED data
+    /// @returns a reference to the controller
+    CLEDController & setLeds(CRGB16 *data, int nLeds);
+
+    /// Pointer to the CRGB16 array for this controller
+    /// @returns CLEDController::m_Data16, or NULL if the controller has 8 bit data
+    CRGB16* leds16() { return m_Data16; }
+
     /// Zero out the LED data managed by this controller
     void clearLedData() {
+        if(m_Data16) {
+            // a reversed strip's data pointer is at its last led in memory
+            int n = abs(size());
+            memset8((void*)(m_Data16 - ((m_nLeds < 0) ? (n - 1) : 0)), 0, sizeof(struct CRGB16) * n);
+        }
         if(m_Data) {
             memset8((void*)m_Data, 0, sizeof(struct CRGB) * m_nLeds);
         }
+        m_bDirty = true;
+        m_bScanned = false;
+    }
+
+    /// Set how FastLED.show() decides whether this controller's leds need to be sent again.  Mostly
+    /// static installations can skip re-encoding and re-sending strips that haven't changed, leaving
+    /// the bus time and CPU for the ones that are animating.
+    /// @note Skipped frames don't advance temporal dithering, so a static strip holds one dither step.
+    /// Controllers with 16 bit leds are still sent while the error diffusion would change their output, so
+    /// that the error diffusion of a static frame carries on.
+    /// @note Controllers that send all of their strips together (e.g. the ESP32 RMT and I2S drivers)
+    /// can't skip one of them, and always send (see canSkipShow())
+    /// @param mode CHANGE_DETECT_NONE to always send, CHANGE_DETECT_HASH to send when a hash of the
+    /// led data or the brightness/correction has changed, or CHANGE_DETECT_MANUAL to send only after setDirty()
+    /// @param refreshMillis resend at least this often even when nothing changed, to recover from
+    /// glitches on the line (0 to never resend)
+    /// @returns a reference to the controller
+    CLEDController & setChangeDetection(EChangeDetectMode mode, uint16_t refreshMillis = 1000) {
+        m_ChangeDetect = mode;
+        m_nRefreshMillis = refreshMillis;
+        m_bDirty = true;
+        m_bScanned = false;
+        return *this;
+    }
+
+    /// Get the change detection option currently set for this controller
+    /// @returns the current change detection mode (CLEDController::m_ChangeDetect)
+    EChangeDetectMode getChangeDetection() { return m_ChangeDetect; }
+
+    /// Flag the leds as changed, so that the next FastLED.show() sends them
+    /// @returns a reference to the controller
+    CLEDController & setDirty() { m_bDirty = true; m_bScanned = false; return *this; }
+
+    /// Does FastLED.show() need to send the leds, given the change detection mode?  When it returns true,
+    /// the current data and brightness are remembered as sent.
+    /// @param brightness the brightness the leds would be shown at
+    /// @returns true if the leds need to be sent
+    bool needsShow(uint8_t brightness);
+
+    /// Set the power drawn by this controller's leds, for power limiting.  Useful when mixing chipsets.
+    /// @param model the power model, which must outlive the controller
+    /// @returns a reference to the controller
+    CLEDController & setPowerModel(const CPowerModel & model) { m_pPowerModel = &model; return *this; }
+
+    /// Get the power model for this controller
+    /// @returns the power model, or NULL if the controller uses DefaultPowerModel
+    const CPowerModel *getPowerModel() const { return m_pPowerModel; }
+
+    /// Put this controller on a supply rail with its own power budget, instead of the global
+    /// power limit.  Controllers on the same rail are limited together.
+    /// @param rail the rail, which must outlive the controller
+    /// @returns a reference to the controller
+    CLEDController & setPowerRail(CPowerRail & rail) { m_pPowerRail = &rail; return *this; }
+
+    /// Get the supply rail this controller is on
+    /// @returns the rail, or NULL if the controller is covered by the global power limit
+    CPowerRail *getPowerRail() const { return m_pPowerRail; }
+
+    /// Get the red, green, and blue values summed over all of the leds, as used by the power limiter
+    /// (16 bit leds are summed at their top 8 bits).  The leds are only read when they may have
+    /// changed: once per FastLED.show(), sharing the read with CHANGE_DETECT_HASH, and only after
+    /// setDirty() for CHANGE_DETECT_MANUAL.
+    /// @returns an array of the three sums
+    const uint32_t *getChannelSums() {
+        if(!m_bScanned) { scanLeds(); }
+        return m_ChannelSums;
     }
 
+#if FASTLED_PROFILE
+    /// Get how long show() spends encoding this controller's leds and starting to write them out.
+    /// Controllers that can't write out in the background write the whole frame here, so for them
+    /// this includes the transmit time.
+    /// @returns the timing statistics
+    const CTimingStats & getEncodeStats() const { return m_EncodeStats; }
+
+    /// Get how long show() spends waiting for this controller's leds to finish writing out,
+    /// in endShow() and waitForShowComplete()
+    /// @returns the timing statistics
+    const CTimingStats & getTransmitStats() const { return m_TransmitStats; }
+#endif
+
+    /// Can this controller skip a show without affecting other controllers?
+    /// @returns true, unless the controller sends all of its strips at once
+    virtual bool canSkipShow() const { return true; }
+
     /// How many LEDs does this controller manage?
     /// @returns CLEDController::m_nLeds
     virtual int size() { return m_nLeds; }
@@ -247,6 +476,12 @@ public:
     /// Gets the maximum possible refresh rate of the strip
     /// @returns the maximum refresh rate, in frames per second (FPS)
     virtual uint16_t getMaxRefreshRate() const { return 0; }
+
+    /// Block until the data handed to this controller by the last show has been completely
+    /// written out.  Controllers that transmit in the background (DMA, RMT, PWM, etc...) encode
+    /// the frame into their own buffer and return right away, so this is the fence to use before
+    /// that buffer gets reused.  Controllers that block in show() have nothing to wait for.
+    virtual void waitForShowComplete() { }
 };
 
 /// Pixel controller class.  This is the class that we use to centralize pixel access in a block of data, including
@@ -265,8 +500,14 @@ struct PixelController {
         CRGB mScale;             ///< the per-channel scale values, provided by a color correction function such as CLEDController::computeAdjustment()
         int8_t mAdvance;         ///< how many bytes to advance the pointer by each time. For CRGB this is 3.
         int mOffsets[LANES];     ///< the number of bytes to offset each lane from the starting pointer @see initOffsets()
+        uint8_t *mErr;           ///< error diffusion residuals for 16 bit LED data, or NULL for 8 bit data @see quantize()
+        const uint8_t *mErrData; ///< the LED data that mErr[0] is the residual for; a byte of data d bytes on has mErr[d / 2]
+#if FASTLED_PIXEL_LUT
+        uint8_t mLut[3][512];    ///< per channel dithered and scaled values, for both dither phases @see init_lut()
+        uint16_t mLutPhase[3];   ///< offset into mLut for the current dither phase of each channel, 0 or 256
+#endif
 
-        /// Copy constructor
+        /// Copy constructor.  With FASTLED_PIXEL_LUT this copies the 1.5k of tables as well.
         /// @param other the object to copy 
         PixelController(const PixelController & other) {
             d[0] = other.d[0];
@@ -276,10 +517,16 @@ struct PixelController {
             e[1] = other.e[1];
             e[2] = other.e[2];
             mData = other.mData;
+            mErr = other.mErr;
+            mErrData = other.mErrData;
             mScale = other.mScale;
             mAdvance = other.mAdvance;
             mLenRemaining = mLen = other.mLen;
             for(int i = 0; i < LANES; ++i) { mOffsets[i] = other.mOffsets[i]; }
+#if FASTLED_PIXEL_LUT
+            memcpy8(mLut, other.mLut, sizeof(mLut));
+            for(int i = 0; i < 3; ++i) { mLutPhase[i] = other.mLutPhase[i]; }
+#endif
         }
 
         /// Initialize the PixelController::mOffsets array based on the length of the strip
@@ -299,7 +546,7 @@ struct PixelController {
         /// @param dither dither setting for the LEDs
         /// @param advance whether the pointer (d) should advance per LED
         /// @param skip if the pointer is advancing, how many bytes to skip in addition to 3
-        PixelController(const uint8_t *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, bool advance=true, uint8_t skip=0) : mData(d), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const uint8_t *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, bool advance=true, uint8_t skip=0) : mData(d), mLen(len), mLenRemaining(len), mScale(s), mErr(NULL), mErrData(NULL) {
             enable_dithering(dither);
             mData += skip;
             mAdvance = (advance) ? 3+skip : 0;
@@ -311,7 +558,7 @@ struct PixelController {
         /// @param len length of the LED data
         /// @param s LED scale values, as CRGB struct
         /// @param dither dither setting for the LEDs
-        PixelController(const CRGB *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)d), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const CRGB *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)d), mLen(len), mLenRemaining(len), mScale(s), mErr(NULL), mErrData(NULL) {
             enable_dithering(dither);
             mAdvance = 3;
             initOffsets(len);
@@ -322,12 +569,24 @@ struct PixelController {
         /// @param len length of the LED data
         /// @param s LED scale values, as CRGB struct
         /// @param dither dither setting for the LEDs
-        PixelController(const CRGB &d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)&d), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const CRGB &d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)&d), mLen(len), mLenRemaining(len), mScale(s), mErr(NULL), mErrData(NULL) {
             enable_dithering(dither);
             mAdvance = 0;
             initOffsets(len);
         }
 
+        /// Constructor for 16 bit LED data, which the load functions quantize to 8 bits as they read
+        /// it (see quantize()).  Dithering is left off, since the error diffusion takes its place.
+        /// @param d pointer to LED data
+        /// @param err the error diffusion residuals, 3 bytes per LED, lined up with d
+        /// @param len length of the LED data
+        /// @param s LED scale values, as CRGB struct
+        PixelController(const CRGB16 *d, uint8_t *err, int len, CRGB & s) : mData((const uint8_t*)d), mLen(len), mLenRemaining(len), mScale(s), mErr(err), mErrData((const uint8_t*)d) {
+            enable_dithering(DISABLE_DITHER);
+            mAdvance = sizeof(CRGB16);
+            initOffsets(len);
+        }
+
 
 #if !defined(NO_DITHERING) || (NO_DITHERING != 1)
 
@@ -422,6 +681,28 @@ struct PixelController {
 #endif
         }
 
+        /// Build the lookup tables used by loadAndScale().  Dithering flips each channel between two
+        /// values (d and e-d) from one pixel to the next, and the scale doesn't change during a frame,
+        /// so every dithered and scaled output byte comes from one of two 256 entry tables per channel.
+        /// The tables give the same results as dither() followed by scale().
+        void init_lut() {
+#if FASTLED_PIXEL_LUT
+            for(int i = 0; i < 3; ++i) {
+                uint8_t s = mScale.raw[i];
+                uint8_t d0 = d[i];
+                uint8_t d1 = e[i] - d[i];
+                uint8_t *lut = mLut[i];
+                // dithering leaves black alone
+                lut[0] = lut[256] = 0;
+                for(int b = 1; b < 256; ++b) {
+                    lut[b] = scale8(qadd8(b, d0), s);
+                    lut[256 + b] = scale8(qadd8(b, d1), s);
+                }
+                mLutPhase[i] = 0;
+            }
+#endif
+        }
+
         /// Do we have n pixels left to process?
         /// @param n the number to check against
         /// @returns 'true' if there are more than n pixels left to process
@@ -432,13 +713,14 @@ struct PixelController {
         /// Toggle dithering enable
         /// If dithering is set to enabled, this will re-init the dithering values
         /// (init_binary_dithering()). Otherwise it will clear the stored dithering
-        /// data.
+        /// data.  Either way, the lookup tables are rebuilt (see init_lut()).
         /// @param dither the dither setting
         void enable_dithering(EDitherMode dither) {
             switch(dither) {
                 case BINARY_DITHER: init_binary_dithering(); break;
                 default: d[0]=d[1]=d[2]=e[0]=e[1]=e[2]=0; break;
             }
+            init_lut();
         }
 
         /// Get the length of the LED strip
@@ -464,11 +746,19 @@ struct PixelController {
                 d[0] = e[0] - d[0];
                 d[1] = e[1] - d[1];
                 d[2] = e[2] - d[2];
+#if FASTLED_PIXEL_LUT
+                mLutPhase[0] ^= 256;
+                mLutPhase[1] ^= 256;
+                mLutPhase[2] ^= 256;
+#endif
         }
 
         /// Some chipsets pre-cycle the first byte, which means we want to cycle byte 0's dithering separately
         __attribute__((always_inline)) inline void preStepFirstByteDithering() {
             d[RO(0)] = e[RO(0)] - d[RO(0)];
+#if FASTLED_PIXEL_LUT
+            mLutPhase[RO(0)] ^= 256;
+#endif
         }
 
         /// @name Template'd static functions for output
@@ -509,38 +799,94 @@ struct PixelController {
         /// @param scale the scale value
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t scale(PixelController & , uint8_t b, uint8_t scale) { return scale8(b, scale); }
 
+        /// Load a channel of 16 bit LED data, scale it, and quantize it to 8 bits, adding the rounding
+        /// error left from the last frame and keeping what's left for the next one (temporal error
+        /// diffusion).  Every load of a byte moves the diffusion on, so each byte should be loaded once a show.
+        /// The loadAndScale() functions only call this for 16 bit data if FASTLED_CRGB16 is set, since
+        /// otherwise they'd check for it on every byte of every driver's output.
+        /// @tparam SLOT The data slot in the output stream. This is used to select which byte of the output stream is being processed.
+        /// @param pc reference to the pixel controller
+        /// @param offset the byte offset of the LED from the data pointer, e.g. for a lane
+        /// @param scale the scale value
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t quantize(PixelController & pc, int offset, uint8_t scale) {
+            // clockless drivers load the first byte of the next pixel while sending the last one,
+            // which mustn't touch the residuals past the end
+            if(!pc.has(1)) { return 0; }
+            const uint8_t *p = pc.mData + offset + (RO(SLOT) * sizeof(uint16_t));
+            uint8_t *err = pc.mErr + ((p - pc.mErrData) / 2);
+            uint16_t v = scale16by8(*(const uint16_t*)p, scale);
+            uint16_t t = v + *err;
+            if(t < v) {
+                // carrying the error would overflow, so it's full on and there's nothing left over
+                *err = 0;
+                return 0xFF;
+            }
+            *err = t & 0xFF;
+            return t >> 8;
+        }
+
         /// @name Composite shortcut functions for loading, dithering, and scaling
         /// These composite functions will load color data, dither it, and scale it
         /// all at once so that it's ready for the output controller to send to the
-        /// LEDs.
+        /// LEDs.  16 bit LED data is quantized instead of dithered (see quantize()), if FASTLED_CRGB16 is set.
         /// @{
 
 
         /// Loads, dithers, and scales a single byte for a given output slot, using class dither and scale values
         /// @tparam SLOT The data slot in the output stream. This is used to select which byte of the output stream is being processed.
         /// @param pc reference to the pixel controller
-        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc) { return scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc))); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc) {
+#if FASTLED_CRGB16
+            if(pc.mErr) { return quantize<SLOT>(pc, 0, pc.mScale.raw[RO(SLOT)]); }
+#endif
+#if FASTLED_PIXEL_LUT
+            return pc.mLut[RO(SLOT)][pc.mLutPhase[RO(SLOT)] + pc.loadByte<SLOT>(pc)];
+#else
+            return scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc)));
+#endif
+        }
 
         /// Loads, dithers, and scales a single byte for a given output slot and lane, using class dither and scale values
         /// @tparam SLOT The data slot in the output stream. This is used to select which byte of the output stream is being processed.
         /// @param pc reference to the pixel controller
         /// @param lane the parallel output lane to read the byte for
-        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane) { return scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane))); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane) {
+#if FASTLED_CRGB16
+            if(pc.mErr) { return quantize<SLOT>(pc, pc.mOffsets[lane], pc.mScale.raw[RO(SLOT)]); }
+#endif
+#if FASTLED_PIXEL_LUT
+            return pc.mLut[RO(SLOT)][pc.mLutPhase[RO(SLOT)] + pc.loadByte<SLOT>(pc, lane)];
+#else
+            return scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane)));
+#endif
+        }
 
-        /// Loads, dithers, and scales a single byte for a given output slot and lane
+        /// Loads, dithers, and scales a single byte for a given output slot and lane.  The dithering
+        /// and scale are the caller's, so this doesn't use the FASTLED_PIXEL_LUT tables.
         /// @tparam SLOT The data slot in the output stream. This is used to select which byte of the output stream is being processed.
         /// @param pc reference to the pixel controller
         /// @param lane the parallel output lane to read the byte for
         /// @param d the dither data for the byte
         /// @param scale the scale data for the byte
-        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t d, uint8_t scale) { return scale8(pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane), d), scale); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t d, uint8_t scale) {
+#if FASTLED_CRGB16
+            if(pc.mErr) { return quantize<SLOT>(pc, pc.mOffsets[lane], scale); }
+#endif
+            return scale8(pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane), d), scale);
+        }
 
-        /// Loads and scales a single byte for a given output slot and lane
+        /// Loads and scales a single byte for a given output slot and lane, without dithering.  The
+        /// scale is the caller's, so this doesn't use the FASTLED_PIXEL_LUT tables.
         /// @tparam SLOT The data slot in the output stream. This is used to select which byte of the output stream is being processed.
         /// @param pc reference to the pixel controller
         /// @param lane the parallel output lane to read the byte for
         /// @param scale the scale data for the byte
-        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t scale) { return scale8(pc.loadByte<SLOT>(pc, lane), scale); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t scale) {
+#if FASTLED_CRGB16
+            if(pc.mErr) { return quantize<SLOT>(pc, pc.mOffsets[lane], scale); }
+#endif
+            return scale8(pc.loadByte<SLOT>(pc, lane), scale);
+        }
 
 
         /// A version of loadAndScale() that advances the output data pointer
@@ -619,6 +965,11 @@ protected:
     /// @param pixels the PixelController object for the LED data
     virtual void showPixels(PixelController<RGB_ORDER,LANES,MASK> & pixels) = 0;
 
+    /// Encode the LED data and start sending it to the strip, without waiting for it to be sent.  Controllers
+    /// that can write out in the background override this, and then have showPixels() call it followed by endShow().
+    /// @param pixels the PixelController object for the LED data
+    virtual void beginShowPixels(PixelController<RGB_ORDER,LANES,MASK> & pixels) { showPixels(pixels); }
+
     /// Set all the LEDs on the controller to a given color
     /// @param data the CRGB color to set the LEDs to
     /// @param nLeds the number of LEDs to set to this color
@@ -641,6 +992,80 @@ protected:
         showPixels(pixels);
     }
 
+    /// @copydoc CLEDController::beginShowColor(const struct CRGB&, int, CRGB)
+    virtual void beginShowColor(const struct CRGB & data, int nLeds, CRGB scale) {
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, getDither());
+        beginShowPixels(pixels);
+    }
+
+    /// @copydoc CLEDController::beginShow(const struct CRGB*, int, CRGB)
+    virtual void beginShow(const struct CRGB *data, int nLeds, CRGB scale) {
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds < 0 ? -nLeds : nLeds, scale, getDither());
+        if(nLeds < 0) {
+            // nLeds < 0 implies that we want to show them in reverse
+            pixels.mAdvance = -pixels.mAdvance;
+        }
+        beginShowPixels(pixels);
+    }
+
+    /// Whether showPixels() reads the leds only through the PixelController load functions, so that
+    /// it can be handed 16 bit leds to quantize as it goes.  Controllers that read PixelController::mData
+    /// directly return false, and are handed the leds already quantized into an 8 bit buffer, as every
+    /// controller is unless FASTLED_CRGB16 is set.
+    /// @returns true if showPixels() can take 16 bit leds
+    virtual bool showsPixels16() { return true; }
+
+    /// @copydoc CLEDController::show16()
+    virtual void show16(const struct CRGB16 *data, uint8_t *err, int nLeds, CRGB scale) {
+#if FASTLED_CRGB16
+        if(showsPixels16()) {
+            PixelController<RGB_ORDER, LANES, MASK> pixels(data, err, nLeds < 0 ? -nLeds : nLeds, scale);
+            if(nLeds < 0) {
+                // nLeds < 0 implies that we want to show them in reverse
+                pixels.mAdvance = -pixels.mAdvance;
+            }
+            showPixels(pixels);
+            return;
+        }
+#endif
+        const CRGB *out = quantize16(data, err, nLeds, scale);
+        if(out) { showQuantized(out, nLeds, false); }
+    }
+
+    /// @copydoc CLEDController::beginShow16()
+    virtual void beginShow16(const struct CRGB16 *data, uint8_t *err, int nLeds, CRGB scale) {
+#if FASTLED_CRGB16
+        if(showsPixels16()) {
+            PixelController<RGB_ORDER, LANES, MASK> pixels(data, err, nLeds < 0 ? -nLeds : nLeds, scale);
+            if(nLeds < 0) {
+                // nLeds < 0 implies that we want to show them in reverse
+                pixels.mAdvance = -pixels.mAdvance;
+            }
+            beginShowPixels(pixels);
+            return;
+        }
+#endif
+        const CRGB *out = quantize16(data, err, nLeds, scale);
+        if(out) { showQuantized(out, nLeds, true); }
+    }
+
+    /// Show (or begin showing) the output of quantize16(), which is already scaled, and
+    /// dithered by the error diffusion
+    /// @param data the quantized leds
+    /// @param nLeds the number of LEDs being written out
+    /// @param begin whether to only begin the show
+    void showQuantized(const CRGB *data, int nLeds, bool begin) {
+        CRGB unscaled(255, 255, 255);
+        EDitherMode d = m_DitherMode;
+        m_DitherMode = DISABLE_DITHER;
+        if(begin) {
+            beginShow(data, nLeds, unscaled);
+        } else {
+            show(data, nLeds, unscaled);
+        }
+        m_DitherMode = d;
+    }
+
 public:
     CPixelLEDController() : CLEDController() {}
 
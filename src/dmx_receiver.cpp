@@ -0,0 +1,176 @@
+/// Disables pragma messages and warnings
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+#include <string.h>
+
+/// @file dmx_receiver.cpp
+/// Art-Net and sACN (E1.31) input, see dmx_receiver.h
+
+FASTLED_NAMESPACE_BEGIN
+
+/// @name Art-Net packet layout
+/// @{
+#define ARTNET_OP_DMX 0x5000        ///< ArtDmx opcode, a universe of DMX data
+#define ARTNET_OP_SYNC 0x5200       ///< ArtSync opcode, show the data received so far
+#define ARTNET_HEADER_SIZE 18       ///< size of an ArtDmx packet before the data
+#define ARTNET_SYNC_TIMEOUT 4000    ///< ms without an ArtSync before going back to showing complete frames
+/// @}
+
+/// @name sACN (E1.31) packet layout
+/// @{
+#define E131_VECTOR_ROOT_DATA 0x00000004      ///< root layer vector of a data packet
+#define E131_VECTOR_ROOT_EXTENDED 0x00000008  ///< root layer vector of a sync (or discovery) packet
+#define E131_VECTOR_FRAMING_DATA 0x00000002   ///< framing layer vector of a data packet
+#define E131_VECTOR_FRAMING_SYNC 0x00000001   ///< framing layer vector of a sync packet
+#define E131_DATA_HEADER_SIZE 126             ///< size of a data packet before the DMX data (after the start code)
+#define E131_SYNC_SIZE 49                     ///< size of a sync packet
+#define E131_OPTION_PREVIEW 0x80              ///< options bit, data is for visualizers only
+#define E131_OPTION_TERMINATED 0x40           ///< options bit, the source is going away
+/// @}
+
+/// Art-Net packet id, including its terminating 0
+static const char ArtNetId[8] = { 'A', 'r', 't', '-', 'N', 'e', 't', 0 };
+/// ACN packet identifier at the start of every sACN packet
+static const char AcnId[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+
+/// Read a big endian 16 bit value
+static inline uint16_t read_be16(const uint8_t *p) { return ((uint16_t)p[0] << 8) | p[1]; }
+/// Read a big endian 32 bit value
+static inline uint32_t read_be32(const uint8_t *p) { return ((uint32_t)read_be16(p) << 16) | read_be16(p + 2); }
+
+int8_t CDMXReceiver::addUniverse(uint16_t universe, CRGB *leds, uint16_t count, uint16_t channel) {
+    if(mNumMappings == DMX_RECEIVER_MAX_MAPPINGS) { return -1; }
+
+    Mapping & mapping = mMappings[mNumMappings];
+    mapping.mLeds = leds;
+    mapping.mController = NULL;
+    mapping.mUniverse = universe;
+    mapping.mChannel = channel;
+    mapping.mCount = (count > DMX_LEDS_PER_UNIVERSE) ? DMX_LEDS_PER_UNIVERSE : count;
+    mSequenced &= ~((uint32_t)1 << mNumMappings);
+    return mNumMappings++;
+}
+
+int16_t CDMXReceiver::addUniverses(uint16_t firstUniverse, CRGB *leds, uint16_t count) {
+    uint16_t universes = (count + DMX_LEDS_PER_UNIVERSE - 1) / DMX_LEDS_PER_UNIVERSE;
+    if(mNumMappings + universes > DMX_RECEIVER_MAX_MAPPINGS) { return -1; }
+
+    for(uint16_t i = 0; i < universes; ++i) {
+        uint16_t n = (count > DMX_LEDS_PER_UNIVERSE) ? DMX_LEDS_PER_UNIVERSE : count;
+        addUniverse(firstUniverse + i, leds, n);
+        leds += n;
+        count -= n;
+    }
+    return universes;
+}
+
+int16_t CDMXReceiver::addUniverses(uint16_t firstUniverse, CLEDController & controller) {
+    // 16 bit leds aren't in leds(), and a reversed strip's leds() is its last led in memory
+    if(controller.leds16() || !controller.leds()) { return -1; }
+    int n = controller.size();
+    CRGB *leds = (n < 0) ? (controller.leds() + n + 1) : controller.leds();
+
+    uint8_t first = mNumMappings;
+    int16_t universes = addUniverses(firstUniverse, leds, abs(n));
+    for(uint8_t i = first; i < mNumMappings; ++i) {
+        mMappings[i].mController = &controller;
+    }
+    return universes;
+}
+
+bool CDMXReceiver::receiveData(uint16_t universe, uint8_t sequence, bool useSequence, const uint8_t *data, uint16_t slots, bool sync) {
+    bool used = false;
+    for(uint8_t i = 0; i < mNumMappings; ++i) {
+        Mapping & mapping = mMappings[i];
+        if(mapping.mUniverse != universe) { continue; }
+
+        // drop packets up to 20 behind the last one, as E1.31 specifies (and Art-Net receivers do)
+        uint32_t bit = (uint32_t)1 << i;
+        if(useSequence && (mSequenced & bit)) {
+            int8_t ahead = (int8_t)(sequence - mSequence[i]);
+            if(ahead <= 0 && ahead > -20) { continue; }
+        }
+        mSequence[i] = sequence;
+        mSequenced |= bit;
+
+        if(mapping.mChannel < slots) {
+            uint16_t bytes = mapping.mCount * 3;
+            if(bytes > slots - mapping.mChannel) { bytes = slots - mapping.mChannel; }
+            memcpy8(mapping.mLeds, data + mapping.mChannel, bytes);
+            if(mapping.mController) { mapping.mController->setDirty(); }
+        }
+        mReceived |= bit;
+        used = true;
+    }
+
+    uint32_t all = (mNumMappings == 32) ? 0xFFFFFFFF : (((uint32_t)1 << mNumMappings) - 1);
+    if(used && !sync && mReceived == all) {
+        completeFrame();
+    }
+    return used;
+}
+
+void CDMXReceiver::completeFrame() {
+    if(mReceived == 0) { return; }
+
+    mReceived = 0;
+    ++mFrames;
+    if(mOnFrame) {
+        mOnFrame();
+    } else {
+        FastLED.show();
+    }
+}
+
+bool CDMXReceiver::parsePacket(const uint8_t *packet, uint16_t size) {
+    if(size >= 12 && memcmp(packet, ArtNetId, sizeof(ArtNetId)) == 0) {
+        uint16_t opcode = packet[8] | ((uint16_t)packet[9] << 8);
+
+        if(opcode == ARTNET_OP_DMX && size >= ARTNET_HEADER_SIZE) {
+            uint16_t length = read_be16(packet + 16);
+            if(length > 512 || ARTNET_HEADER_SIZE + length > size) { return false; }
+
+            // the port address is the sub-net/universe byte, then the net
+            uint16_t universe = packet[14] | ((uint16_t)(packet[15] & 0x7F) << 8);
+            if(mArtSync && (uint32_t)(millis() - mArtSyncMillis) > ARTNET_SYNC_TIMEOUT) { mArtSync = false; }
+            // a sequence number of 0 means the source doesn't use them
+            return receiveData(universe, packet[12], packet[12] != 0, packet + ARTNET_HEADER_SIZE, length, mArtSync);
+        }
+
+        if(opcode == ARTNET_OP_SYNC) {
+            mArtSync = true;
+            mArtSyncMillis = millis();
+            completeFrame();
+            return true;
+        }
+        return false;
+    }
+
+    if(size >= E131_SYNC_SIZE && read_be16(packet) == 0x0010 && memcmp(packet + 4, AcnId, sizeof(AcnId)) == 0) {
+        uint32_t rootVector = read_be32(packet + 18);
+
+        if(rootVector == E131_VECTOR_ROOT_DATA && size >= E131_DATA_HEADER_SIZE) {
+            if(read_be32(packet + 40) != E131_VECTOR_FRAMING_DATA) { return false; }
+            if(packet[112] & (E131_OPTION_PREVIEW | E131_OPTION_TERMINATED)) { return false; }
+            // DMP layer: set property, with 1 byte addresses and data, starting at 0 and going up by 1
+            if(packet[117] != 0x02 || packet[118] != 0xA1) { return false; }
+
+            // the property values are the start code and then the DMX data
+            uint16_t values = read_be16(packet + 123);
+            if(values < 1 || values > 513 || E131_DATA_HEADER_SIZE - 1 + values > size) { return false; }
+            if(packet[125] != 0) { return false; }
+
+            mE131SyncUniverse = read_be16(packet + 109);
+            return receiveData(read_be16(packet + 113), packet[111], true, packet + E131_DATA_HEADER_SIZE, values - 1, mE131SyncUniverse != 0);
+        }
+
+        if(rootVector == E131_VECTOR_ROOT_EXTENDED && read_be32(packet + 40) == E131_VECTOR_FRAMING_SYNC) {
+            if(mE131SyncUniverse == 0 || read_be16(packet + 45) != mE131SyncUniverse) { return false; }
+            completeFrame();
+            return true;
+        }
+    }
+    return false;
+}
+
+FASTLED_NAMESPACE_END
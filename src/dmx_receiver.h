@@ -0,0 +1,141 @@
+#ifndef __INC_DMX_RECEIVER_H
+#define __INC_DMX_RECEIVER_H
+
+/// @file dmx_receiver.h
+/// Receiving led data from lighting consoles over the network, as Art-Net or sACN (E1.31)
+
+#include "FastLED.h"
+
+FASTLED_NAMESPACE_BEGIN
+
+/// @defgroup DMXReceiver Art-Net and sACN Input
+/// Parsing Art-Net and sACN (E1.31) packets into led arrays.
+/// @{
+
+/// The most universe mappings a CDMXReceiver can hold
+#ifndef DMX_RECEIVER_MAX_MAPPINGS
+#define DMX_RECEIVER_MAX_MAPPINGS 32
+#endif
+#if DMX_RECEIVER_MAX_MAPPINGS > 32
+#error "DMX_RECEIVER_MAX_MAPPINGS can be at most 32"
+#endif
+
+/// Number of leds that fit in one DMX universe, at 3 channels each
+#define DMX_LEDS_PER_UNIVERSE 170
+
+/// UDP port that Art-Net is sent to
+#define ARTNET_PORT 6454
+/// UDP port that sACN (E1.31) is sent to
+#define E131_PORT 5568
+
+/// Function called when a complete frame has been received
+typedef void (*dmx_frame_func)();
+
+/// Receives Art-Net and sACN (E1.31) packets, and writes their DMX data straight into led arrays,
+/// through a table mapping universes to ranges of leds.  It doesn't do any networking itself:
+/// the sketch reads packets from whatever UDP stack it has (WiFiUDP, EthernetUDP, a socket...)
+/// and hands them to parsePacket():
+///
+///     CDMXReceiver receiver;
+///     receiver.addUniverses(0, FastLED[0]);   // 170 leds per universe, from universe 0 up
+///     udp.begin(ARTNET_PORT);
+///     ...
+///     int size = udp.parsePacket();
+///     if(size > 0) {
+///         udp.read(packet, sizeof(packet));
+///         receiver.parsePacket(packet, size);   // calls FastLED.show() when a frame is complete
+///     }
+///
+/// A frame is complete when every mapped universe has been received since the last one.  When the
+/// console sends sync packets (ArtSync, or E1.31 synchronization), the frame is shown on the sync
+/// instead, so that all of the universes change at the same moment.
+///
+/// Art-Net port addresses and E1.31 universe numbers are used as they are (Art-Net counts from
+/// 0, E1.31 from 1).  Out of order packets are dropped using the sequence numbers.  ArtPoll isn't
+/// answered, and E1.31 priorities, preview data, and multiple sources aren't supported.
+class CDMXReceiver {
+    /// A range of leds fed from a universe
+    struct Mapping {
+        CRGB *mLeds;                    ///< the leds
+        CLEDController *mController;    ///< the controller the leds belong to, if known, to flag as changed
+        uint16_t mUniverse;             ///< the universe the leds are fed from
+        uint16_t mChannel;              ///< the first DMX channel (slot) of the leds in the universe, from 0
+        uint16_t mCount;                ///< the number of leds
+    };
+
+    Mapping mMappings[DMX_RECEIVER_MAX_MAPPINGS];  ///< the universe to led mappings
+    uint8_t mNumMappings;                          ///< the number of mappings in use
+    uint32_t mReceived;                            ///< bit per mapping, set when written since the last frame
+    uint32_t mSequenced;                           ///< bit per mapping, set once mSequence holds a sequence number
+    uint8_t mSequence[DMX_RECEIVER_MAX_MAPPINGS];  ///< sequence number last accepted for each mapping
+    uint32_t mArtSyncMillis;                       ///< millis() of the last ArtSync, when syncing
+    bool mArtSync;                                 ///< whether the Art-Net source is sending ArtSync
+    uint16_t mE131SyncUniverse;                    ///< the synchronization universe of the E1.31 source, 0 for none
+    uint32_t mFrames;                              ///< the number of complete frames received
+    dmx_frame_func mOnFrame;                       ///< called for each complete frame, NULL for FastLED.show()
+
+    /// Write the DMX data of a universe into the leds mapped to it
+    /// @param universe the universe
+    /// @param sequence the sequence number of the packet
+    /// @param useSequence whether to drop the data if the sequence number is out of order
+    /// @param data the DMX data, starting at channel 0
+    /// @param slots the number of channels in data
+    /// @param sync whether the frame will be completed by a sync packet
+    /// @returns true if any leds are mapped to the universe and the data was in order
+    bool receiveData(uint16_t universe, uint8_t sequence, bool useSequence, const uint8_t *data, uint16_t slots, bool sync);
+
+    /// Finish a frame, if anything has been received for it
+    void completeFrame();
+
+public:
+    CDMXReceiver() : mNumMappings(0), mReceived(0), mSequenced(0), mArtSyncMillis(0), mArtSync(false), mE131SyncUniverse(0), mFrames(0), mOnFrame(NULL) {}
+
+    /// Map a range of leds to a universe
+    /// @param universe the universe
+    /// @param leds the leds
+    /// @param count the number of leds, at most DMX_LEDS_PER_UNIVERSE
+    /// @param channel the first DMX channel of the leds in the universe, counting from 0
+    /// @returns the index of the mapping, or -1 if there's no room for it
+    int8_t addUniverse(uint16_t universe, CRGB *leds, uint16_t count, uint16_t channel = 0);
+
+    /// Map a run of leds across consecutive universes, DMX_LEDS_PER_UNIVERSE leds to each
+    /// @param firstUniverse the universe the first leds are fed from
+    /// @param leds the leds
+    /// @param count the number of leds
+    /// @returns the number of universes mapped, or -1 if there's no room for all of them
+    int16_t addUniverses(uint16_t firstUniverse, CRGB *leds, uint16_t count);
+
+    /// Map all of a controller's leds across consecutive universes, DMX_LEDS_PER_UNIVERSE leds to
+    /// each.  The controller is flagged with CLEDController::setDirty() whenever its leds are
+    /// written, for CHANGE_DETECT_MANUAL.  The leds are mapped in memory order, all of the lanes
+    /// of a block controller, and from the lowest address for a reversed strip.
+    /// @param firstUniverse the universe the first leds are fed from
+    /// @param controller the controller
+    /// @returns the number of universes mapped, or -1 if there's no room for all of them, or the
+    /// controller has no led array or 16 bit leds
+    int16_t addUniverses(uint16_t firstUniverse, CLEDController & controller);
+
+    /// Remove all of the mappings
+    void clearUniverses() { mNumMappings = 0; mReceived = 0; mSequenced = 0; }
+
+    /// Set the function called when a complete frame has been received, in place of FastLED.show()
+    /// @param onFrame the function, or NULL for FastLED.show()
+    void setFrameCallback(dmx_frame_func onFrame) { mOnFrame = onFrame; }
+
+    /// Parse an Art-Net or sACN packet, writing its data into the mapped leds, and show the frame
+    /// if it's complete
+    /// @param packet the contents of the UDP packet
+    /// @param size the size of the packet
+    /// @returns true if the packet was an Art-Net or sACN packet that was used, false if it was
+    /// ignored (not for a mapped universe, out of order, not a packet type that's handled, or malformed)
+    bool parsePacket(const uint8_t *packet, uint16_t size);
+
+    /// Get the number of complete frames received so far
+    uint32_t getFrames() const { return mFrames; }
+};
+
+/// @} DMXReceiver
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -75,6 +75,37 @@
 /// This enables much more accurate color control on low brightness settings.
 //#define FASTLED_USE_GLOBAL_BRIGHTNESS 1
 
+/// @def FASTLED_PIXEL_LUT
+/// Use this to have PixelController build lookup tables for the dithering and scaling of each
+/// color channel once per frame, so that loadAndScale() is a single table lookup per byte.
+/// The tables are used by loadAndScale() and loadAndScale(lane) and their advance/step forms,
+/// which is what the clockless drivers written in C++ (ARM, ESP8266, ESP32, RP2040, nRF52 PWM,
+/// the block/parallel ones) and the SPI writePixels() loops call.  They don't help:
+///   - the AVR and M0 (D21, KL26, nRF51) clockless drivers, whose assembly reads d, e and mScale
+///   - APA102/SK9822 (chipsets.h), whose loadAndScale(lane, scale) calls scale without dithering
+///   - loadAndScale(lane, d, scale), which takes its dithering and scale from the caller
+/// The tables make every PixelController 1.5k bigger, on the stack.  Most showRGBInternal() and
+/// writePixels() take it by value, so they also copy the tables, 1.5k more stack and a 1.5k
+/// memcpy8 per show.  It is off by default.
+// #define FASTLED_PIXEL_LUT 1
+
+/// @def FASTLED_CRGB16
+/// Use this to have the drivers quantize CRGB16 leds (see CLEDController::setLeds(CRGB16*, int))
+/// as they load them, rather than in a pass of their own into an 8 bit buffer before the show.
+/// That saves the pass and 3 bytes of ram per led, but adds a check of every byte every driver
+/// loads, 16 bit leds or not, so it is off by default.
+// #define FASTLED_CRGB16 1
+
+/// @def FASTLED_PROFILE
+/// Use this to have show() time each of its stages: the sketch's rendering between shows, the
+/// wait for the maximum refresh rate, the power limiting, and the encoding and transmitting of
+/// each controller.  Each keeps the min/avg/max and a histogram (see CTimingStats), which can be
+/// read with FastLED.getShowStats(), CLEDController::getEncodeStats(), etc... or printed with
+/// FastLED.dumpProfile().  This takes a few calls to micros() and about 100 bytes of ram per
+/// stage, so it is off by default.  It changes the layout of CFastLED and CLEDController, so
+/// turn it on here (or with a compiler flag for the whole build), not in the sketch.
+// #define FASTLED_PROFILE 1
+
 
 // The defines are used for Doxygen documentation generation.
 // They're commented out above and repeated here so the Doxygen parser
@@ -87,6 +118,9 @@
 #define FASTLED_NOISE_ALLOW_AVERAGE_TO_OVERFLOW 0
 #define FASTLED_INTERRUPT_RETRY_COUNT 2
 #define FASTLED_USE_GLOBAL_BRIGHTNESS 0
+#define FASTLED_PIXEL_LUT 1
+#define FASTLED_CRGB16 1
+#define FASTLED_PROFILE 1
 #endif
 
 #endif
@@ -0,0 +1,75 @@
+#ifndef __INC_FASTLED_PROFILE_H
+#define __INC_FASTLED_PROFILE_H
+
+/// @file fastled_profile.h
+/// Timing statistics for profiling FastLED.show(), see FASTLED_PROFILE in fastled_config.h
+
+#include <stdint.h>
+
+FASTLED_NAMESPACE_BEGIN
+
+#ifndef FASTLED_PROFILE
+/// Whether show() records how long each of its stages take (see fastled_config.h)
+#define FASTLED_PROFILE 0
+#endif
+
+/// Number of buckets in a CTimingStats histogram.  Bucket 0 counts times under 2 µs, bucket
+/// N counts times from 2^N up to 2^(N+1) µs, and the last bucket counts everything longer.
+#ifndef FASTLED_PROFILE_BUCKETS
+#define FASTLED_PROFILE_BUCKETS 20
+#endif
+
+/// Minimum, average, and maximum of a series of times, along with a histogram of them
+class CTimingStats {
+    uint32_t mCount;     ///< number of times recorded
+    uint32_t mMin;       ///< shortest time recorded, in µs
+    uint32_t mMax;       ///< longest time recorded, in µs
+    uint64_t mTotal;     ///< sum of the times recorded, in µs
+    uint16_t mBuckets[FASTLED_PROFILE_BUCKETS];  ///< histogram of the times, by power of two, saturating
+
+public:
+    CTimingStats() { reset(); }
+
+    /// Forget all of the recorded times
+    void reset() {
+        mCount = 0;
+        mMin = 0xFFFFFFFF;
+        mMax = 0;
+        mTotal = 0;
+        for(uint8_t i = 0; i < FASTLED_PROFILE_BUCKETS; ++i) { mBuckets[i] = 0; }
+    }
+
+    /// Record a time
+    /// @param us the time, in µs
+    void record(uint32_t us) {
+        ++mCount;
+        if(us < mMin) { mMin = us; }
+        if(us > mMax) { mMax = us; }
+        mTotal += us;
+
+        uint8_t bucket = 0;
+        while((us >>= 1) && bucket < FASTLED_PROFILE_BUCKETS - 1) { ++bucket; }
+        if(mBuckets[bucket] != 0xFFFF) { ++mBuckets[bucket]; }
+    }
+
+    /// Get the number of times recorded
+    uint32_t getCount() const { return mCount; }
+    /// Get the shortest time recorded, in µs, or 0 if there are none
+    uint32_t getMin() const { return mCount ? mMin : 0; }
+    /// Get the longest time recorded, in µs
+    uint32_t getMax() const { return mMax; }
+    /// Get the average time recorded, in µs, or 0 if there are none
+    uint32_t getAverage() const { return mCount ? (uint32_t)(mTotal / mCount) : 0; }
+
+    /// Get the number of times recorded in a histogram bucket, which stops counting at 65535
+    /// @param bucket the bucket, 0 to FASTLED_PROFILE_BUCKETS - 1
+    uint16_t getBucket(uint8_t bucket) const { return (bucket < FASTLED_PROFILE_BUCKETS) ? mBuckets[bucket] : 0; }
+
+    /// Get the shortest time counted by a histogram bucket, in µs
+    /// @param bucket the bucket, 0 to FASTLED_PROFILE_BUCKETS - 1
+    static uint32_t getBucketStart(uint8_t bucket) { return bucket ? ((uint32_t)1 << bucket) : 0; }
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,50 @@
+/// Disables pragma messages and warnings
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+
+/// @file frame_scheduler.cpp
+/// Non-blocking frame pacing, see frame_scheduler.h
+
+FASTLED_NAMESPACE_BEGIN
+
+uint32_t CFrameScheduler::getMicrosUntilNextFrame() {
+    uint32_t wait = FastLED.getMicrosUntilNextFrame();
+    if(mStepMicros && mStarted) {
+        int32_t due = (int32_t)(mNextMicros - micros());
+        if(due > 0 && (uint32_t)due > wait) { wait = due; }
+    }
+    return wait;
+}
+
+bool CFrameScheduler::run() {
+    uint32_t now = micros();
+    if(!mStarted) {
+        mNextMicros = now;
+        mStarted = true;
+    }
+
+    if(mStepMicros && (int32_t)(now - mNextMicros) < 0) { return false; }
+    if(FastLED.getMicrosUntilNextFrame()) { return false; }
+
+    if(mStepMicros) {
+        uint32_t late = now - mNextMicros;
+        if(late >= mStepMicros && mPolicy == FRAME_DROP) {
+            // skip ahead to the step that's due now, keeping to the original schedule
+            uint32_t missed = late / mStepMicros;
+            mFrame += missed;
+            mDropped += missed;
+            mNextMicros += missed * mStepMicros;
+        } else if(late >= mStepMicros) {
+            // FRAME_DELAY: the schedule slips, rather than running frames back to back
+            mNextMicros = now;
+        }
+        mNextMicros += mStepMicros;
+    }
+
+    if(mRender) { mRender(mFrame); }
+    ++mFrame;
+    FastLED.show();
+    return true;
+}
+
+FASTLED_NAMESPACE_END
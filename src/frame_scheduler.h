@@ -0,0 +1,93 @@
+#ifndef __INC_FRAME_SCHEDULER_H
+#define __INC_FRAME_SCHEDULER_H
+
+/// @file frame_scheduler.h
+/// Non-blocking frame pacing, rendering and showing frames from loop() when they're due
+
+#include "FastLED.h"
+
+FASTLED_NAMESPACE_BEGIN
+
+/// @defgroup FrameScheduler Frame Pacing
+/// Rendering and showing frames at a fixed rate without blocking.
+/// @{
+
+/// Function that renders a frame into the leds
+/// @param frame the number of the frame, counting fixed time steps from the start (see CFrameScheduler)
+typedef void (*frame_render_func)(uint32_t frame);
+
+/// What a CFrameScheduler does when frames are running late
+typedef enum {
+    FRAME_DROP=0,   ///< skip the frames that were missed, so that the animation keeps to the clock
+    FRAME_DELAY=1   ///< render every frame, so that the animation slows down instead
+} TFramePolicy;
+
+/// Renders and shows frames at a fixed rate, from loop(), without ever waiting.  Calling
+/// FastLED.show() faster than the maximum refresh rate (of the leds, or the one set with
+/// FastLED.setMaxRefreshRate()) spins until the strips are ready for the next frame.  run()
+/// instead returns right away when a frame isn't due, leaving the time for other work, e.g.
+/// networking:
+///
+///     void render(uint32_t frame) {
+///         fill_rainbow(leds, NUM_LEDS, frame);
+///     }
+///
+///     CFrameScheduler scheduler(render, 60);
+///
+///     void loop() {
+///         scheduler.run();
+///         // ... other work
+///     }
+///
+/// Each frame is numbered by the fixed time step it's for, so animations driven by the frame
+/// number run at the same speed whatever the frame rate ends up being.
+class CFrameScheduler {
+    frame_render_func mRender;   ///< renders a frame
+    uint32_t mStepMicros;        ///< the time step between frames in µs, or 0 to go as fast as the leds allow
+    uint32_t mNextMicros;        ///< micros() when the next frame is due
+    uint32_t mFrame;             ///< the number of the next frame
+    uint32_t mDropped;           ///< the number of frames skipped for running late
+    TFramePolicy mPolicy;        ///< what to do when running late
+    bool mStarted;               ///< whether mNextMicros has been set
+
+public:
+    /// Create a scheduler
+    /// @param render the function that renders each frame
+    /// @param fps the frame rate, or 0 to render a frame whenever the leds can take one
+    /// @param policy what to do when running late
+    CFrameScheduler(frame_render_func render, uint16_t fps = 0, TFramePolicy policy = FRAME_DROP)
+        : mRender(render), mNextMicros(0), mFrame(0), mDropped(0), mPolicy(policy), mStarted(false) { setFrameRate(fps); }
+
+    /// Set the frame rate
+    /// @param fps the frame rate, or 0 to render a frame whenever the leds can take one
+    void setFrameRate(uint16_t fps) { mStepMicros = fps ? (1000000UL / fps) : 0; }
+
+    /// Set what to do when frames are running late
+    /// @param policy FRAME_DROP or FRAME_DELAY
+    void setPolicy(TFramePolicy policy) { mPolicy = policy; }
+
+    /// Start over from frame 0, with the first frame due right away
+    void reset() { mFrame = 0; mDropped = 0; mStarted = false; }
+
+    /// Get how long it is until the next frame is due, including the wait for the leds'
+    /// maximum refresh rate
+    /// @returns the time left in µs, or 0 if run() would render a frame now
+    uint32_t getMicrosUntilNextFrame();
+
+    /// Render and show a frame if one is due, and otherwise return right away.  Call this
+    /// from loop() as often as possible.
+    /// @returns true if a frame was rendered and shown
+    bool run();
+
+    /// Get the number of the next frame to be rendered
+    uint32_t getFrame() const { return mFrame; }
+
+    /// Get the number of frames skipped so far, for running late with FRAME_DROP
+    uint32_t getDroppedFrames() const { return mDropped; }
+};
+
+/// @} FrameScheduler
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,329 @@
+/// Disables pragma messages and warnings
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+#include <stdlib.h>
+
+/// @file frame_stream.cpp
+/// Frame recording and playback, see frame_stream.h
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Size of the stream header
+#define FRAME_STREAM_HEADER_SIZE 16
+/// Size of the stream trailer
+#define FRAME_STREAM_TRAILER_SIZE 12
+/// Frame flags bit, set on keyframes
+#define FRAME_FLAG_KEYFRAME 0x01
+
+/// Magic number at the start of a stream
+static const uint8_t StreamMagic[4] = { 'F', 'L', 'F', 'S' };
+/// Magic number at the end of a finished stream
+static const uint8_t TrailerMagic[4] = { 'F', 'L', 'F', 'E' };
+
+/// Store a little endian 16 bit value
+static inline void put_le16(uint8_t *p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+/// Store a little endian 32 bit value
+static inline void put_le32(uint8_t *p, uint32_t v) { put_le16(p, v); put_le16(p + 2, v >> 16); }
+/// Read a little endian 16 bit value
+static inline uint16_t get_le16(const uint8_t *p) { return p[0] | ((uint16_t)p[1] << 8); }
+/// Read a little endian 32 bit value
+static inline uint32_t get_le32(const uint8_t *p) { return get_le16(p) | ((uint32_t)get_le16(p + 2) << 16); }
+
+/// Whether a controller's leds are recorded and played back
+static inline bool is_stream_controller(CLEDController *pCur) {
+    return pCur->leds16() == NULL && pCur->leds() != NULL && pCur->size() > 0;
+}
+
+bool CFrameRecorder::write(const uint8_t *data, uint32_t size) {
+    if(mFailed || !mWriter.write(data, size)) {
+        mFailed = true;
+        return false;
+    }
+    mOffset += size;
+    return true;
+}
+
+bool CFrameRecorder::writeOp(uint8_t op, uint16_t count) {
+    uint8_t header[3];
+    if(count <= 63) {
+        header[0] = (op << 6) | (count - 1);
+        return write(header, 1);
+    }
+    header[0] = (op << 6) | 63;
+    put_le16(header + 1, count - 64);
+    return write(header, 3);
+}
+
+bool CFrameRecorder::encode(const CRGB *leds, const CRGB *previous) {
+    uint16_t i = 0;
+    while(i < mNumLeds) {
+        uint16_t j = i + 1;
+        if(previous && leds[i] == previous[i]) {
+            while(j < mNumLeds && leds[j] == previous[j]) { ++j; }
+            writeOp(FRAME_OP_SKIP, j - i);
+        } else if(j < mNumLeds && leds[j] == leds[i]) {
+            while(j < mNumLeds && leds[j] == leds[i]) { ++j; }
+            writeOp(FRAME_OP_RUN, j - i);
+            write(leds[i].raw, 3);
+        } else {
+            // stop at leds that can be skipped, or at a run long enough to pay for the ops around it
+            while(j < mNumLeds && !(previous && leds[j] == previous[j]) &&
+                  !(j + 2 < mNumLeds && leds[j + 1] == leds[j] && leds[j + 2] == leds[j])) { ++j; }
+            writeOp(FRAME_OP_LITERAL, j - i);
+            write(leds[i].raw, (uint32_t)(j - i) * 3);
+        }
+        i = j;
+    }
+    return !mFailed;
+}
+
+uint16_t CFrameRecorder::countControllerLeds() {
+    uint32_t count = 0;
+    for(CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+        if(is_stream_controller(pCur)) { count += pCur->size(); }
+    }
+    return (count > 0xFFFF) ? 0xFFFF : count;
+}
+
+void CFrameRecorder::release() {
+    free(mPrevious);
+    free(mGather);
+    free(mIndex);
+    mPrevious = NULL;
+    mGather = NULL;
+    mIndex = NULL;
+    mIndexCapacity = 0;
+}
+
+bool CFrameRecorder::begin(uint16_t frameRate) {
+    release();
+    mNumLeds = mLeds ? mCount : countControllerLeds();
+    mOffset = 0;
+    mFrames = 0;
+    mFailed = false;
+    mStarted = false;
+
+    // only gather the controllers' leds into one frame when they aren't in one array already
+    uint8_t nControllers = 0;
+    if(!mLeds) {
+        for(CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+            if(is_stream_controller(pCur)) { ++nControllers; }
+        }
+    }
+    mPrevious = mNumLeds ? (CRGB*)malloc((uint32_t)mNumLeds * sizeof(CRGB)) : NULL;
+    mGather = (nControllers > 1) ? (CRGB*)malloc((uint32_t)mNumLeds * sizeof(CRGB)) : NULL;
+    if(mPrevious == NULL || (nControllers > 1 && mGather == NULL)) {
+        release();
+        mFailed = true;
+        return false;
+    }
+
+    uint8_t header[FRAME_STREAM_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, StreamMagic, sizeof(StreamMagic));
+    header[4] = FRAME_STREAM_VERSION;
+    put_le16(header + 6, mNumLeds);
+    put_le16(header + 8, frameRate);
+    put_le16(header + 10, mKeyInterval);
+    mStarted = write(header, sizeof(header));
+    return mStarted;
+}
+
+bool CFrameRecorder::recordFrame(uint8_t brightness) {
+    if(!mStarted) {
+        if(mFrames || mFailed || !begin()) { return false; }
+    }
+
+    const CRGB *leds = mLeds;
+    if(!leds) {
+        // one controller's leds can be recorded where they are, several have to be put together
+        CRGB *pGather = mGather;
+        for(CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+            if(!is_stream_controller(pCur)) { continue; }
+            if(!mGather) {
+                if(pCur->size() < mNumLeds) { return false; }
+                leds = pCur->leds();
+                break;
+            }
+            uint16_t n = pCur->size();
+            if(n > mNumLeds - (pGather - mGather)) { n = mNumLeds - (pGather - mGather); }
+            memcpy(pGather, pCur->leds(), n * sizeof(CRGB));
+            pGather += n;
+        }
+        if(mGather) { leds = mGather; }
+        if(!leds) { return false; }
+    }
+
+    bool key = (mFrames % mKeyInterval) == 0;
+    if(key) {
+        if(mFrames / mKeyInterval >= mIndexCapacity) {
+            uint32_t capacity = mIndexCapacity ? mIndexCapacity * 2 : 16;
+            uint32_t *pIndex = (uint32_t*)realloc(mIndex, capacity * sizeof(uint32_t));
+            if(pIndex == NULL) {
+                mFailed = true;
+                return false;
+            }
+            mIndex = pIndex;
+            mIndexCapacity = capacity;
+        }
+        mIndex[mFrames / mKeyInterval] = mOffset;
+    }
+
+    uint8_t header[2] = { (uint8_t)(key ? FRAME_FLAG_KEYFRAME : 0), brightness };
+    write(header, sizeof(header));
+    if(!encode(leds, key ? NULL : mPrevious)) { return false; }
+
+    memcpy(mPrevious, leds, (uint32_t)mNumLeds * sizeof(CRGB));
+    ++mFrames;
+    return true;
+}
+
+bool CFrameRecorder::finish() {
+    if(!mStarted) { return false; }
+    mStarted = false;
+
+    uint32_t indexOffset = mOffset;
+    uint32_t nKeyframes = (mFrames + mKeyInterval - 1) / mKeyInterval;
+    for(uint32_t i = 0; i < nKeyframes; ++i) {
+        uint8_t entry[4];
+        put_le32(entry, mIndex[i]);
+        write(entry, sizeof(entry));
+    }
+
+    uint8_t trailer[FRAME_STREAM_TRAILER_SIZE];
+    put_le32(trailer, mFrames);
+    put_le32(trailer + 4, indexOffset);
+    memcpy(trailer + 8, TrailerMagic, sizeof(TrailerMagic));
+    write(trailer, sizeof(trailer));
+
+    release();
+    return !mFailed;
+}
+
+bool CFramePlayer::begin() {
+    mValid = false;
+    mFrame = 0;
+
+    uint8_t header[FRAME_STREAM_HEADER_SIZE];
+    if(!mReader.seek(0) || mReader.read(header, sizeof(header)) != sizeof(header)) { return false; }
+    if(memcmp(header, StreamMagic, sizeof(StreamMagic)) != 0 || header[4] != FRAME_STREAM_VERSION) { return false; }
+    mNumLeds = get_le16(header + 6);
+    mFrameRate = get_le16(header + 8);
+    mKeyInterval = get_le16(header + 10);
+    if(mKeyInterval == 0) { return false; }
+
+    // a stream that wasn't finished has no trailer, so it plays until it runs out
+    mFrameCount = 0xFFFFFFFF;
+    mIndexOffset = 0;
+    uint32_t size = mReader.size();
+    uint8_t trailer[FRAME_STREAM_TRAILER_SIZE];
+    if(size >= FRAME_STREAM_HEADER_SIZE + FRAME_STREAM_TRAILER_SIZE && mReader.seek(size - FRAME_STREAM_TRAILER_SIZE) &&
+       mReader.read(trailer, sizeof(trailer)) == sizeof(trailer) && memcmp(trailer + 8, TrailerMagic, sizeof(TrailerMagic)) == 0) {
+        mFrameCount = get_le32(trailer);
+        mIndexOffset = get_le32(trailer + 4);
+    }
+
+    mValid = mReader.seek(FRAME_STREAM_HEADER_SIZE);
+    return mValid;
+}
+
+bool CFramePlayer::nextSpan() {
+    while(mNextController) {
+        CLEDController *pCur = mNextController;
+        mNextController = pCur->next();
+        if(is_stream_controller(pCur)) {
+            mSpan = pCur->leds();
+            mSpanLeft = pCur->size();
+            pCur->setDirty();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CFramePlayer::decodeFrame() {
+    uint8_t header[2];
+    if(mReader.read(header, sizeof(header)) != sizeof(header)) { return false; }
+
+    mSpan = mLeds;
+    mSpanLeft = mLeds ? mCount : 0;
+    mNextController = mLeds ? NULL : CLEDController::head();
+
+    uint16_t left = mNumLeds;
+    while(left) {
+        uint8_t op[3];
+        if(mReader.read(op, 1) != 1) { return false; }
+        uint16_t count = (op[0] & 63) + 1;
+        if(count == 64) {
+            if(mReader.read(op + 1, 2) != 2) { return false; }
+            count = get_le16(op + 1) + 64;
+        }
+        uint8_t code = op[0] >> 6;
+        if(count > left || code > FRAME_OP_LITERAL) { return false; }
+        left -= count;
+
+        CRGB color;
+        if(code == FRAME_OP_RUN && mReader.read(color.raw, 3) != 3) { return false; }
+
+        while(count) {
+            if(mSpanLeft == 0 && !nextSpan()) {
+                // the stream has more leds than there are to play into, drop the rest
+                while(code == FRAME_OP_LITERAL && count--) {
+                    if(mReader.read(color.raw, 3) != 3) { return false; }
+                }
+                break;
+            }
+            uint16_t n = (count < mSpanLeft) ? count : mSpanLeft;
+            if(code == FRAME_OP_RUN) {
+                fill_solid(mSpan, n, color);
+            } else if(code == FRAME_OP_LITERAL) {
+                if(mReader.read(mSpan->raw, (uint32_t)n * 3) != (uint32_t)n * 3) { return false; }
+            }
+            mSpan += n;
+            mSpanLeft -= n;
+            count -= n;
+        }
+    }
+
+    mBrightness = header[1];
+    ++mFrame;
+    return true;
+}
+
+bool CFramePlayer::readFrame() {
+    if(!mValid || mFrame >= mFrameCount) { return false; }
+    return decodeFrame();
+}
+
+bool CFramePlayer::showFrame() {
+    if(!readFrame()) { return false; }
+    FastLED.show(mBrightness);
+    return true;
+}
+
+bool CFramePlayer::seek(uint32_t frame) {
+    if(!mValid || (mFrameCount != 0xFFFFFFFF && frame > mFrameCount)) { return false; }
+
+    // start from the keyframe before the frame, unless decoding on from where we are is shorter
+    uint32_t key = 0;
+    if(mIndexOffset && mFrameCount) {
+        key = (((frame < mFrameCount) ? frame : mFrameCount - 1) / mKeyInterval) * mKeyInterval;
+    }
+    if(frame < mFrame || key > mFrame) {
+        uint32_t offset = FRAME_STREAM_HEADER_SIZE;
+        if(key) {
+            uint8_t entry[4];
+            if(!mReader.seek(mIndexOffset + (key / mKeyInterval) * 4) || mReader.read(entry, sizeof(entry)) != sizeof(entry)) { return false; }
+            offset = get_le32(entry);
+        }
+        if(!mReader.seek(offset)) { return false; }
+        mFrame = key;
+    }
+
+    while(mFrame < frame) {
+        if(!decodeFrame()) { return false; }
+    }
+    return true;
+}
+
+FASTLED_NAMESPACE_END
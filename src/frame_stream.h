@@ -0,0 +1,387 @@
+#ifndef __INC_FRAME_STREAM_H
+#define __INC_FRAME_STREAM_H
+
+/// @file frame_stream.h
+/// Recording shows into a compact stream of frames, and playing them back
+
+#include "FastLED.h"
+#include <string.h>
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#endif
+
+FASTLED_NAMESPACE_BEGIN
+
+/// @defgroup FrameStream Frame Recording and Playback
+/// Recording frames into a compressed stream, and playing them back from flash or a file.
+///
+/// A stream starts with a 16 byte header:
+///
+///     0   "FLFS"
+///     4   version (FRAME_STREAM_VERSION), flags (0)
+///     6   number of leds in each frame, 16 bit
+///     8   frame rate, 16 bit, 0 if not known
+///     10  keyframe interval, 16 bit
+///     12  reserved (0)
+///
+/// followed by the frames, then an index of the keyframes and a 12 byte trailer:
+///
+///     frame count, 32 bit
+///     offset of the index, 32 bit
+///     "FLFE"
+///
+/// The index is the offset of every keyframe, 32 bit each.  All of the numbers are little
+/// endian.  A stream that was never finished (no trailer) plays through to its end, but
+/// can't seek except by going back to the start.
+///
+/// Each frame is a flags byte (bit 0 set for a keyframe) and the brightness it was shown
+/// at, then ops that cover its leds in order.  An op's first byte is the op in the top two
+/// bits, and the number of leds less one in the bottom six.  When they're all ones, a 16
+/// bit count less 64 follows.
+///   - FRAME_OP_SKIP leaves the leds as they were in the previous frame (never in keyframes)
+///   - FRAME_OP_RUN sets the leds to the CRGB that follows
+///   - FRAME_OP_LITERAL sets the leds to the CRGBs that follow, one for each
+///
+/// Keyframes come every keyframe interval frames, starting with frame 0, and are the only
+/// frames that don't depend on the previous one.
+/// @{
+
+/// The version of the stream format written by CFrameRecorder
+#define FRAME_STREAM_VERSION 1
+
+/// The number of frames from one keyframe to the next, unless one is given to CFrameRecorder.
+/// Seeking decodes from the keyframe before the frame, so shorter intervals seek faster but
+/// compress less.
+#ifndef FRAME_STREAM_KEYFRAME_INTERVAL
+#define FRAME_STREAM_KEYFRAME_INTERVAL 60
+#endif
+
+/// @name Frame stream ops
+/// @{
+#define FRAME_OP_SKIP 0       ///< leds unchanged from the previous frame
+#define FRAME_OP_RUN 1        ///< leds all set to one color
+#define FRAME_OP_LITERAL 2    ///< leds each set to their own color
+/// @}
+
+/// Where a CFrameRecorder writes its stream
+class CFrameStreamWriter {
+public:
+    virtual ~CFrameStreamWriter() {}
+
+    /// Append data to the stream
+    /// @param data the data
+    /// @param size the number of bytes
+    /// @returns true if all of it was written
+    virtual bool write(const uint8_t *data, uint32_t size) = 0;
+};
+
+/// Where a CFramePlayer reads its stream from.  Wrap an SD card file (or any other storage)
+/// in one of these to play a stream from it:
+///
+///     class CSDFrameReader : public CFrameStreamReader {
+///         File & mFile;
+///     public:
+///         CSDFrameReader(File & file) : mFile(file) {}
+///         virtual uint32_t read(uint8_t *data, uint32_t size) { return mFile.read(data, size); }
+///         virtual bool seek(uint32_t position) { return mFile.seek(position); }
+///         virtual uint32_t size() { return mFile.size(); }
+///     };
+class CFrameStreamReader {
+public:
+    virtual ~CFrameStreamReader() {}
+
+    /// Read data from the current position in the stream
+    /// @param data where to put the data
+    /// @param size the number of bytes to read
+    /// @returns the number of bytes read, less than size at the end of the stream
+    virtual uint32_t read(uint8_t *data, uint32_t size) = 0;
+
+    /// Move to a position in the stream
+    /// @param position the offset from the start of the stream
+    /// @returns true if the position is in the stream
+    virtual bool seek(uint32_t position) = 0;
+
+    /// Get the size of the stream
+    /// @returns the size in bytes
+    virtual uint32_t size() = 0;
+};
+
+/// Writes a stream into a fixed size buffer in ram
+class CMemoryFrameWriter : public CFrameStreamWriter {
+    uint8_t *mData;       ///< the buffer
+    uint32_t mCapacity;   ///< the size of the buffer
+    uint32_t mSize;       ///< the number of bytes written
+
+public:
+    /// Create a writer
+    /// @param data the buffer
+    /// @param capacity the size of the buffer
+    CMemoryFrameWriter(uint8_t *data, uint32_t capacity) : mData(data), mCapacity(capacity), mSize(0) {}
+
+    /// Append data to the buffer
+    /// @returns false, writing nothing, if the data doesn't fit
+    virtual bool write(const uint8_t *data, uint32_t size) {
+        if(size > mCapacity - mSize) { return false; }
+        memcpy(mData + mSize, data, size);
+        mSize += size;
+        return true;
+    }
+
+    /// Get the number of bytes written so far
+    uint32_t size() const { return mSize; }
+
+    /// Forget what has been written, to start a new stream
+    void clear() { mSize = 0; }
+};
+
+/// Reads a stream from memory, in ram or in flash
+class CMemoryFrameReader : public CFrameStreamReader {
+    const uint8_t *mData;   ///< the stream
+    uint32_t mSize;         ///< the size of the stream
+    uint32_t mPosition;     ///< the current position
+    bool mProgmem;          ///< whether mData is in flash, and has to be read with FL_PGM_READ_BYTE_NEAR()
+
+public:
+    /// Create a reader
+    /// @param data the stream
+    /// @param size the size of the stream
+    /// @param progmem true if the stream is declared with FL_PROGMEM (on AVR, where flash isn't in the address space)
+    CMemoryFrameReader(const uint8_t *data, uint32_t size, bool progmem = false) : mData(data), mSize(size), mPosition(0), mProgmem(progmem) {}
+
+    virtual uint32_t read(uint8_t *data, uint32_t size) {
+        if(size > mSize - mPosition) { size = mSize - mPosition; }
+        if(mProgmem) {
+            for(uint32_t i = 0; i < size; ++i) { data[i] = FL_PGM_READ_BYTE_NEAR(mData + mPosition + i); }
+        } else {
+            memcpy(data, mData + mPosition, size);
+        }
+        mPosition += size;
+        return size;
+    }
+
+    virtual bool seek(uint32_t position) {
+        if(position > mSize) { return false; }
+        mPosition = position;
+        return true;
+    }
+
+    virtual uint32_t size() { return mSize; }
+};
+
+#if defined(FASTLED_HOST) || defined(FASTLED_DOXYGEN)
+/// Writes a stream to a stdio file, for rendering shows on the host
+class CFileFrameWriter : public CFrameStreamWriter {
+    FILE *mFile;   ///< the file, opened for writing
+
+public:
+    /// Create a writer
+    /// @param file the file, opened for writing in binary mode
+    CFileFrameWriter(FILE *file) : mFile(file) {}
+
+    virtual bool write(const uint8_t *data, uint32_t size) { return fwrite(data, 1, size, mFile) == size; }
+};
+
+/// Reads a stream from a stdio file
+class CFileFrameReader : public CFrameStreamReader {
+    FILE *mFile;   ///< the file, opened for reading
+
+public:
+    /// Create a reader
+    /// @param file the file, opened for reading in binary mode
+    CFileFrameReader(FILE *file) : mFile(file) {}
+
+    virtual uint32_t read(uint8_t *data, uint32_t size) { return fread(data, 1, size, mFile); }
+
+    virtual bool seek(uint32_t position) { return fseek(mFile, position, SEEK_SET) == 0; }
+
+    virtual uint32_t size() {
+        long position = ftell(mFile);
+        fseek(mFile, 0, SEEK_END);
+        long size = ftell(mFile);
+        fseek(mFile, position, SEEK_SET);
+        return size;
+    }
+};
+#endif
+
+/// Records frames into a stream, keeping only the leds that changed from the previous frame
+/// and run length coding the rest.  It records either the leds of all of the controllers,
+/// every time FastLED.show() is called:
+///
+///     FILE *file = fopen("show.fls", "wb");
+///     CFileFrameWriter writer(file);
+///     CFrameRecorder recorder(writer);
+///     recorder.begin(60);
+///     FastLED.setRecorder(&recorder);
+///     for(int frame = 0; frame < 3600; ++frame) {
+///         render(frame);
+///         FastLED.show();
+///     }
+///     recorder.finish();
+///
+/// or an array of leds given with setLeds(), frame by frame through recordFrame(), without
+/// needing any controllers.  Controllers driven from CRGB16 data are left out.
+///
+/// Recording keeps a copy of the previous frame (and, when there are several controllers,
+/// of the current one), along with the index of keyframes, all allocated on the heap.
+class CFrameRecorder {
+    CFrameStreamWriter & mWriter;   ///< where the stream goes
+    const CRGB *mLeds;              ///< the leds to record, or NULL for all of the controllers'
+    uint16_t mCount;                ///< the number of leds in mLeds
+    uint16_t mNumLeds;              ///< the number of leds in each frame of the stream
+    uint16_t mKeyInterval;          ///< the number of frames from one keyframe to the next
+    CRGB *mPrevious;                ///< the previous frame
+    CRGB *mGather;                  ///< the controllers' leds gathered into one frame, when there are several
+    uint32_t *mIndex;               ///< the offsets of the keyframes
+    uint32_t mIndexCapacity;        ///< the number of offsets mIndex has room for
+    uint32_t mOffset;               ///< the number of bytes written
+    uint32_t mFrames;               ///< the number of frames recorded
+    bool mStarted;                  ///< whether the header has been written, and the stream isn't finished
+    bool mFailed;                   ///< whether a write or an allocation failed
+
+    /// Write data to the stream, keeping track of the offset
+    bool write(const uint8_t *data, uint32_t size);
+    /// Write the first byte(s) of an op
+    bool writeOp(uint8_t op, uint16_t count);
+    /// Write the ops for a frame
+    bool encode(const CRGB *leds, const CRGB *previous);
+    /// Get the number of leds in all of the controllers that are recorded
+    static uint16_t countControllerLeds();
+    /// Free the buffers
+    void release();
+
+public:
+    /// Create a recorder
+    /// @param writer where to write the stream
+    /// @param keyInterval the number of frames from one keyframe to the next
+    CFrameRecorder(CFrameStreamWriter & writer, uint16_t keyInterval = FRAME_STREAM_KEYFRAME_INTERVAL)
+        : mWriter(writer), mLeds(NULL), mCount(0), mNumLeds(0), mKeyInterval(keyInterval ? keyInterval : 1), mPrevious(NULL), mGather(NULL),
+          mIndex(NULL), mIndexCapacity(0), mOffset(0), mFrames(0), mStarted(false), mFailed(false) {}
+    ~CFrameRecorder() { release(); }
+
+    /// Record an array of leds, instead of the controllers' leds.  Call this before begin().
+    /// @param leds the leds, or NULL to go back to recording the controllers
+    /// @param count the number of leds
+    void setLeds(const CRGB *leds, uint16_t count) { mLeds = leds; mCount = count; }
+
+    /// Start a new stream, writing its header.  The number of leds in each frame is fixed
+    /// from here on, to the ones set with setLeds() or else to all of the controllers' leds.
+    /// @param frameRate the frame rate to record in the header for playback, or 0 if there isn't one
+    /// @returns false if there are no leds, the buffers couldn't be allocated, or the header couldn't be written
+    bool begin(uint16_t frameRate = 0);
+
+    /// Record a frame.  FastLED.show() calls this when the recorder has been set with
+    /// FastLED.setRecorder().  Starts the stream, with no frame rate, if begin() hasn't been called.
+    /// @param brightness the brightness the frame is shown at
+    /// @returns false if the stream is finished, or couldn't be written
+    bool recordFrame(uint8_t brightness = 255);
+
+    /// Finish the stream, writing the index and trailer, and free the buffers.  Frames
+    /// recorded after this are ignored, until begin() is called again.
+    /// @returns false if the stream couldn't be written
+    bool finish();
+
+    /// Get the number of frames recorded
+    uint32_t getFrames() const { return mFrames; }
+
+    /// Get the number of bytes written to the stream so far
+    uint32_t getBytesWritten() const { return mOffset; }
+};
+
+/// Plays back a stream recorded with CFrameRecorder, into the leds of all of the controllers
+/// (or an array of leds given with setLeds()).  Frames are decoded straight from the reader
+/// into the leds, so the ram used doesn't depend on the size of the frames.  Since frames
+/// only hold the leds that changed, the sketch mustn't change the leds between frames.
+///
+///     CMemoryFrameReader reader(show, sizeof(show), true);
+///     CFramePlayer player(reader);
+///
+///     void render(uint32_t frame) {
+///         if(!player.readFrame()) { player.seek(0); player.readFrame(); }
+///     }
+///     CFrameScheduler scheduler(render);
+///
+///     void setup() {
+///         FastLED.addLeds<WS2812, 6, GRB>(leds, NUM_LEDS);
+///         player.begin();
+///         scheduler.setFrameRate(player.getFrameRate());
+///     }
+///
+///     void loop() { scheduler.run(); }
+class CFramePlayer {
+    CFrameStreamReader & mReader;     ///< where the stream comes from
+    CRGB *mLeds;                      ///< the leds to play into, or NULL for all of the controllers'
+    uint16_t mCount;                  ///< the number of leds in mLeds
+    uint16_t mNumLeds;                ///< the number of leds in each frame of the stream
+    uint16_t mFrameRate;              ///< the frame rate from the header
+    uint16_t mKeyInterval;            ///< the number of frames from one keyframe to the next
+    uint32_t mFrameCount;             ///< the number of frames in the stream, or 0xFFFFFFFF if it wasn't finished
+    uint32_t mIndexOffset;            ///< the offset of the keyframe index, or 0 if there isn't one
+    uint32_t mFrame;                  ///< the number of the next frame
+    uint8_t mBrightness;              ///< the brightness of the last frame
+    bool mValid;                      ///< whether the stream has a valid header
+    CRGB *mSpan;                      ///< the leds the next decoded leds go to
+    uint16_t mSpanLeft;               ///< the number of leds left in mSpan
+    CLEDController *mNextController;  ///< the controller whose leds follow mSpan
+
+    /// Move mSpan to the next controller's leds
+    bool nextSpan();
+    /// Decode the next frame in the stream into the leds
+    bool decodeFrame();
+
+public:
+    /// Create a player
+    /// @param reader where to read the stream from
+    CFramePlayer(CFrameStreamReader & reader)
+        : mReader(reader), mLeds(NULL), mCount(0), mNumLeds(0), mFrameRate(0), mKeyInterval(1), mFrameCount(0), mIndexOffset(0),
+          mFrame(0), mBrightness(255), mValid(false), mSpan(NULL), mSpanLeft(0), mNextController(NULL) {}
+
+    /// Play into an array of leds, instead of the controllers' leds.  Leds in the stream
+    /// past the end of the array are dropped, and leds in the array past the end of the
+    /// stream are left alone.
+    /// @param leds the leds, or NULL to go back to playing into the controllers
+    /// @param count the number of leds
+    void setLeds(CRGB *leds, uint16_t count) { mLeds = leds; mCount = count; }
+
+    /// Read the header (and trailer) of the stream, and go to its first frame
+    /// @returns false if it isn't a stream that can be played
+    bool begin();
+
+    /// Decode the next frame into the leds, without showing it
+    /// @returns false at the end of the stream, or if it's corrupt
+    bool readFrame();
+
+    /// Decode the next frame into the leds, and show it with FastLED.show() at the brightness
+    /// it was recorded at
+    /// @returns false at the end of the stream, or if it's corrupt
+    bool showFrame();
+
+    /// Go to a frame, so that the next readFrame() reads it.  Unless it's a keyframe, the leds
+    /// are left holding the frame before it.
+    /// @param frame the frame, from 0 to getFrameCount()
+    /// @returns false if the frame isn't in the stream
+    bool seek(uint32_t frame);
+
+    /// Get the number of the next frame to be read
+    uint32_t getFrame() const { return mFrame; }
+
+    /// Get the number of frames in the stream
+    /// @returns the count, or 0xFFFFFFFF if the stream wasn't finished and the count isn't known
+    uint32_t getFrameCount() const { return mFrameCount; }
+
+    /// Get the frame rate the stream was recorded with
+    /// @returns the frame rate, or 0 if it wasn't given
+    uint16_t getFrameRate() const { return mFrameRate; }
+
+    /// Get the number of leds in each frame of the stream
+    uint16_t getNumLeds() const { return mNumLeds; }
+
+    /// Get the brightness the last frame read was recorded with
+    uint8_t getBrightness() const { return mBrightness; }
+};
+
+/// @} FrameStream
+
+FASTLED_NAMESPACE_END
+
+#endif
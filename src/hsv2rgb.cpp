@@ -470,19 +470,212 @@ void hsv2rgb_rainbow( const CHSV& hsv, CRGB& rgb)
 }
 
 
+#if !defined(__AVR__)
+// The array conversions run a branch-free version of the per-pixel math, so that the
+// hue sections and the saturation/value special cases don't cost a mispredicted branch
+// per pixel, and the compiler is free to pipeline (or vectorize) the loop.  The results
+// are bit-identical to the single pixel functions.  8 bit AVRs keep the per-pixel loops,
+// which use the hand written assembly, and would have to read the hue table from PROGMEM.
+#define HSV2RGB_BATCH 1
+#else
+#define HSV2RGB_BATCH 0
+#endif
+
+#if HSV2RGB_BATCH == 1
+/// Number of pixels converted at a time by the batch conversions
+#define HSV2RGB_BLOCK 64
+/// Arrays shorter than this are converted a pixel at a time, since setting up the batch costs
+/// more than it saves on them (at 8 leds, the batch hsv2rgb_spectrum() took 1.6x as long on x86-64)
+#define HSV2RGB_MIN_BATCH 16
+
+/// @cond
+// hsv2rgb_rainbow() of a fully saturated, full brightness hue, worked out by the compiler,
+// with hsv2rgb_rainbow()'s default yellow boost (Y1)
+#if (FASTLED_SCALE8_FIXED == 1)
+#define RAINBOW_SCALE8(i, scale) (((i) * (1 + (scale))) >> 8)
+#else
+#define RAINBOW_SCALE8(i, scale) (((i) * (scale)) >> 8)
+#endif
+#define RAINBOW_T(h) RAINBOW_SCALE8(((h) & 0x1F) << 3, 256 / 3)
+#define RAINBOW_TT(h) RAINBOW_SCALE8(((h) & 0x1F) << 3, (256 * 2) / 3)
+#define RAINBOW_R(h) ((h) < 32 ? K255 - RAINBOW_T(h) : (h) < 64 ? K171 : (h) < 96 ? K171 - RAINBOW_TT(h) : \
+                      (h) < 160 ? 0 : (h) < 192 ? RAINBOW_T(h) : (h) < 224 ? K85 + RAINBOW_T(h) : K170 + RAINBOW_T(h))
+#define RAINBOW_G(h) ((h) < 32 ? RAINBOW_T(h) : (h) < 64 ? K85 + RAINBOW_T(h) : (h) < 96 ? K170 + RAINBOW_T(h) : \
+                      (h) < 128 ? K255 - RAINBOW_T(h) : (h) < 160 ? K171 - RAINBOW_TT(h) : 0)
+#define RAINBOW_B(h) ((h) < 96 ? 0 : (h) < 128 ? RAINBOW_T(h) : (h) < 160 ? K85 + RAINBOW_TT(h) : \
+                      (h) < 192 ? K255 - RAINBOW_T(h) : (h) < 224 ? K171 - RAINBOW_T(h) : K85 - RAINBOW_T(h))
+#define RAINBOW_HUE(h) { RAINBOW_R(h), RAINBOW_G(h), RAINBOW_B(h) }
+#define RAINBOW_HUES4(h) RAINBOW_HUE(h), RAINBOW_HUE((h) + 1), RAINBOW_HUE((h) + 2), RAINBOW_HUE((h) + 3)
+#define RAINBOW_HUES16(h) RAINBOW_HUES4(h), RAINBOW_HUES4((h) + 4), RAINBOW_HUES4((h) + 8), RAINBOW_HUES4((h) + 12)
+#define RAINBOW_HUES64(h) RAINBOW_HUES16(h), RAINBOW_HUES16((h) + 16), RAINBOW_HUES16((h) + 32), RAINBOW_HUES16((h) + 48)
+/// @endcond
+
+/// Fully saturated, full brightness rainbow colors for every hue, r, g and b.  Being const,
+/// it's kept in flash rather than ram.
+static const uint8_t gRainbowHues[256][3] = {
+    RAINBOW_HUES64(0), RAINBOW_HUES64(64), RAINBOW_HUES64(128), RAINBOW_HUES64(192)
+};
+
+#undef RAINBOW_SCALE8
+#undef RAINBOW_T
+#undef RAINBOW_TT
+#undef RAINBOW_R
+#undef RAINBOW_G
+#undef RAINBOW_B
+#undef RAINBOW_HUE
+#undef RAINBOW_HUES4
+#undef RAINBOW_HUES16
+#undef RAINBOW_HUES64
+
+/// Batch version of hsv2rgb_raw_C(), for hues 0-191
+/// @tparam SPECTRUM whether to rescale the hues from 0-255 to 0-191 first, as hsv2rgb_spectrum() does
+/// @param phsv the colors to convert
+/// @param prgb where to put the converted colors
+/// @param numLeds the number of colors
+template<bool SPECTRUM>
+static void hsv2rgb_raw_batch( const struct CHSV * phsv, struct CRGB * prgb, int numLeds)
+{
+    // The math runs over a block at a time, in arrays of its own, which lets the compiler
+    // vectorize it.  It stops at the end of a short block, so that short arrays only pay
+    // for the pixels they have.
+    uint8_t hue[HSV2RGB_BLOCK], sat[HSV2RGB_BLOCK], val[HSV2RGB_BLOCK];
+    uint8_t r[HSV2RGB_BLOCK], g[HSV2RGB_BLOCK], b[HSV2RGB_BLOCK];
+
+    while( numLeds > 0) {
+        int count = (numLeds < HSV2RGB_BLOCK) ? numLeds : HSV2RGB_BLOCK;
+
+        for( int i = 0; i < count; ++i) {
+            hue[i] = phsv[i].hue;
+            sat[i] = phsv[i].sat;
+            val[i] = phsv[i].val;
+        }
+        for( int i = 0; i < count; ++i) {
+            uint8_t h = SPECTRUM ? scale8( hue[i], 191) : hue[i];
+            uint8_t brightness_floor = ((uint16_t)val[i] * (uint8_t)(255 - sat[i])) >> 8;
+            uint8_t color_amplitude = val[i] - brightness_floor;
+            uint8_t offset = h & (HSV_SECTION_3 - 1);
+            uint8_t rampup = (((uint16_t)offset * color_amplitude) >> 6) + brightness_floor;
+            uint8_t rampdown = (((uint16_t)((HSV_SECTION_3 - 1) - offset) * color_amplitude) >> 6) + brightness_floor;
+
+            // sections 2 and 3 are treated the same, as in hsv2rgb_raw_C()
+            uint8_t section = h >> 6;
+            r[i] = (section == 0) ? rampdown : ((section == 1) ? brightness_floor : rampup);
+            g[i] = (section == 0) ? rampup : ((section == 1) ? rampdown : brightness_floor);
+            b[i] = (section == 0) ? brightness_floor : ((section == 1) ? rampup : rampdown);
+        }
+
+        for( int i = 0; i < count; ++i) {
+            prgb[i].r = r[i];
+            prgb[i].g = g[i];
+            prgb[i].b = b[i];
+        }
+
+        phsv += count;
+        prgb += count;
+        numLeds -= count;
+    }
+}
+
+/// Scale a channel of hsv2rgb_rainbow() for saturation and value, without branching
+/// @param c the fully saturated, full brightness channel value
+/// @param desat the brightness floor for the saturation
+/// @param dimval the dimmed value
+/// @param sat the saturation
+/// @param val the value
+/// @returns the scaled channel value
+LIB8STATIC_ALWAYS_INLINE uint8_t rainbow_scale_channel( uint8_t c, uint8_t desat, uint8_t dimval, uint8_t sat, uint8_t val)
+{
+    // With sat == 255 and val == 255, the scaling leaves the channel as it is, so those
+    // don't need special casing.  sat == 0 and val == 0 only need it for the unfixed scale8.
+#if (FASTLED_SCALE8_FIXED == 1)
+    (void)sat; (void)val;
+    uint8_t x = (((uint16_t)c * (uint16_t)(256 - desat)) >> 8) + desat;
+    return ((uint16_t)x * (dimval + 1)) >> 8;
+#else
+    uint8_t x = (((uint16_t)c * (uint8_t)(255 - desat)) >> 8) + (c ? 1 : 0) + desat;
+    x = sat ? x : 255;
+    x = (((uint16_t)x * dimval) >> 8) + (x ? 1 : 0);
+    return val ? x : 0;
+#endif
+}
+
+/// Batch version of hsv2rgb_rainbow(), which looks the fully saturated colors up in a table
+/// and then applies the saturation and value scaling to a block of them at a time
+/// @param phsv the colors to convert
+/// @param prgb where to put the converted colors
+/// @param numLeds the number of colors
+static void hsv2rgb_rainbow_batch( const struct CHSV * phsv, struct CRGB * prgb, int numLeds)
+{
+    // as in hsv2rgb_raw_batch(), the math runs over a block at a time
+    uint8_t sat[HSV2RGB_BLOCK], val[HSV2RGB_BLOCK];
+    uint8_t r[HSV2RGB_BLOCK], g[HSV2RGB_BLOCK], b[HSV2RGB_BLOCK];
+
+    while( numLeds > 0) {
+        int count = (numLeds < HSV2RGB_BLOCK) ? numLeds : HSV2RGB_BLOCK;
+
+        for( int i = 0; i < count; ++i) {
+            const uint8_t *rgb = gRainbowHues[phsv[i].hue];
+            r[i] = rgb[0];
+            g[i] = rgb[1];
+            b[i] = rgb[2];
+            sat[i] = phsv[i].sat;
+            val[i] = phsv[i].val;
+        }
+
+        for( int i = 0; i < count; ++i) {
+            uint8_t invsat = 255 - sat[i];
+            // scale8_video( x, x)
+            uint8_t desat = (((uint16_t)invsat * invsat) >> 8) + (invsat ? 1 : 0);
+            uint8_t dimval = (((uint16_t)val[i] * val[i]) >> 8) + (val[i] ? 1 : 0);
+            r[i] = rainbow_scale_channel( r[i], desat, dimval, sat[i], val[i]);
+            g[i] = rainbow_scale_channel( g[i], desat, dimval, sat[i], val[i]);
+            b[i] = rainbow_scale_channel( b[i], desat, dimval, sat[i], val[i]);
+        }
+
+        for( int i = 0; i < count; ++i) {
+            prgb[i].r = r[i];
+            prgb[i].g = g[i];
+            prgb[i].b = b[i];
+        }
+
+        phsv += count;
+        prgb += count;
+        numLeds -= count;
+    }
+}
+#endif
+
 void hsv2rgb_raw(const struct CHSV * phsv, struct CRGB * prgb, int numLeds) {
+#if HSV2RGB_BATCH == 1
+    if( numLeds >= HSV2RGB_MIN_BATCH) {
+        hsv2rgb_raw_batch<false>(phsv, prgb, numLeds);
+        return;
+    }
+#endif
     for(int i = 0; i < numLeds; ++i) {
         hsv2rgb_raw(phsv[i], prgb[i]);
     }
 }
 
 void hsv2rgb_rainbow( const struct CHSV* phsv, struct CRGB * prgb, int numLeds) {
+#if HSV2RGB_BATCH == 1
+    if( numLeds >= HSV2RGB_MIN_BATCH) {
+        hsv2rgb_rainbow_batch(phsv, prgb, numLeds);
+        return;
+    }
+#endif
     for(int i = 0; i < numLeds; ++i) {
         hsv2rgb_rainbow(phsv[i], prgb[i]);
     }
 }
 
 void hsv2rgb_spectrum( const struct CHSV* phsv, struct CRGB * prgb, int numLeds) {
+#if HSV2RGB_BATCH == 1
+    if( numLeds >= HSV2RGB_MIN_BATCH) {
+        hsv2rgb_raw_batch<true>(phsv, prgb, numLeds);
+        return;
+    }
+#endif
     for(int i = 0; i < numLeds; ++i) {
         hsv2rgb_spectrum(phsv[i], prgb[i]);
     }
@@ -75,6 +75,8 @@ void hsv2rgb_rainbow( const struct CHSV& hsv, struct CRGB& rgb);
 /// @param phsv CHSV array to convert to RGB. Max hue supported is HUE_MAX_RAINBOW
 /// @param prgb CRGB array to store the result of the conversion (will be modified)
 /// @param numLeds the number of array values to process
+/// @note Converts a block of pixels at a time (except on AVR), which is much faster than
+/// converting them one by one, with the same results
 void hsv2rgb_rainbow( const struct CHSV* phsv, struct CRGB * prgb, int numLeds);
 
 /// Max hue accepted for the hsv2rgb_rainbow() function
@@ -99,6 +101,8 @@ void hsv2rgb_spectrum( const struct CHSV& hsv, struct CRGB& rgb);
 /// @param phsv CHSV array to convert to RGB. Max hue supported is HUE_MAX_SPECTRUM
 /// @param prgb CRGB array to store the result of the conversion (will be modified)
 /// @param numLeds the number of array values to process
+/// @note Converts a block of pixels at a time (except on AVR), which is much faster than
+/// converting them one by one, with the same results
 void hsv2rgb_spectrum( const struct CHSV* phsv, struct CRGB * prgb, int numLeds);
 
 /// Max hue accepted for the hsv2rgb_spectrum() function
@@ -48,6 +48,9 @@
 #include "platforms/apollo3/led_sysdefs_apollo3.h"
 #elif defined(ARDUINO_ARCH_RENESAS) || defined(ARDUINO_ARCH_RENESAS_UNO) || defined(ARDUINO_ARCH_RENESAS_PORTENTA)
 #include "platforms/arm/renesas/led_sysdef_arm_renesas.h"
+#elif defined(FASTLED_HOST) || ((defined(__linux__) || defined(__APPLE__)) && !defined(ARDUINO))
+// Native desktop build, for testing and profiling off-target
+#include "platforms/host/led_sysdefs_host.h"
 #else
 //
 // We got here because we don't recognize the platform that you're
@@ -788,7 +788,8 @@ void fill_noise16(CRGB *leds, int num_leds,
     }
 }
 
-void fill_2dnoise8(CRGB *leds, int width, int height, bool serpentine,
+/// fill_2dnoise8(), writing each pixel through the xymap table if there is one
+static void fill_2dnoise8_mapped(CRGB *leds, int width, int height, bool serpentine, const uint16_t *xymap,
             uint8_t octaves, uint16_t x, int xscale, uint16_t y, int yscale, uint16_t time,
             uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time,bool blend) {
   uint8_t V[height][width];
@@ -804,24 +805,31 @@ void fill_2dnoise8(CRGB *leds, int width, int height, bool serpentine,
   int h1 = height-1;
   for(int i = 0; i < height; ++i) {
     int wb = i*width;
+    const uint16_t *rowmap = xymap ? xymap + wb : NULL;
     for(int j = 0; j < width; ++j) {
       CRGB led(CHSV(H[h1-i][w1-j],255,V[i][j]));
 
-      int pos = j;
-      if(serpentine && (i & 0x1)) {
-        pos = w1-j;
+      int pos;
+      if(rowmap) {
+        pos = rowmap[j];
+      } else {
+        pos = wb + j;
+        if(serpentine && (i & 0x1)) {
+          pos = wb + w1-j;
+        }
       }
 
       if(blend) {
-        leds[wb+pos] >>= 1; leds[wb+pos] += (led>>=1);
+        leds[pos] >>= 1; leds[pos] += (led>>=1);
       } else {
-        leds[wb+pos] = led;
+        leds[pos] = led;
       }
     }
   }
 }
 
-void fill_2dnoise16(CRGB *leds, int width, int height, bool serpentine,
+/// fill_2dnoise16(), writing each pixel through the xymap table if there is one
+static void fill_2dnoise16_mapped(CRGB *leds, int width, int height, bool serpentine, const uint16_t *xymap,
             uint8_t octaves, uint32_t x, int xscale, uint32_t y, int yscale, uint32_t time,
             uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time, bool blend, uint16_t hue_shift) {
   uint8_t V[height][width];
@@ -842,23 +850,57 @@ void fill_2dnoise16(CRGB *leds, int width, int height, bool serpentine,
 
   for(int i = 0; i < height; ++i) {
     int wb = i*width;
+    const uint16_t *rowmap = xymap ? xymap + wb : NULL;
     for(int j = 0; j < width; ++j) {
       CRGB led(CHSV(hue_shift + (H[h1-i][w1-j]),196,V[i][j]));
 
-      int pos = j;
-      if(serpentine && (i & 0x1)) {
-        pos = w1-j;
+      int pos;
+      if(rowmap) {
+        pos = rowmap[j];
+      } else {
+        pos = wb + j;
+        if(serpentine && (i & 0x1)) {
+          pos = wb + w1-j;
+        }
       }
 
       if(blend) {
-        leds[wb+pos] >>= 1; leds[wb+pos] += (led>>=1);
+        leds[pos] >>= 1; leds[pos] += (led>>=1);
       } else {
-        leds[wb+pos] = led;
+        leds[pos] = led;
       }
     }
   }
 }
 
+void fill_2dnoise8(CRGB *leds, int width, int height, bool serpentine,
+            uint8_t octaves, uint16_t x, int xscale, uint16_t y, int yscale, uint16_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time,bool blend) {
+  fill_2dnoise8_mapped(leds, width, height, serpentine, NULL, octaves, x, xscale, y, yscale, time,
+                       hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend);
+}
+
+void fill_2dnoise8(CRGB *leds, const XYMap &xymap,
+            uint8_t octaves, uint16_t x, int xscale, uint16_t y, int yscale, uint16_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time,bool blend) {
+  fill_2dnoise8_mapped(leds, xymap.getWidth(), xymap.getHeight(), false, xymap.getTable(), octaves, x, xscale, y, yscale, time,
+                       hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend);
+}
+
+void fill_2dnoise16(CRGB *leds, int width, int height, bool serpentine,
+            uint8_t octaves, uint32_t x, int xscale, uint32_t y, int yscale, uint32_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time, bool blend, uint16_t hue_shift) {
+  fill_2dnoise16_mapped(leds, width, height, serpentine, NULL, octaves, x, xscale, y, yscale, time,
+                        hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend, hue_shift);
+}
+
+void fill_2dnoise16(CRGB *leds, const XYMap &xymap,
+            uint8_t octaves, uint32_t x, int xscale, uint32_t y, int yscale, uint32_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time, bool blend, uint16_t hue_shift) {
+  fill_2dnoise16_mapped(leds, xymap.getWidth(), xymap.getHeight(), false, xymap.getTable(), octaves, x, xscale, y, yscale, time,
+                        hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend, hue_shift);
+}
+
 FASTLED_NAMESPACE_END
 
 #pragma GCC diagnostic pop
@@ -218,6 +218,20 @@ void fill_2dnoise16(CRGB *leds, int width, int height, bool serpentine,
             uint8_t octaves, uint32_t x, int xscale, uint32_t y, int yscale, uint32_t time,
             uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time, bool blend, uint16_t hue_shift=0);
 
+/// Fill an LED matrix laid out by an XYMap with random colors, using 8-bit noise
+/// @copydetails fill_2dnoise8()
+/// @param xymap the layout of the matrix, which also gives its width and height
+void fill_2dnoise8(CRGB *leds, const XYMap &xymap,
+            uint8_t octaves, uint16_t x, int xscale, uint16_t y, int yscale, uint16_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time,bool blend);
+
+/// Fill an LED matrix laid out by an XYMap with random colors, using 16-bit noise
+/// @copydetails fill_2dnoise16()
+/// @param xymap the layout of the matrix, which also gives its width and height
+void fill_2dnoise16(CRGB *leds, const XYMap &xymap,
+            uint8_t octaves, uint32_t x, int xscale, uint32_t y, int yscale, uint32_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time, bool blend, uint16_t hue_shift=0);
+
 /// @} Fill Functions
 
 /// @} NoiseFill
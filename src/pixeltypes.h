@@ -946,6 +946,277 @@ inline CRGB operator%( const CRGB& p1, uint8_t d)
 
 
 
+/// Representation of an RGB pixel with 16 bits per channel (Red, Green, Blue).  Use this
+/// in place of CRGB for a high dynamic range framebuffer: long, slow fades and low brightness
+/// gradients keep their precision, and the controller quantizes to 8 bits on output with
+/// temporal error diffusion (see CLEDController::setLeds(CRGB16*, int)).
+/// The arithmetic mirrors CRGB, with 16 bit saturating math and 16 bit (fract16) scale factors.
+struct CRGB16 {
+    union {
+        struct {
+            union {
+                uint16_t r;    ///< Red channel value
+                uint16_t red;  ///< @copydoc r
+            };
+            union {
+                uint16_t g;      ///< Green channel value
+                uint16_t green;  ///< @copydoc g
+            };
+            union {
+                uint16_t b;     ///< Blue channel value
+                uint16_t blue;  ///< @copydoc b
+            };
+        };
+        /// Access the red, green, and blue data as an array
+        uint16_t raw[3];
+    };
+
+    /// Array access operator to index into the CRGB16 object
+    /// @param x the index to retrieve (0-2)
+    /// @returns the CRGB16::raw value for the given index
+    inline uint16_t& operator[] (uint8_t x) __attribute__((always_inline))
+    {
+        return raw[x];
+    }
+
+    /// @copydoc operator[]
+    inline const uint16_t& operator[] (uint8_t x) const __attribute__((always_inline))
+    {
+        return raw[x];
+    }
+
+    /// Default constructor
+    /// @warning Default values are UNITIALIZED!
+    inline CRGB16() __attribute__((always_inline)) = default;
+
+    /// Allow construction from red, green, and blue
+    /// @param ir input red value
+    /// @param ig input green value
+    /// @param ib input blue value
+    constexpr CRGB16(uint16_t ir, uint16_t ig, uint16_t ib)  __attribute__((always_inline))
+        : r(ir), g(ig), b(ib)
+    {
+    }
+
+    /// Allow construction from an 8 bit per channel CRGB.  Each channel is expanded
+    /// to the full 16 bit range, so 0xFF becomes 0xFFFF.
+    constexpr CRGB16(const CRGB& rhs) __attribute__((always_inline))
+        : r(rhs.r * 0x0101), g(rhs.g * 0x0101), b(rhs.b * 0x0101)
+    {
+    }
+
+    /// Allow construction from 32-bit (really 24-bit) bit 0xRRGGBB color code
+    /// @param colorcode a packed 24 bit color code
+    constexpr CRGB16(uint32_t colorcode)  __attribute__((always_inline))
+        : r(((colorcode >> 16) & 0xFF) * 0x0101), g(((colorcode >> 8) & 0xFF) * 0x0101), b((colorcode & 0xFF) * 0x0101)
+    {
+    }
+
+    /// Allow construction from a CHSV color
+    inline CRGB16(const CHSV& rhs) __attribute__((always_inline))
+    {
+        *this = CRGB16(CRGB(rhs));
+    }
+
+    /// Allow assignment from red, green, and blue
+    /// @param nr new red value
+    /// @param ng new green value
+    /// @param nb new blue value
+    inline CRGB16& setRGB (uint16_t nr, uint16_t ng, uint16_t nb) __attribute__((always_inline))
+    {
+        r = nr;
+        g = ng;
+        b = nb;
+        return *this;
+    }
+
+    /// Get the 8 bit per channel color, dropping the low byte of each channel.
+    /// @note Controllers don't use this, they diffuse the low bytes over time instead
+    inline CRGB toCRGB() const __attribute__((always_inline))
+    {
+        return CRGB(r >> 8, g >> 8, b >> 8);
+    }
+
+    /// Add one CRGB16 to another, saturating at 0xFFFF for each channel
+    inline CRGB16& operator+= (const CRGB16& rhs )
+    {
+        r = qadd16(r, rhs.r);
+        g = qadd16(g, rhs.g);
+        b = qadd16(b, rhs.b);
+        return *this;
+    }
+
+    /// Add a constant to each channel, saturating at 0xFFFF
+    inline CRGB16& addToRGB (uint16_t d )
+    {
+        r = qadd16(r, d);
+        g = qadd16(g, d);
+        b = qadd16(b, d);
+        return *this;
+    }
+
+    /// Subtract one CRGB16 from another, saturating at 0x0000 for each channel
+    inline CRGB16& operator-= (const CRGB16& rhs )
+    {
+        r = qsub16(r, rhs.r);
+        g = qsub16(g, rhs.g);
+        b = qsub16(b, rhs.b);
+        return *this;
+    }
+
+    /// Subtract a constant from each channel, saturating at 0x0000
+    inline CRGB16& subtractFromRGB(uint16_t d )
+    {
+        r = qsub16(r, d);
+        g = qsub16(g, d);
+        b = qsub16(b, d);
+        return *this;
+    }
+
+    /// Divide each of the channels by a constant
+    inline CRGB16& operator/= (uint8_t d )
+    {
+        r /= d;
+        g /= d;
+        b /= d;
+        return *this;
+    }
+
+    /// Right shift each of the channels by a constant
+    inline CRGB16& operator>>= (uint8_t d)
+    {
+        r >>= d;
+        g >>= d;
+        b >>= d;
+        return *this;
+    }
+
+    /// Multiply each of the channels by a constant, saturating each channel at 0xFFFF
+    inline CRGB16& operator*= (uint8_t d )
+    {
+        r = qmul16(r, d);
+        g = qmul16(g, d);
+        b = qmul16(b, d);
+        return *this;
+    }
+
+    /// Scale down a RGB to N/65536ths of its current brightness, using
+    /// "plain math" dimming rules.
+    /// @see ::scale16
+    inline CRGB16& nscale16 (fract16 scaledown )
+    {
+        r = scale16(r, scaledown);
+        g = scale16(g, scaledown);
+        b = scale16(b, scaledown);
+        return *this;
+    }
+
+    /// Scale down a RGB to N/256ths of its current brightness, using
+    /// "plain math" dimming rules.
+    /// @see ::scale16by8
+    inline CRGB16& nscale8 (uint8_t scaledown )
+    {
+        r = scale16by8(r, scaledown);
+        g = scale16by8(g, scaledown);
+        b = scale16by8(b, scaledown);
+        return *this;
+    }
+
+    /// fadeToBlackBy is a synonym for nscale16(), as a fade instead of a scale
+    /// @param fadefactor the amount to fade, sent to nscale16() as (65535 - fadefactor)
+    inline CRGB16& fadeToBlackBy (fract16 fadefactor )
+    {
+        return nscale16(65535 - fadefactor);
+    }
+
+    /// Return a new CRGB16 object after performing a linear interpolation between this object and the passed in object
+    /// @param other the color to interpolate towards
+    /// @param frac how far to go towards other, in 65536ths
+    inline CRGB16 lerp16 (const CRGB16& other, fract16 frac) const
+    {
+        return CRGB16(lerp16by16(r, other.r, frac), lerp16by16(g, other.g, frac), lerp16by16(b, other.b, frac));
+    }
+
+    /// "or" operator brings each channel up to the higher of the two values
+    inline CRGB16& operator|= (const CRGB16& rhs )
+    {
+        if( rhs.r > r) r = rhs.r;
+        if( rhs.g > g) g = rhs.g;
+        if( rhs.b > b) b = rhs.b;
+        return *this;
+    }
+
+    /// "and" operator brings each channel down to the lower of the two values
+    inline CRGB16& operator&= (const CRGB16& rhs )
+    {
+        if( rhs.r < r) r = rhs.r;
+        if( rhs.g < g) g = rhs.g;
+        if( rhs.b < b) b = rhs.b;
+        return *this;
+    }
+
+    /// This allows testing a CRGB16 for zero-ness
+    inline explicit operator bool() const __attribute__((always_inline))
+    {
+        return r || g || b;
+    }
+
+    /// Get the average of the R, G, and B values
+    inline uint16_t getAverageLight( ) const {
+        return ((uint32_t)r + g + b) / 3;
+    }
+
+private:
+    /// Add two 16 bit values, saturating at 0xFFFF
+    static inline uint16_t qadd16(uint16_t i, uint16_t j) __attribute__((always_inline))
+    {
+        uint32_t t = (uint32_t)i + j;
+        return (t > 0xFFFF) ? 0xFFFF : t;
+    }
+
+    /// Subtract two 16 bit values, saturating at 0x0000
+    static inline uint16_t qsub16(uint16_t i, uint16_t j) __attribute__((always_inline))
+    {
+        return (i > j) ? (i - j) : 0;
+    }
+
+    /// Multiply a 16 bit value by an 8 bit one, saturating at 0xFFFF
+    static inline uint16_t qmul16(uint16_t i, uint8_t j) __attribute__((always_inline))
+    {
+        uint32_t t = (uint32_t)i * j;
+        return (t > 0xFFFF) ? 0xFFFF : t;
+    }
+};
+
+/// Check if two CRGB16 objects have the same color data
+inline __attribute__((always_inline)) bool operator== (const CRGB16& lhs, const CRGB16& rhs)
+{
+    return (lhs.r == rhs.r) && (lhs.g == rhs.g) && (lhs.b == rhs.b);
+}
+
+/// Check if two CRGB16 objects do *not* have the same color data
+inline __attribute__((always_inline)) bool operator!= (const CRGB16& lhs, const CRGB16& rhs)
+{
+    return !(lhs == rhs);
+}
+
+/// @copydoc CRGB16::operator+=
+inline CRGB16 operator+( const CRGB16& p1, const CRGB16& p2)
+{
+    CRGB16 retval(p1);
+    retval += p2;
+    return retval;
+}
+
+/// @copydoc CRGB16::operator-=
+inline CRGB16 operator-( const CRGB16& p1, const CRGB16& p2)
+{
+    CRGB16 retval(p1);
+    retval -= p2;
+    return retval;
+}
+
+
 /// RGB color channel orderings, used when instantiating controllers to determine
 /// what order the controller should send data out in. The default ordering
 /// is RGB.
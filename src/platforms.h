@@ -44,6 +44,8 @@
 #include "platforms/apollo3/fastled_apollo3.h"
 #elif defined(ARDUINO_ARCH_RENESAS) || defined(ARDUINO_ARCH_RENESAS_UNO) || defined(ARDUINO_ARCH_RENESAS_PORTENTA)
 #include "platforms/arm/renesas/fastled_arm_renesas.h"
+#elif defined(FASTLED_HOST)
+#include "platforms/host/fastled_host.h"
 #else
 // AVR platforms
 #include "platforms/avr/fastled_avr.h"
@@ -26,6 +26,9 @@ public:
         pSmartMatrix = &matrix;
     }
 
+    // the matrix is handed the led array itself
+    virtual bool showsPixels16() { return false; }
+
     virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
         if(SMART_MATRIX_CAN_TRIPLE_BUFFER) {
             rgb24 *md = matrix.getRealBackBuffer();
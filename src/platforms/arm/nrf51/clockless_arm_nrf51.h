@@ -36,6 +36,9 @@ public:
 
 	virtual uint16_t getMaxRefreshRate() const { return 400; }
 
+	// showLedData reads the led bytes itself
+	virtual bool showsPixels16() { return false; }
+
     virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
         mWait.wait();
         cli();
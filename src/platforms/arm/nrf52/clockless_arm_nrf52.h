@@ -3,12 +3,33 @@
 
 #if defined(NRF52_SERIES)
 
+#include <new>
+#include "clockless_pwm_encode.h"
 
 //FASTLED_NAMESPACE_BEGIN
 
 #define FASTLED_HAS_CLOCKLESS 1
 #define FASTLED_NRF52_MAXIMUM_PIXELS_PER_STRING 144 // TODO: Figure out how to safely let this be calller-defined....
 
+// Define FASTLED_NRF52_STREAMING as 1 to send the pixels through two small
+// sequence buffers instead: the PWM plays SEQ[0] and SEQ[1] in turn, and the
+// isr refills each one from the pixel data when it ends. RAM use is then the
+// same whatever the strip length, and FASTLED_NRF52_MAXIMUM_PIXELS_PER_STRING
+// no longer applies.  The pixel data is read while it is being sent, so a
+// show doesn't return until it's done (or, with async show, the leds mustn't
+// change until waitForShowComplete()).
+#ifndef FASTLED_NRF52_STREAMING
+#define FASTLED_NRF52_STREAMING 0
+#endif
+
+// Pixels in each of the two streaming sequence buffers.  The isr has the time
+// it takes to send one buffer (30us per pixel at 800kHz) to refill the other,
+// so this needs to cover the longest the softdevice can hold off the PWM
+// interrupt (BLE events can take ~350us, see the notes at the end).
+#ifndef FASTLED_NRF52_PIXELS_PER_SEQUENCE
+#define FASTLED_NRF52_PIXELS_PER_SEQUENCE 16
+#endif
+
 // nRF52810 has a single PWM peripheral (PWM0)
 // nRF52832 has three PWM peripherals (PWM0, PWM1, PWM2)
 // nRF52840 has four PWM peripherals (PWM0, PWM1, PWM2, PWM3)
@@ -37,16 +58,33 @@ private:
     static const uint16_t _POLARITY_BIT        = (_FLIP ? 0 : 0x8000);
 
     static const uint8_t  _BITS_PER_PIXEL   = (8 + _XTRA0) * 3; // NOTE: 3 means RGB only...
+#if FASTLED_NRF52_STREAMING
+    // SEQ[0] and SEQ[1] share the buffer, one after the other
+    static const uint16_t _PIXELS_PER_SEQUENCE = FASTLED_NRF52_PIXELS_PER_SEQUENCE;
+    static const uint16_t _SEQUENCE_COUNT   = (_BITS_PER_PIXEL * _PIXELS_PER_SEQUENCE);
+    static const uint16_t _PWM_BUFFER_COUNT = (2 * _SEQUENCE_COUNT);
+    static_assert(_PIXELS_PER_SEQUENCE > 0, "Sequence length must be positive value (FASTLED_NRF52_PIXELS_PER_SEQUENCE)");
+    static_assert((uint32_t)_BITS_PER_PIXEL * FASTLED_NRF52_PIXELS_PER_SEQUENCE <= 0x7FFFu, "Sequence must fit in 15 bits (FASTLED_NRF52_PIXELS_PER_SEQUENCE)");
+#else
     static const uint16_t _PWM_BUFFER_COUNT = (_BITS_PER_PIXEL * FASTLED_NRF52_MAXIMUM_PIXELS_PER_STRING);
+#endif
     static const uint8_t  _T0H = ((uint16_t)(_T1        ));
     static const uint8_t  _T1H = ((uint16_t)(_T1+_T2    ));
     static const uint8_t  _TOP = ((uint16_t)(_T1+_T2+_T3));
+    static const uint16_t _ZERO = _POLARITY_BIT | _T0H; // sequence value for a "0" bit
+    static const uint16_t _ONE  = _POLARITY_BIT | _T1H; // sequence value for a "1" bit
 
     // may as well be static, as can only attach one LED string per _DATA_PIN....
     static uint16_t s_SequenceBuffer[_PWM_BUFFER_COUNT];
     static uint16_t s_SequenceBufferValidElements;
     static volatile uint32_t s_SequenceBufferInUse;
     static CMinWait<_WAIT_TIME_MICROSECONDS> mWait;  // ensure data has time to latch
+#if FASTLED_NRF52_STREAMING
+    // the pixels still to send, for the isr to refill the sequences from
+    // (a copy of showPixels' PixelController, which goes away once it returns)
+    static uint32_t s_StreamPixels[(sizeof(PixelController<_RGB_ORDER>) + 3) / 4];
+    static CRGB s_StreamColor; // the color for showColor, which may not outlive the call either
+#endif
 
     FASTLED_NRF52_INLINE_ATTRIBUTE static void startPwmPlayback_InitializePinState() {
         FastPin<_DATA_PIN>::setOutput();
@@ -91,6 +129,43 @@ private:
         nrf_pwm_loop_set(pwm, 0);
 
     }
+#if FASTLED_NRF52_STREAMING
+    FASTLED_NRF52_INLINE_ATTRIBUTE static PixelController<_RGB_ORDER> & streamPixels() {
+        return *reinterpret_cast<PixelController<_RGB_ORDER> *>(s_StreamPixels);
+    }
+    // encode the next pixels into SEQ[seq] and point the PWM at them, while the other sequence plays
+    // if they're the last pixels, the PWM stops when SEQ[seq] ends
+    // returns false if there were no pixels left
+    FASTLED_NRF52_INLINE_ATTRIBUTE static bool refillSequence(NRF_PWM_Type * pwm, uint8_t seq) {
+        PixelController<_RGB_ORDER> & pixels = streamPixels();
+        if (!pixels.has(1)) {
+            return false;
+        }
+        uint16_t * e = &(s_SequenceBuffer[seq * _SEQUENCE_COUNT]);
+        uint16_t count = nrf52_pwm_encode_pixels(pixels, e, _PIXELS_PER_SEQUENCE, _XTRA0, _ZERO, _ONE);
+        nrf_pwm_seq_ptr_set(pwm, seq, e);
+        nrf_pwm_seq_cnt_set(pwm, seq, count);
+        if (!pixels.has(1)) {
+            nrf_pwm_shorts_enable(pwm, (seq == 0) ? NRF_PWM_SHORT_SEQEND0_STOP_MASK : NRF_PWM_SHORT_SEQEND1_STOP_MASK);
+        }
+        return true;
+    }
+    FASTLED_NRF52_INLINE_ATTRIBUTE static void startPwmPlayback_ConfigureStreamingSequences(NRF_PWM_Type * pwm) {
+        // each loop plays SEQ[0] then SEQ[1], so there need to be enough of
+        // them for every sequence; the one with the last pixels stops the PWM
+        uint32_t sequences = (streamPixels().size() + _PIXELS_PER_SEQUENCE - 1) / _PIXELS_PER_SEQUENCE;
+        for (uint8_t seq = 0; seq < 2; ++seq) {
+            nrf_pwm_seq_refresh_set(pwm, seq, 0);
+            nrf_pwm_seq_end_delay_set(pwm, seq, 0);
+        }
+        refillSequence(pwm, 0);
+        if (refillSequence(pwm, 1)) {
+            nrf_pwm_loop_set(pwm, (uint16_t)((sequences + 1) / 2));
+        } else {
+            nrf_pwm_loop_set(pwm, 0); // it all fits in SEQ[0]
+        }
+    }
+#endif
     FASTLED_NRF52_INLINE_ATTRIBUTE static void startPwmPlayback_EnableInterruptsAndShortcuts(NRF_PWM_Type * pwm) {
         IRQn_Type irqn = PWM_Arbiter<FASTLED_NRF52_PWM_ID>::getIRQn();
         // TODO: check API results...
@@ -103,8 +178,11 @@ private:
 
         // shortcuts prevent (up to) 4-cycle delay from interrupt handler to next action
         uint32_t shortsToEnable = 0;
+#if !FASTLED_NRF52_STREAMING
+        // (when streaming, refillSequence() adds the one for the last sequence)
         shortsToEnable |= NRF_PWM_SHORT_SEQEND0_STOP_MASK;        ///< SEQEND[0] --> STOP task.
         shortsToEnable |= NRF_PWM_SHORT_SEQEND1_STOP_MASK;        ///< SEQEND[1] --> STOP task.
+#endif
         //shortsToEnable |= NRF_PWM_SHORT_LOOPSDONE_SEQSTART0_MASK; ///< LOOPSDONE --> SEQSTART[0] task.
         //shortsToEnable |= NRF_PWM_SHORT_LOOPSDONE_SEQSTART1_MASK; ///< LOOPSDONE --> SEQSTART[1] task.
         shortsToEnable |= NRF_PWM_SHORT_LOOPSDONE_STOP_MASK;      ///< LOOPSDONE --> STOP task.
@@ -114,7 +192,9 @@ private:
         uint32_t interruptsToEnable = 0;
         interruptsToEnable |= NRF_PWM_INT_SEQEND0_MASK;
         interruptsToEnable |= NRF_PWM_INT_SEQEND1_MASK;
+#if !FASTLED_NRF52_STREAMING
         interruptsToEnable |= NRF_PWM_INT_LOOPSDONE_MASK;
+#endif
         interruptsToEnable |= NRF_PWM_INT_STOPPED_MASK;
         nrf_pwm_int_set(pwm, interruptsToEnable);
 
@@ -140,6 +220,17 @@ public:
         NRF_PWM_Type * pwm = PWM_Arbiter<FASTLED_NRF52_PWM_ID>::getPWM();
         IRQn_Type irqn = PWM_Arbiter<FASTLED_NRF52_PWM_ID>::getIRQn();
 
+#if FASTLED_NRF52_STREAMING
+        // the sequence that just ended is free to take the next pixels
+        if (nrf_pwm_event_check(pwm,NRF_PWM_EVENT_SEQEND0)) {
+            nrf_pwm_event_clear(pwm,NRF_PWM_EVENT_SEQEND0);
+            refillSequence(pwm, 0);
+        }
+        if (nrf_pwm_event_check(pwm,NRF_PWM_EVENT_SEQEND1)) {
+            nrf_pwm_event_clear(pwm,NRF_PWM_EVENT_SEQEND1);
+            refillSequence(pwm, 1);
+        }
+#endif
         // Currently, only use SEQUENCE 0, so only event
         // of consequence is LOOPSDONE ...
         if (nrf_pwm_event_check(pwm,NRF_PWM_EVENT_STOPPED)) {
@@ -177,24 +268,53 @@ public:
     }
     virtual uint16_t getMaxRefreshRate() const { return 800; }
 
+    virtual void waitForShowComplete() {
+        // the sequence buffer is released by the isr once playback ends
+        while (s_SequenceBufferInUse != 0);
+    }
+
     virtual void showPixels(PixelController<_RGB_ORDER> & pixels) {
+#if FASTLED_NRF52_STREAMING
+        beginShowPixels(pixels);
+        endShow();
+#else
         // wait for the only sequence buffer to become available
         spinAcquireSequenceBuffer();
         prepareSequenceBuffers(pixels);
         // ensure any prior data had time to latch
         mWait.wait();
         startPwmPlayback(s_SequenceBufferValidElements);
+#endif
         return;
     }
 
+#if FASTLED_NRF52_STREAMING
+    // the pixels are read as they're sent, so the show isn't over until they've all gone out
+    virtual void endShow() {
+        waitForShowComplete();
+    }
+
+    virtual void beginShowPixels(PixelController<_RGB_ORDER> & pixels) {
+        // wait for the sequence buffers to become available
+        spinAcquireSequenceBuffer();
+        new (s_StreamPixels) PixelController<_RGB_ORDER>(pixels);
+        if (pixels.advanceBy() == 0) {
+            s_StreamColor = *(const CRGB *)pixels.mData;
+            streamPixels().mData = (const uint8_t *)&s_StreamColor;
+        }
+        // ensure any prior data had time to latch
+        mWait.wait();
+        startPwmPlayback(0);
+    }
+#endif
+
     template<uint8_t _BIT>
     FASTLED_NRF52_INLINE_ATTRIBUTE static void WriteBitToSequence(uint8_t byte, uint16_t * e) {
         *e = _POLARITY_BIT | (((byte & (1u << _BIT)) == 0) ? _T0H : _T1H);
     }
+#if !FASTLED_NRF52_STREAMING
     FASTLED_NRF52_INLINE_ATTRIBUTE static void prepareSequenceBuffers(PixelController<_RGB_ORDER> & pixels) {
         s_SequenceBufferValidElements = 0;
-        int32_t    remainingSequenceElements = _PWM_BUFFER_COUNT;
-        uint16_t * e = s_SequenceBuffer;
         uint32_t size_needed = pixels.size(); // count of pixels
         size_needed *= (8 + _XTRA0);          // bits per pixel
         size_needed *= 2;                     // each bit takes two bytes
@@ -204,57 +324,9 @@ public:
             return;
         }
 
-        while (pixels.has(1) && (remainingSequenceElements >= _BITS_PER_PIXEL)) {
-            uint8_t b0 = pixels.loadAndScale0();
-            WriteBitToSequence<7>(b0, e); ++e;
-            WriteBitToSequence<6>(b0, e); ++e;
-            WriteBitToSequence<5>(b0, e); ++e;
-            WriteBitToSequence<4>(b0, e); ++e;
-            WriteBitToSequence<3>(b0, e); ++e;
-            WriteBitToSequence<2>(b0, e); ++e;
-            WriteBitToSequence<1>(b0, e); ++e;
-            WriteBitToSequence<0>(b0, e); ++e;
-            if (_XTRA0 > 0) {
-                for (int i = 0; i < _XTRA0; ++i) {
-                    WriteBitToSequence<0>(0,e); ++e;
-                }
-            }
-            uint8_t b1 = pixels.loadAndScale1();
-            WriteBitToSequence<7>(b1, e); ++e;
-            WriteBitToSequence<6>(b1, e); ++e;
-            WriteBitToSequence<5>(b1, e); ++e;
-            WriteBitToSequence<4>(b1, e); ++e;
-            WriteBitToSequence<3>(b1, e); ++e;
-            WriteBitToSequence<2>(b1, e); ++e;
-            WriteBitToSequence<1>(b1, e); ++e;
-            WriteBitToSequence<0>(b1, e); ++e;
-            if (_XTRA0 > 0) {
-                for (int i = 0; i < _XTRA0; ++i) {
-                    WriteBitToSequence<0>(0,e); ++e;
-                }
-            }
-            uint8_t b2 = pixels.loadAndScale2();
-            WriteBitToSequence<7>(b2, e); ++e;
-            WriteBitToSequence<6>(b2, e); ++e;
-            WriteBitToSequence<5>(b2, e); ++e;
-            WriteBitToSequence<4>(b2, e); ++e;
-            WriteBitToSequence<3>(b2, e); ++e;
-            WriteBitToSequence<2>(b2, e); ++e;
-            WriteBitToSequence<1>(b2, e); ++e;
-            WriteBitToSequence<0>(b2, e); ++e;
-            if (_XTRA0 > 0) {
-                for (int i = 0; i < _XTRA0; ++i) {
-                    WriteBitToSequence<0>(0,e); ++e;
-                }
-            }
-
-            // advance pixel and sequence pointers
-            s_SequenceBufferValidElements += _BITS_PER_PIXEL;
-            remainingSequenceElements     -= _BITS_PER_PIXEL;
-            pixels.advanceData();
-            pixels.stepDithering();
-        }
+        s_SequenceBufferValidElements = nrf52_pwm_encode_pixels(pixels, s_SequenceBuffer, FASTLED_NRF52_MAXIMUM_PIXELS_PER_STRING, _XTRA0, _ZERO, _ONE);
     }
+#endif
 
 
     FASTLED_NRF52_INLINE_ATTRIBUTE static void startPwmPlayback(uint16_t bytesToSend) {
@@ -266,8 +338,14 @@ public:
 
         startPwmPlayback_InitializePinState();
         startPwmPlayback_InitializePwmInstance(pwm);
+#if FASTLED_NRF52_STREAMING
+        // the shortcut for the last sequence is set as it's filled, so after the others
+        startPwmPlayback_EnableInterruptsAndShortcuts(pwm);
+        startPwmPlayback_ConfigureStreamingSequences(pwm);
+#else
         startPwmPlayback_ConfigurePwmSequence(pwm);
         startPwmPlayback_EnableInterruptsAndShortcuts(pwm);
+#endif
         startPwmPlayback_StartTask(pwm);
         return;
     }
@@ -326,6 +404,12 @@ template <uint8_t _DATA_PIN, int _T1, int _T2, int _T3, EOrder _RGB_ORDER, int _
 uint16_t ClocklessController<_DATA_PIN, _T1, _T2, _T3, _RGB_ORDER, _XTRA0, _FLIP, _WAIT_TIME_MICROSECONDS>::s_SequenceBuffer[_PWM_BUFFER_COUNT];
 template <uint8_t _DATA_PIN, int _T1, int _T2, int _T3, EOrder _RGB_ORDER, int _XTRA0, bool _FLIP, int _WAIT_TIME_MICROSECONDS>
 CMinWait<_WAIT_TIME_MICROSECONDS> ClocklessController<_DATA_PIN, _T1, _T2, _T3, _RGB_ORDER, _XTRA0, _FLIP, _WAIT_TIME_MICROSECONDS>::mWait;
+#if FASTLED_NRF52_STREAMING
+template <uint8_t _DATA_PIN, int _T1, int _T2, int _T3, EOrder _RGB_ORDER, int _XTRA0, bool _FLIP, int _WAIT_TIME_MICROSECONDS>
+uint32_t ClocklessController<_DATA_PIN, _T1, _T2, _T3, _RGB_ORDER, _XTRA0, _FLIP, _WAIT_TIME_MICROSECONDS>::s_StreamPixels[(sizeof(PixelController<_RGB_ORDER>) + 3) / 4];
+template <uint8_t _DATA_PIN, int _T1, int _T2, int _T3, EOrder _RGB_ORDER, int _XTRA0, bool _FLIP, int _WAIT_TIME_MICROSECONDS>
+CRGB ClocklessController<_DATA_PIN, _T1, _T2, _T3, _RGB_ORDER, _XTRA0, _FLIP, _WAIT_TIME_MICROSECONDS>::s_StreamColor;
+#endif
 
 /* nrf_pwm solution
 // 
@@ -352,8 +436,8 @@ CMinWait<_WAIT_TIME_MICROSECONDS> ClocklessController<_DATA_PIN, _T1, _T2, _T3,
 // Options after initial solution working:
 // [] 
 
-// TODO: Double-buffers, so one can be doing DMA while the second
-//       buffer is being prepared.
+// DONE: Double-buffers, so one can be doing DMA while the second
+//       buffer is being prepared (FASTLED_NRF52_STREAMING).
 // TODO: Pool of buffers, so can keep N-1 active in DMA, while
 //       preparing data in the final buffer?
 //       Write another class similar to PWM_Arbiter, only for
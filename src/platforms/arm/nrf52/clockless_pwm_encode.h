@@ -0,0 +1,48 @@
+#ifndef __INC_CLOCKLESS_PWM_ENCODE_NRF52
+#define __INC_CLOCKLESS_PWM_ENCODE_NRF52
+
+#include <stdint.h>
+
+// Encoding of pixel data into PWM sequence values for the nRF52 clockless driver
+//
+// These functions don't touch the PWM peripheral, or depend on the nRF SDK,
+// so that the encoding can be checked on the host.
+//
+// Each bit on the wire is one 16-bit sequence value: the compare value for
+// a "0" or a "1" bit (T0H or T1H), with the polarity bit already set.
+
+//FASTLED_NAMESPACE_BEGIN
+
+// encode one byte, MSB first, into 8 sequence values
+__attribute__ ((always_inline)) inline static uint16_t * nrf52_pwm_encode_byte(uint8_t b, uint16_t * e, uint16_t zero, uint16_t one) {
+    for (int bit = 7; bit >= 0; --bit) {
+        *e++ = (b & (1u << bit)) ? one : zero;
+    }
+    return e;
+}
+
+// encode up to maxPixels pixels into sequence values, followed by xtra0 "0"
+// bits after each byte, and advance pixels past them (stepping the dithering
+// as it goes). pixels is a PixelController, or anything with its interface.
+// returns the number of sequence values written, (8 + xtra0) * 3 per pixel
+template <typename PIXELS>
+inline static uint16_t nrf52_pwm_encode_pixels(PIXELS & pixels, uint16_t * buf, uint16_t maxPixels,
+                                               int xtra0, uint16_t zero, uint16_t one) {
+    uint16_t * e = buf;
+    for (uint16_t i = 0; i < maxPixels && pixels.has(1); ++i) {
+        e = nrf52_pwm_encode_byte(pixels.loadAndScale0(), e, zero, one);
+        for (int x = 0; x < xtra0; ++x) { *e++ = zero; }
+        e = nrf52_pwm_encode_byte(pixels.loadAndScale1(), e, zero, one);
+        for (int x = 0; x < xtra0; ++x) { *e++ = zero; }
+        e = nrf52_pwm_encode_byte(pixels.loadAndScale2(), e, zero, one);
+        for (int x = 0; x < xtra0; ++x) { *e++ = zero; }
+
+        pixels.advanceData();
+        pixels.stepDithering();
+    }
+    return (uint16_t)(e - buf);
+}
+
+//FASTLED_NAMESPACE_END
+
+#endif // __INC_CLOCKLESS_PWM_ENCODE_NRF52
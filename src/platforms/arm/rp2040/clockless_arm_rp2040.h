@@ -56,6 +56,23 @@ static inline void __isr clockless_dma_complete_handler() {
     }
 }
 static bool clockless_isr_installed = false;
+
+// have wait marked when the transfer on DMA channel completes, installing the handler if needed
+// kinda dirty hack here to cast to CMinWait<0>*, but only mark is used, which isn't affected by the template var WAIT
+static inline void clockless_add_dma_wait(int channel, CMinWait<0> *wait) {
+    dma_chan_waits[channel] = wait;
+    
+    if (!clockless_isr_installed) {
+#if FASTLED_RP2040_CLOCKLESS_IRQ_SHARED
+        irq_add_shared_handler(DMA_IRQ_0, clockless_dma_complete_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+#else
+        irq_set_exclusive_handler(DMA_IRQ_0, clockless_dma_complete_handler);
+#endif
+        irq_set_enabled(DMA_IRQ_0, true);
+        clockless_isr_installed = true;
+    }
+    dma_channel_set_irq0_enabled(channel, true);
+}
 #endif
 
 template <uint8_t DATA_PIN, int T1, int T2, int T3, EOrder RGB_ORDER = RGB, int XTRA0 = 0, bool FLIP = false, int WAIT_TIME = 50>
@@ -65,8 +82,16 @@ class ClocklessController : public CPixelLEDController<RGB_ORDER> {
     void *dma_buf = nullptr;
     size_t dma_buf_size = 0;
     
-    float pio_clock_multiplier;
-    int T1_mult, T2_mult, T3_mult;
+    // the longest of T1, T2 and T3
+    static const int MAX_T = (T1 > T2) ? (T1 > T3 ? T1 : T3) : (T2 > T3 ? T2 : T3);
+    // run the PIO program at CLOCKLESS_FREQUENCY, or slower if the PIO can't delay for MAX_T cycles of it,
+    // with T1, T2 and T3 converted to ticks of that clock at compile time
+    static const uint32_t PIO_CLOCK_HZ = (MAX_T > CLOCKLESS_PIO_MAX_TIME_PERIOD)
+        ? (uint32_t)(((uint64_t)CLOCKLESS_FREQUENCY * CLOCKLESS_PIO_MAX_TIME_PERIOD) / MAX_T)
+        : CLOCKLESS_FREQUENCY;
+    typedef CClocklessTicks<CClocklessTiming<T1, T2, T3, CLOCKLESS_FREQUENCY>, PIO_CLOCK_HZ> PioTiming;
+    static_assert(PioTiming::VALID, "This chipset's timing can't be sent with the PIO clock");
+    static_assert(PioTiming::T3 >= 2, "T3 must be at least 2 PIO cycles");
     
     // increase wait time by time taken to send 4 words (to flush PIO TX buffer)
     CMinWait<WAIT_TIME + ( ((T1 + T2 + T3) * 32 * 4) / (CLOCKLESS_FREQUENCY / 1000000) )> mWait;
@@ -114,6 +139,16 @@ class ClocklessController : public CPixelLEDController<RGB_ORDER> {
     CMinWait<WAIT_TIME> mWait;
 #endif
 public:
+    // timings for the block controller (see clockless_block_arm_rp2040.h) to pick up from a chipset
+    static constexpr int __DATA_PIN() { return DATA_PIN; }
+    static constexpr int __T1() { return T1; }
+    static constexpr int __T2() { return T2; }
+    static constexpr int __T3() { return T3; }
+    static constexpr EOrder __RGB_ORDER() { return RGB_ORDER; }
+    static constexpr int __XTRA0() { return XTRA0; }
+    static constexpr bool __FLIP() { return FLIP; }
+    static constexpr int __WAIT_TIME() { return WAIT_TIME; }
+
     virtual void init() {
 #if FASTLED_RP2040_CLOCKLESS_PIO
         if (dma_channel != -1) return; // maybe init was called twice somehow? not sure if possible
@@ -123,23 +158,6 @@ public:
         FastPin<DATA_PIN>::setOutput();
         
 #if FASTLED_RP2040_CLOCKLESS_PIO
-        // convert from input timebase to one that the PIO program can handle
-        int max_t = T1 > T2 ? T1 : T2;
-        max_t = T3 > max_t ? T3 : max_t;
-        
-        if (max_t > CLOCKLESS_PIO_MAX_TIME_PERIOD) {
-            pio_clock_multiplier = (float)CLOCKLESS_PIO_MAX_TIME_PERIOD / max_t;
-            T1_mult = pio_clock_multiplier * T1;
-            T2_mult = pio_clock_multiplier * T2;
-            T3_mult = pio_clock_multiplier * T3;
-        }
-        else {
-            pio_clock_multiplier = 1.f;
-            T1_mult = T1;
-            T2_mult = T2;
-            T3_mult = T3;
-        }
-        
         PIO pio;
         int sm;
         int offset = -1;
@@ -153,7 +171,7 @@ public:
             sm = pio_claim_unused_sm(pio, false); // claim a state machine
             if (sm == -1) continue; // skip this PIO if no unused sm
             
-            offset = add_clockless_pio_program(pio, T1_mult, T2_mult, T3_mult);
+            offset = add_clockless_pio_program(pio, PioTiming::T1, PioTiming::T2, PioTiming::T3);
             if (offset == -1) {
                 pio_sm_unclaim(pio, sm); // unclaim the state machine and skip this PIO
                 continue;                // if program couldn't be added
@@ -182,7 +200,7 @@ public:
         // which seems like it won't actually benefit us
         // sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
         
-        float div = clock_get_hz(clk_sys) / (pio_clock_multiplier * CLOCKLESS_FREQUENCY);
+        float div = (float)clock_get_hz(clk_sys) / PIO_CLOCK_HZ;
         sm_config_set_clkdiv(&c, div);
         
         pio_sm_init(pio, sm, offset, &c);
@@ -203,24 +221,30 @@ public:
         // setup DMA complete interrupt handler to update mWait time after transfer
         
         // store a pointer to mWait of this instance to a global array for the interrupt handler
-        // kinda dirty hack here to cast to CMinWait<0>*, but only mark is used, which isn't affected by the template var WAIT
-        dma_chan_waits[dma_channel] = (CMinWait<0>*)&mWait;
-        
-        if (!clockless_isr_installed) {
-#if FASTLED_RP2040_CLOCKLESS_IRQ_SHARED
-            irq_add_shared_handler(DMA_IRQ_0, clockless_dma_complete_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
-#else
-            irq_set_exclusive_handler(DMA_IRQ_0, clockless_dma_complete_handler);
-#endif
-            irq_set_enabled(DMA_IRQ_0, true);
-            clockless_isr_installed = true;
-        }
-        dma_channel_set_irq0_enabled(dma_channel, true);
+        clockless_add_dma_wait(dma_channel, (CMinWait<0>*)&mWait);
 #endif // FASTLED_RP2040_CLOCKLESS_PIO
     }
 
     virtual uint16_t getMaxRefreshRate() const { return 400; }
 
+    // the blocking fallback reads the led bytes itself
+    virtual bool showsPixels16() {
+#if FASTLED_RP2040_CLOCKLESS_PIO
+        return dma_channel != -1;
+#else
+        return false;
+#endif
+    }
+
+    virtual void waitForShowComplete() {
+#if FASTLED_RP2040_CLOCKLESS_PIO
+        // the DMA transfer started by the last showPixels reads straight out of dma_buf
+        if (dma_channel != -1 && dma_channel_is_busy(dma_channel)) {
+            dma_channel_wait_for_finish_blocking(dma_channel);
+        }
+#endif
+    }
+
     virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
 #if FASTLED_RP2040_CLOCKLESS_PIO
         if (dma_channel == -1) { // setup failed, so fall back to a blocking implementation
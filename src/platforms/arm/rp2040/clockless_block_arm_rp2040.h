@@ -0,0 +1,233 @@
+#ifndef __INC_CLOCKLESS_BLOCK_ARM_RP2040
+#define __INC_CLOCKLESS_BLOCK_ARM_RP2040
+
+#if FASTLED_RP2040_CLOCKLESS_PIO
+#include "clockless_block_encode.h"
+
+/*
+ * This block clockless implementation drives LANES strips on consecutive pins,
+ * starting at FIRST_PIN, from one PIO state machine. The pixel data is
+ * transposed into one bit plane per bit (see clockless_block_encode.h) so the
+ * strips are all sent in the time it takes to send one of them.
+ *
+ * Resource usage is 4 instructions of program memory, one PIO state machine
+ * and one DMA channel per instance, however many strips it drives, plus the
+ * DMA_IRQ_0 handler shared with ClocklessController.
+ * The DMA buffer holds one plane per bit: a byte for up to 8 strips, a
+ * halfword for up to 16 and a word for more.
+ *
+ * Use it with the chipset controllers through FastLED.addLeds, e.g.
+ *     FastLED.addLeds<NUM_STRIPS, WS2812B, FIRST_PIN, GRB>(leds, NUM_LEDS_PER_STRIP);
+ * where leds holds the strips one after the other.
+ */
+
+FASTLED_NAMESPACE_BEGIN
+
+#define __FL_RP2040_BLOCK_MASK ((uint32_t)((1ULL << (LANES)) - 1))
+template <uint8_t LANES, int FIRST_PIN, int T1, int T2, int T3, EOrder RGB_ORDER = GRB, int XTRA0 = 0, bool FLIP = false, int WAIT_TIME = 50>
+class BlockClocklessController : public CPixelLEDController<RGB_ORDER, LANES, __FL_RP2040_BLOCK_MASK> {
+    typedef ClocklessBlockPlane<LANES> Plane;
+    typedef typename Plane::type plane_t;
+    static_assert(LANES >= 1 && FIRST_PIN >= 0 && FIRST_PIN + LANES <= NUM_BANK0_GPIOS, "The strips must be on consecutive GPIOs");
+
+    int dma_channel = -1;
+    plane_t *dma_buf = nullptr;
+    size_t dma_buf_size = 0;
+
+    // the same PIO clock and timing as ClocklessController
+    static const int MAX_T = (T1 > T2) ? (T1 > T3 ? T1 : T3) : (T2 > T3 ? T2 : T3);
+    static const uint32_t PIO_CLOCK_HZ = (MAX_T > CLOCKLESS_PIO_MAX_TIME_PERIOD)
+        ? (uint32_t)(((uint64_t)CLOCKLESS_FREQUENCY * CLOCKLESS_PIO_MAX_TIME_PERIOD) / MAX_T)
+        : CLOCKLESS_FREQUENCY;
+    typedef CClocklessTicks<CClocklessTiming<T1, T2, T3, CLOCKLESS_FREQUENCY>, PIO_CLOCK_HZ> PioTiming;
+    static_assert(PioTiming::VALID, "This chipset's timing can't be sent with the PIO clock");
+    static_assert(PioTiming::T3 >= 2, "T3 must be at least 2 PIO cycles");
+
+    // increase wait time by time taken to send 5 planes (to flush PIO TX FIFO and OSR)
+    CMinWait<WAIT_TIME + ( ((T1 + T2 + T3) * 5) / (CLOCKLESS_FREQUENCY / 1000000) )> mWait;
+
+    // start a DMA transfer to the PIO state machine from addr (transfer count planes)
+    static void do_dma_transfer(int channel, const void *addr, uint count) {
+        dma_channel_set_read_addr(channel, addr, false);
+        dma_channel_set_trans_count(channel, count, true);
+    }
+
+public:
+    virtual int size() { return CLEDController::size() * LANES; }
+
+    virtual void init() {
+        if (dma_channel != -1) return;
+
+        // start by configuring pins as outputs for blocking fallback
+        for (int i = 0; i < LANES; i++) {
+            gpio_set_function(FIRST_PIN + i, GPIO_FUNC_SIO);
+        }
+        sio_hw->gpio_oe_set = __FL_RP2040_BLOCK_MASK << FIRST_PIN;
+
+        PIO pio;
+        int sm;
+        int offset = -1;
+
+        // find an unclaimed PIO state machine and upload the block program if possible
+        const PIO pios[NUM_PIOS] = { pio0, pio1 };
+        for (unsigned int i = 0; i < NUM_PIOS; i++) {
+            pio = pios[i];
+            sm = pio_claim_unused_sm(pio, false);
+            if (sm == -1) continue;
+
+            offset = add_clockless_block_pio_program(pio, Plane::PLANE_LANES, PioTiming::T1, PioTiming::T2, PioTiming::T3);
+            if (offset == -1) {
+                pio_sm_unclaim(pio, sm);
+                continue;
+            }
+
+            break;
+        }
+        if (offset == -1) return; // couldn't find good pio and sm
+
+        dma_channel = dma_claim_unused_channel(false);
+        if (dma_channel == -1) return; // no free DMA channel
+
+
+        // setup PIO state machine, with every strip's pin as an out pin
+        for (int i = 0; i < LANES; i++) {
+            pio_gpio_init(pio, FIRST_PIN + i);
+        }
+        pio_sm_set_pins_with_mask(pio, sm, 0, __FL_RP2040_BLOCK_MASK << FIRST_PIN);
+        pio_sm_set_consecutive_pindirs(pio, sm, FIRST_PIN, LANES, true);
+
+        pio_sm_config c = clockless_block_pio_program_get_default_config(offset);
+        sm_config_set_out_pins(&c, FIRST_PIN, LANES);
+        // one plane per pull: the DMA writes a plane at a time, and shifting
+        // right takes its low bits, whatever the transfer size
+        sm_config_set_out_shift(&c, true, true, Plane::PLANE_LANES);
+
+        float div = (float)clock_get_hz(clk_sys) / PIO_CLOCK_HZ;
+        sm_config_set_clkdiv(&c, div);
+
+        pio_sm_init(pio, sm, offset, &c);
+        pio_sm_set_enabled(pio, sm, true);
+
+
+        // setup DMA, moving one plane per transfer
+        dma_channel_config channel_config = dma_channel_get_default_config(dma_channel);
+        channel_config_set_transfer_data_size(&channel_config,
+            sizeof(plane_t) == 1 ? DMA_SIZE_8 : (sizeof(plane_t) == 2 ? DMA_SIZE_16 : DMA_SIZE_32));
+        channel_config_set_dreq(&channel_config, pio_get_dreq(pio, sm, true));
+        dma_channel_configure(dma_channel,
+                              &channel_config,
+                              &pio->txf[sm],
+                              NULL,   // address set when making transfer
+                              1,      // count set when making transfer
+                              false); // don't trigger now
+
+        clockless_add_dma_wait(dma_channel, (CMinWait<0>*)&mWait);
+    }
+
+    virtual uint16_t getMaxRefreshRate() const { return 400; }
+
+    // the blocking fallback reads the led bytes itself
+    virtual bool showsPixels16() { return dma_channel != -1; }
+
+    virtual void waitForShowComplete() {
+        if (dma_channel != -1 && dma_channel_is_busy(dma_channel)) {
+            dma_channel_wait_for_finish_blocking(dma_channel);
+        }
+    }
+
+    virtual void showPixels(PixelController<RGB_ORDER, LANES, __FL_RP2040_BLOCK_MASK> & pixels) {
+        if (dma_channel == -1) { // setup failed, so fall back to a blocking implementation
+#if FASTLED_RP2040_CLOCKLESS_M0_FALLBACK
+            showRGBBlocking(pixels);
+#endif
+            return;
+        }
+
+        if (dma_channel_is_busy(dma_channel)) {
+            dma_channel_wait_for_finish_blocking(dma_channel);
+        }
+        mWait.wait();
+
+        showRGBInternal(pixels);
+    }
+
+    void showRGBInternal(PixelController<RGB_ORDER, LANES, __FL_RP2040_BLOCK_MASK> pixels) {
+        size_t req_buf_size = clockless_block_plane_count(pixels.mLen, XTRA0);
+
+        // (re)allocate DMA buffer if not large enough to hold req_buf_size planes
+        if (dma_buf_size < req_buf_size) {
+            if (dma_buf != nullptr)
+                free(dma_buf);
+
+            dma_buf = (plane_t*)malloc(req_buf_size * sizeof(plane_t));
+            if (dma_buf == nullptr) {
+                dma_buf_size = 0;
+                return;
+            }
+            dma_buf_size = req_buf_size;
+        }
+
+        // one byte from each lane for each channel, the lanes past LANES stay 0
+        uint8_t b[3][Plane::PLANE_LANES] = {};
+        plane_t *out = dma_buf;
+
+        pixels.preStepFirstByteDithering();
+
+        while(pixels.has(1)) {
+            pixels.stepDithering();
+
+            for (int i = 0; i < LANES; i++) {
+                b[0][i] = pixels.loadAndScale0(i);
+                b[1][i] = pixels.loadAndScale1(i);
+                b[2][i] = pixels.loadAndScale2(i);
+            }
+
+            out = clockless_block_encode_byte<Plane::PLANE_LANES>(b[0], out, XTRA0);
+            out = clockless_block_encode_byte<Plane::PLANE_LANES>(b[1], out, XTRA0);
+            out = clockless_block_encode_byte<Plane::PLANE_LANES>(b[2], out, XTRA0);
+            pixels.advanceData();
+        };
+
+        do_dma_transfer(dma_channel, dma_buf, req_buf_size);
+    }
+
+#if FASTLED_RP2040_CLOCKLESS_M0_FALLBACK
+    // send the strips one after another, the same way ClocklessController does
+    void showRGBBlocking(PixelController<RGB_ORDER, LANES, __FL_RP2040_BLOCK_MASK> pixels) {
+        struct M0ClocklessData data;
+        data.d[0] = pixels.d[0];
+        data.d[1] = pixels.d[1];
+        data.d[2] = pixels.d[2];
+        data.s[0] = pixels.mScale[0];
+        data.s[1] = pixels.mScale[1];
+        data.s[2] = pixels.mScale[2];
+        data.e[0] = pixels.e[0];
+        data.e[1] = pixels.e[1];
+        data.e[2] = pixels.e[2];
+        data.adj = pixels.mAdvance;
+
+        volatile uint32_t *portBase = &sio_hw->gpio_out;
+        const int portSetOff = (uint32_t)&sio_hw->gpio_set - (uint32_t)&sio_hw->gpio_out;
+        const int portClrOff = (uint32_t)&sio_hw->gpio_clr - (uint32_t)&sio_hw->gpio_out;
+
+        for (int i = 0; i < LANES; i++) {
+            struct M0ClocklessData lane_data = data;
+            cli();
+            showLedData<portSetOff, portClrOff, T1, T2, T3, RGB_ORDER, WAIT_TIME>(portBase, 1 << (FIRST_PIN + i), pixels.mData + pixels.mOffsets[i], pixels.mLen, &lane_data);
+            sei();
+        }
+    }
+#endif
+
+};
+
+template<template<uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, int NUM_LANES, EOrder RGB_ORDER=GRB>
+class __FIBCC : public BlockClocklessController<NUM_LANES,DATA_PIN,CHIPSET<DATA_PIN,RGB_ORDER>::__T1(),CHIPSET<DATA_PIN,RGB_ORDER>::__T2(),CHIPSET<DATA_PIN,RGB_ORDER>::__T3(),RGB_ORDER,CHIPSET<DATA_PIN,RGB_ORDER>::__XTRA0(),CHIPSET<DATA_PIN,RGB_ORDER>::__FLIP(),CHIPSET<DATA_PIN,RGB_ORDER>::__WAIT_TIME()> {};
+
+#define __FASTLED_HAS_FIBCC 1
+
+FASTLED_NAMESPACE_END
+
+#endif // FASTLED_RP2040_CLOCKLESS_PIO
+
+#endif // __INC_CLOCKLESS_BLOCK_ARM_RP2040
@@ -0,0 +1,56 @@
+#ifndef __INC_CLOCKLESS_BLOCK_ENCODE_RP2040
+#define __INC_CLOCKLESS_BLOCK_ENCODE_RP2040
+
+#include <stdint.h>
+#include "bitswap.h"
+
+/*
+ * Packing of pixel data into bit planes for the RP2040 block clockless driver
+ *
+ * These functions don't touch the PIO or DMA hardware, or depend on the
+ * pico SDK, so that the packing can be checked on the host.
+ *
+ * The PIO program sends one bit plane per bit period, MSB first: plane k
+ * of a byte holds bit 7 - k of that byte for every strip, with strip i in
+ * bit i. Planes are as wide as the smallest DMA transfer that fits all of
+ * the strips, so up to 8 strips take one byte per bit.
+ */
+
+FASTLED_NAMESPACE_BEGIN
+
+// the plane type for a number of lanes, and the number of lanes it's transposed as
+template <int LANES, bool BYTE = (LANES <= 8), bool HALFWORD = (LANES <= 16)> struct ClocklessBlockPlane;
+template <int LANES, bool HALFWORD> struct ClocklessBlockPlane<LANES, true, HALFWORD> {
+    typedef uint8_t type;
+    static const int PLANE_LANES = 8;
+};
+template <int LANES> struct ClocklessBlockPlane<LANES, false, true> {
+    typedef uint16_t type;
+    static const int PLANE_LANES = 16;
+};
+template <int LANES> struct ClocklessBlockPlane<LANES, false, false> {
+    typedef uint32_t type;
+    static const int PLANE_LANES = 32;
+};
+
+// number of planes for nLeds pixels on each lane, with XTRA0 zero bits after each byte
+static inline uint32_t clockless_block_plane_count(uint32_t nLeds, int xtra0) {
+    return nLeds * 3 * (8 + xtra0);
+}
+
+// write the planes for one byte from each lane, followed by xtra0 zero planes
+// lanes holds PLANE_LANES bytes: the byte for lane i at lanes[i], 0 for the unused lanes
+// returns the position after the last plane written
+template <int PLANE_LANES, typename PLANE>
+__attribute__ ((always_inline)) inline static PLANE *clockless_block_encode_byte(const uint8_t *lanes, PLANE *out, int xtra0) {
+    transposeLanes<PLANE_LANES>(lanes, out);
+    out += 8;
+    for (int i = 0; i < xtra0; i++) {
+        *out++ = 0;
+    }
+    return out;
+}
+
+FASTLED_NAMESPACE_END
+
+#endif // __INC_CLOCKLESS_BLOCK_ENCODE_RP2040
@@ -4,5 +4,6 @@
 // Include the rp2040 headers
 #include "fastpin_arm_rp2040.h"
 #include "clockless_arm_rp2040.h"
+#include "clockless_block_arm_rp2040.h"
 
 #endif
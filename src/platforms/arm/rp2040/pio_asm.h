@@ -72,8 +72,8 @@ typedef uint16_t pio_instr;
 #define PIO_MOV_DST_ISR    (0b110 << 5)
 #define PIO_MOV_DST_OSR    (0b111 << 5)
 #define PIO_MOV_OP_NONE    (0b00 << 3)
-#define PIO_MOV_OP_INVERT  (0b00 << 3)
-#define PIO_MOV_OP_REVERSE (0b00 << 3)
+#define PIO_MOV_OP_INVERT  (0b01 << 3)
+#define PIO_MOV_OP_REVERSE (0b10 << 3)
 #define PIO_MOV_SRC_PINS   (0b000)
 #define PIO_MOV_SRC_X      (0b001)
 #define PIO_MOV_SRC_Y      (0b010)
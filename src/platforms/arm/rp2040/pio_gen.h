@@ -54,4 +54,49 @@ static inline pio_sm_config clockless_pio_program_get_default_config(uint offset
     return c;
 }
 
+/*
+ * The block (parallel) variant drives a run of consecutive pins, one strip on
+ * each, from a single state machine.
+ * Each bit period takes one bit plane from the FIFO: a word with the bit for
+ * strip i in bit i. All of the pins go high, then to the plane, then low.
+ * `set` can only reach 5 pins, so the high and low phases use `mov pins` as well,
+ * which writes every out pin.
+ */
+
+#define CLOCKLESS_BLOCK_PIO_WRAP_TARGET 0
+#define CLOCKLESS_BLOCK_PIO_WRAP 3
+
+static inline int add_clockless_block_pio_program(PIO pio, int plane_bits, int T1, int T2, int T3) {
+    pio_instr clockless_block_pio_instr[] = {
+        // wrap_target
+        // out x, plane_bits; read next bit plane to x
+        (pio_instr)(PIO_INSTR_OUT | PIO_OUT_DST_X | PIO_OUT_CNT(plane_bits)),
+        // mov pins, !null [T1 - 1]; set all outputs high for T1
+        (pio_instr)(PIO_INSTR_MOV | PIO_MOV_DST_PINS | PIO_MOV_OP_INVERT | PIO_MOV_SRC_NULL | PIO_DELAY(T1 - 1, CLOCKLESS_PIO_SIDESET_COUNT)),
+        // mov pins, x [T2 - 1]; set outputs to the plane for T2
+        (pio_instr)(PIO_INSTR_MOV | PIO_MOV_DST_PINS | PIO_MOV_SRC_X | PIO_DELAY(T2 - 1, CLOCKLESS_PIO_SIDESET_COUNT)),
+        // mov pins, null [T3 - 2]; set all outputs low for T3 (minus one instruction to read the next plane)
+        (pio_instr)(PIO_INSTR_MOV | PIO_MOV_DST_PINS | PIO_MOV_SRC_NULL | PIO_DELAY(T3 - 2, CLOCKLESS_PIO_SIDESET_COUNT)),
+        // wrap
+    };
+
+    struct pio_program clockless_block_pio_program = {
+        .instructions = clockless_block_pio_instr,
+        .length = sizeof(clockless_block_pio_instr) / sizeof(clockless_block_pio_instr[0]),
+        .origin = -1,
+    };
+
+    if (!pio_can_add_program(pio, &clockless_block_pio_program))
+        return -1;
+
+    return (int)pio_add_program(pio, &clockless_block_pio_program);
+}
+
+static inline pio_sm_config clockless_block_pio_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + CLOCKLESS_BLOCK_PIO_WRAP_TARGET, offset + CLOCKLESS_BLOCK_PIO_WRAP);
+    sm_config_set_sideset(&c, CLOCKLESS_PIO_SIDESET_COUNT, false, false);
+    return c;
+}
+
 #endif // _PIO_GEN_H
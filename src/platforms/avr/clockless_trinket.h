@@ -116,6 +116,9 @@ public:
 
 	virtual uint16_t getMaxRefreshRate() const { return 400; }
 
+	// the asm reads the led bytes itself
+	virtual bool showsPixels16() { return false; }
+
 protected:
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
 
@@ -0,0 +1,71 @@
+/*
+ * Encoding of pixel data into I2S pulses for the ESP32 I2S parallel driver
+ *
+ * These functions don't touch the I2S peripheral, or depend on the
+ * ESP-IDF, so that the encoding can be checked on the host.
+ *
+ * Each 32-bit I2S word drives all of the outputs for one pulse, with
+ * output (lane) i in bit i + 8. A data bit is gPulsesPerBit pulses
+ * long: the first ones_for_zero are high for every lane, the ones up
+ * to ones_for_one are high only for the lanes sending a "1", and the
+ * rest are low.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "bitswap.h"
+
+FASTLED_NAMESPACE_BEGIN
+
+// -- Number of parallel outputs: the bits of an I2S word, less the low 8
+#define I2S_NUM_LANES 24
+
+// -- Set the pulses that are the same for a "0" and a "1" bit
+//    Yves' clever trick: the first ones_for_zero pulses of every bit
+//    are high and the ones from ones_for_one on are low, whatever the
+//    data, so they only need to be set once.
+//      buf       -- the pulses
+//      nBits     -- the number of data bits they encode
+//    This is a template so that buf can be volatile, for the DMA buffers.
+template <typename WORD>
+inline static void i2s_init_pulses(WORD * buf, int nBits, int pulsesPerBit, int onesForZero, int onesForOne)
+{
+    for (int i = 0; i < nBits; ++i) {
+        WORD * pulses = buf + i * pulsesPerBit;
+        for (int j = 0; j < onesForZero; ++j) {
+            pulses[j] = 0xFFFFFFFF;
+        }
+        for (int j = onesForOne; j < pulsesPerBit; ++j) {
+            pulses[j] = 0;
+        }
+    }
+}
+
+// -- Encode one pixel from each lane into its I2S pulses
+//    Only the pulses that differ between a "0" and a "1" are written,
+//    the others must have been set with i2s_init_pulses.
+//      lanes     -- the pixel, one row of I2S_NUM_LANES bytes for each
+//                   color channel, in the order they are sent
+//      nChannels -- the number of color channels
+//      mask      -- the lanes that have data, as bits of an I2S word
+//      buf       -- the pulses, 8 bits for each color channel
+template <typename WORD>
+inline static void i2s_encode_pixel(const uint8_t lanes[][I2S_NUM_LANES], int nChannels, uint32_t mask, WORD * buf,
+                                    int pulsesPerBit, int onesForZero, int onesForOne)
+{
+    for (int channel = 0; channel < nChannels; ++channel) {
+        // -- One plane for each bit, MSB first, with lane i in bit i
+        uint32_t planes[8];
+        transposeLanes<I2S_NUM_LANES>(lanes[channel], planes);
+        for (int bitnum = 0; bitnum < 8; ++bitnum) {
+            WORD * pulses = buf + (channel * 8 + bitnum) * pulsesPerBit;
+            uint32_t bits = (planes[bitnum] << 8) & mask;
+            for (int pulse_num = onesForZero; pulse_num < onesForOne; ++pulse_num) {
+                pulses[pulse_num] = bits;
+            }
+        }
+    }
+}
+
+FASTLED_NAMESPACE_END
@@ -35,8 +35,11 @@
  * for each strip. To prepare the data we need to do three things: (1)
  * take 1 pixel from each strip, and (2) tranpose the bits so that
  * they are in the parallel form, (3) translate each data bit into the
- * bit pattern that encodes the signal for that bit. This code is in
- * the fillBuffer() method:
+ * bit pattern that encodes the signal for that bit. The pixel data is
+ * scaled (brightness, color correction, dithering) up front in
+ * showPixels(), into a buffer for each strip, so the rest is all in
+ * the fillBuffer() method, with the transposing and encoding in
+ * clockless_i2s_encode.h:
  *
  *   1. Read 1 pixel from each strip into an array; store this data by
  *      color channel (e.g., all the red bytes, then all the green
@@ -55,9 +58,10 @@
  * We send data to the I2S peripheral using the DMA interface. We use
  * two DMA buffers, so that we can fill one buffer while the other
  * buffer is being sent. Each DMA buffer holds the fully-expanded
- * pulse pattern for one pixel on up to 24 strips. The exact amount of
- * memory required depends on the number of color channels and the
- * number of pulses used to encode each bit.
+ * pulse pattern for a block of pixels on up to 24 strips. The exact
+ * amount of memory required depends on the number of color channels
+ * and the number of pulses used to encode each bit: 960 bytes per
+ * pixel for WS2812.
  *
  * We get an interrupt each time a buffer is sent; we then fill that
  * buffer while the next one is being sent. The DMA interface allows
@@ -76,6 +80,16 @@
  *
  * solves flicker issues in combination with interrupts triggered by 
  * other code parts.
+ *
+ * Each DMA buffer holds 4 pixels by default, so that the interrupt
+ * handler runs once every 4 pixels rather than for every pixel. More
+ * pixels per buffer give it more slack when other interrupts (e.g.
+ * WiFi) delay it, at the cost of DMA memory. To change it, set
+ *
+ * #define FASTLED_ESP32_I2S_PIXELS_PER_BUFFER 8
+ *
+ * A DMA buffer can't be more than 4092 bytes, so the number of pixels
+ * is capped to what fits (4 for WS2812).
  */ 
 /*
  * Permission is hereby granted, free of charge, to any person obtaining a copy
@@ -99,6 +113,8 @@
 
 #pragma once
 
+#include "clockless_i2s_encode.h"
+
 #ifndef FASTLED_INTERNAL
 #pragma message "NOTE: ESP32 support using I2S parallel driver. All strips must use the same chipset"
 #endif
@@ -147,21 +163,31 @@ __attribute__ ((always_inline)) inline static uint32_t __clock_cycles() {
 
 // -- Max number of controllers we can support
 #ifndef FASTLED_I2S_MAX_CONTROLLERS
-#define FASTLED_I2S_MAX_CONTROLLERS 24
+#define FASTLED_I2S_MAX_CONTROLLERS I2S_NUM_LANES
+#endif
+
+// -- Number of pixels encoded into each DMA buffer
+#ifndef FASTLED_ESP32_I2S_PIXELS_PER_BUFFER
+#define FASTLED_ESP32_I2S_PIXELS_PER_BUFFER 4
 #endif
 
+// -- Largest DMA buffer, in bytes (a whole number of words)
+#define I2S_MAX_DMA_BUFFER 4092
+
 // -- I2S clock
 #define I2S_BASE_CLK (80000000L)
 #define I2S_MAX_CLK (20000000L) //more tha a certain speed and the I2s looses some bits
 #define I2S_MAX_PULSE_PER_BIT 20 //put it higher to get more accuracy but it could decrease the refresh rate without real improvement
-// -- Convert ESP32 cycles back into nanoseconds
-#define ESPCLKS_TO_NS(_CLKS) (((long)(_CLKS) * 1000L) / F_CPU_MHZ)
 
 // -- Array of all controllers
 static CLEDController * gControllers[FASTLED_I2S_MAX_CONTROLLERS];
 static int gNumControllers = 0;
 static int gNumStarted = 0;
 
+// -- Scaled pixel data for each controller, and its length in pixels
+static uint8_t * gPixelData[FASTLED_I2S_MAX_CONTROLLERS];
+static int gPixelCount[FASTLED_I2S_MAX_CONTROLLERS];
+
 // -- Global semaphore for the whole show process
 //    Semaphore is not given until all data has been sent
 static xSemaphoreHandle gTX_sem = NULL;
@@ -204,18 +230,18 @@ static DMABuffer * dmaBuffers[NUM_DMA_BUFFERS];
 //    are global variables.
 
 static int      gPulsesPerBit = 0;
-static uint32_t gOneBit[40]  = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-static uint32_t gZeroBit[40] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+static int      gPulsesPerPixel = 0;
+static int      gPixelsPerBuffer = 1;
 
 // -- Counters to track progress
 static int gCurBuffer = 0;
+static int gCurPixel = 0;
 static bool gDoneFilling = false;
 static int ones_for_one;
 static int ones_for_zero;
 
-// -- Temp buffers for pixels and bits being formatted for DMA
-static uint8_t gPixelRow[NUM_COLOR_CHANNELS][32];
-static uint8_t gPixelBits[NUM_COLOR_CHANNELS][8][4];
+// -- Temp buffer for a pixel from each strip being formatted for DMA
+static uint8_t gPixelRow[NUM_COLOR_CHANNELS][I2S_NUM_LANES];
 static int CLOCK_DIVIDER_N;
 static int CLOCK_DIVIDER_A;
 static int CLOCK_DIVIDER_B;
@@ -228,9 +254,19 @@ class ClocklessController : public CPixelLEDController<RGB_ORDER>
     
     // -- Verify that the pin is valid
     static_assert(FastPin<DATA_PIN>::validpin(), "Invalid pin specified");
+
+    // -- The pulse pattern for this chipset, and the I2S clock divider
+    //    that sends it at the chipset's bit rate
+    typedef CClocklessPulses<CClocklessTiming<T1, T2, T3, F_CPU>, I2S_MAX_PULSE_PER_BIT> PulseTiming;
+    typedef CFractionalDivider<(uint64_t)I2S_BASE_CLK * PulseTiming::PULSE_HZ_DEN, PulseTiming::PULSE_HZ_NUM, 63> ClockDivider;
+    static_assert(PulseTiming::VALID, "This chipset's timing can't be sent with the I2S pulses");
     
-    // -- Save the pixel controller
-    PixelController<RGB_ORDER> * mPixels;
+    // -- This strip's lane: its index in gControllers, gPixelData, and
+    //    the bits of the I2S words
+    int            mIndex;
+
+    // -- The size of this strip's pixel data buffer, in bytes
+    int            mBufSize;
     
     // -- Make sure we can't call show() too quickly
     CMinWait<50>   mWait;
@@ -240,13 +276,13 @@ public:
     {
         i2sInit();
         
-        // -- Allocate space to save the pixel controller
-        //    during parallel output
-        mPixels = (PixelController<RGB_ORDER> *) malloc(sizeof(PixelController<RGB_ORDER>));
-        
         gControllers[gNumControllers] = this;
         int my_index = gNumControllers;
         ++gNumControllers;
+        mIndex = my_index;
+        mBufSize = 0;
+        gPixelData[my_index] = NULL;
+        gPixelCount[my_index] = 0;
         
         // -- Set up the pin We have to do two things: configure the
         //    actual GPIO pin, and route the output from the default
@@ -263,184 +299,50 @@ public:
     }
     
     virtual uint16_t getMaxRefreshRate() const { return 400; }
+
+    // -- All of the strips go out together, started by the last
+    //    one, so none of them can be skipped on its own
+    virtual bool canSkipShow() const { return false; }
     
 protected:
-   static int pgcd(int smallest,int precision,int a,int b,int c)
-    {
-        int pgc_=1;
-        for( int i=smallest;i>0;--i)
-        {
-            
-            if( a%i<=precision && b%i<=precision && c%i<=precision)
-            {
-                pgc_=i;
-                break;
-            }
-        }
-        return pgc_;
-    }
-    
-    /** Compute pules/bit patterns
+    /** Set the pulse/bit patterns
      *
-     *  This is Yves Bazin's mad code for computing the pulse pattern
-     *  and clock timing given the target signal given by T1, T2, and
-     *  T3. In general, these parameters are interpreted as follows:
+     *  The pulse pattern and clock timing for the target signal given
+     *  by T1, T2, and T3 (Yves Bazin's scheme) are worked out at
+     *  compile time, see PulseTiming. These parameters are interpreted
+     *  as follows:
      *
      *  a "1" bit is encoded by setting the pin HIGH to T1+T2 ns, then LOW for T3 ns
      *  a "0" bit is encoded by setting the pin HIGH to T1 ns, then LOW for T2+T3 ns
      *
+     *  The bit is cut into the largest pulses that T1, T2, and T3 are
+     *  all (close to) multiples of, no more than I2S_MAX_PULSE_PER_BIT
+     *  of them, e.g.
+     *
+     *  WS2811 77 77 154 => 1  1 2 => nb pulses= 4
+     *  WS2812 60 150 90 => 2 5 3 => nb pulses=10
+     *
+     *  and the I2S clock is set to send that many pulses per bit, e.g.
+     *  WS2812B is 800kHz (1250ns), so 10 pulses of 125ns, 8MHz. The
+     *  clock is base/(N + b/a), where a is at most 63.
      */
     static void initBitPatterns()
     {
-        // Precompute the bit patterns based on the I2S sample rate
-        // Serial.println("Setting up fastled using I2S");
+        gPulsesPerBit = PulseTiming::PULSES_PER_BIT;
+        ones_for_zero = PulseTiming::ONES_FOR_ZERO;
+        ones_for_one = PulseTiming::ONES_FOR_ONE;
 
-        // -- First, convert back to ns from CPU clocks
-        uint32_t T1ns = ESPCLKS_TO_NS(T1);
-        uint32_t T2ns = ESPCLKS_TO_NS(T2);
-        uint32_t T3ns = ESPCLKS_TO_NS(T3);
-        
-        // Serial.print("T1 = "); Serial.print(T1); Serial.print(" ns "); Serial.println(T1ns);
-        // Serial.print("T2 = "); Serial.print(T2); Serial.print(" ns "); Serial.println(T2ns);
-        // Serial.print("T3 = "); Serial.print(T3); Serial.print(" ns "); Serial.println(T3ns);
-        
-        /*
-         We calculate the best pcgd to the timing
-         ie
-         WS2811 77 77 154 => 1  1 2 => nb pulses= 4
-         WS2812 60 150 90 => 2 5 3 => nb pulses=10
-         */
-        int smallest=0;
-        if (T1>T2)
-            smallest=T2;
-        else
-            smallest=T1;
-        if(smallest>T3)
-            smallest=T3;
-        double freq=(double)1/(double)(T1ns + T2ns + T3ns);
-        // Serial.printf("chipset frequency:%f Khz\n", 1000000L*freq);
-       // Serial.printf("smallest %d\n",smallest);
-        int pgc_=1;
-        int precision=0;
-        pgc_=pgcd(smallest,precision,T1,T2,T3);
-        //Serial.printf("%f\n",I2S_MAX_CLK/(1000000000L*freq));
-        while(pgc_==1 ||  (T1/pgc_ +T2/pgc_ +T3/pgc_)>I2S_MAX_PULSE_PER_BIT) //while(pgc_==1 ||  (T1/pgc_ +T2/pgc_ +T3/pgc_)>I2S_MAX_CLK/(1000000000L*freq))
-        {
-            ++precision;
-            pgc_=pgcd(smallest,precision,T1,T2,T3);
-            //Serial.printf("%d %d\n",pgc_,(a+b+c)/pgc_);
-        }
-        pgc_=pgcd(smallest,precision,T1,T2,T3);
-        // Serial.printf("pgcd %d precision:%d\n",pgc_,precision);
-        // Serial.printf("nb pulse per bit:%d\n",T1/pgc_ +T2/pgc_ +T3/pgc_);
-        gPulsesPerBit=(int)T1/pgc_ +(int)T2/pgc_ +(int)T3/pgc_;
-        /*
-         we calculate the duration of one pulse nd htre base frequency of the led
-         ie WS2812B F=1/(250+625+375)=800kHz or 1250ns
-         as we need 10 pulses each pulse is 125ns => frequency 800Khz*10=8MHz
-         WS2811 T=320+320+641=1281ns qnd we need 4 pulses => pulse duration 320.25ns =>frequency 3.1225605Mhz
-         
-         */
-
-        freq=1000000000L*freq*gPulsesPerBit;
-        // Serial.printf("needed frequency (nbpiulse per bit)*(chispset frequency):%f Mhz\n",freq/1000000);
-        
-        /*
-         we do calculate the needed N a and b
-         as f=basefred/(N+b/a);
-         as a is max 63 the precision for the decimal is 1/63
-         
-         */
-        
-         CLOCK_DIVIDER_N=(int)((double)I2S_BASE_CLK/freq);
-        double v=I2S_BASE_CLK/freq-CLOCK_DIVIDER_N;
-
-        double prec=(double)1/63;
-        int a=1;
-        int b=0;
-        CLOCK_DIVIDER_A=1;
-        CLOCK_DIVIDER_B=0;
-        for(a=1;a<64;++a)
-        {
-            for(b=0;b<a;++b)
-            {
-                //printf("%d %d %f %f %f\n",b,a,v,(double)v*(double)a,fabsf(v-(double)b/a));
-                if(fabsf(v-(double)b/a) <= prec/2)
-                    break;
-            }
-            if(fabsf(v-(double)b/a) ==0)
-            {
-                CLOCK_DIVIDER_A=a;
-                CLOCK_DIVIDER_B=b;
-                break;
-            }
-            if(fabsf(v-(double)b/a) < prec/2)
-            {
-                if (fabsf(v-(double)b/a) <fabsf(v-(double)CLOCK_DIVIDER_B/CLOCK_DIVIDER_A))
-                {
-                    CLOCK_DIVIDER_A=a;
-                    CLOCK_DIVIDER_B=b;
-                }
-                
-            }
-        }
-        //top take care of an issue with double 0.9999999999
-        if(CLOCK_DIVIDER_A==CLOCK_DIVIDER_B)
-        {
-            CLOCK_DIVIDER_A=1;
-            CLOCK_DIVIDER_B=0;
-            ++CLOCK_DIVIDER_N;
-        }
-        
-        //printf("%d %d %f %f %d\n",CLOCK_DIVIDER_B,CLOCK_DIVIDER_A,(double)CLOCK_DIVIDER_B/CLOCK_DIVIDER_A,v,CLOCK_DIVIDER_N);
-        //Serial.printf("freq %f %f\n",freq,I2S_BASE_CLK/(CLOCK_DIVIDER_N+(double)CLOCK_DIVIDER_B/CLOCK_DIVIDER_A));
-        freq=1/(CLOCK_DIVIDER_N+(double)CLOCK_DIVIDER_B/CLOCK_DIVIDER_A);
-        freq=freq*I2S_BASE_CLK;
-        // Serial.printf("calculted for i2s frequency:%f Mhz N:%d B:%d A:%d\n",freq/1000000,CLOCK_DIVIDER_N,CLOCK_DIVIDER_B,CLOCK_DIVIDER_A);
-        // double pulseduration=1000000000/freq;
-        // Serial.printf("Pulse duration: %f ns\n",pulseduration);
-        // gPulsesPerBit = (T1ns + T2ns + T3ns)/FASTLED_I2S_NS_PER_PULSE;
-        
-        //Serial.print("Pulses per bit: "); Serial.println(gPulsesPerBit);
-        
-        //int ones_for_one  = ((T1ns + T2ns - 1)/FASTLED_I2S_NS_PER_PULSE) + 1;
-        ones_for_one  = T1/pgc_ +T2/pgc_;
-        //Serial.print("One bit:  target ");
-        //Serial.print(T1ns+T2ns); Serial.print("ns --- ");
-        //Serial.print(ones_for_one); Serial.print(" 1 bits");
-        //Serial.print(" = "); Serial.print(ones_for_one * FASTLED_I2S_NS_PER_PULSE); Serial.println("ns");
-        // Serial.printf("one bit : target %d  ns --- %d  pulses 1 bit = %f ns\n",T1ns+T2ns,ones_for_one ,ones_for_one*pulseduration);
+        CLOCK_DIVIDER_N = ClockDivider::N;
+        CLOCK_DIVIDER_A = ClockDivider::A;
+        CLOCK_DIVIDER_B = ClockDivider::B;
         
-        
-        int i = 0;
-        while ( i < ones_for_one ) {
-            gOneBit[i] = 0xFFFFFF00;
-            ++i;
-        }
-        while ( i < gPulsesPerBit ) {
-            gOneBit[i] = 0x00000000;
-            ++i;
-        }
-        
-        //int ones_for_zero = ((T1ns - 1)/FASTLED_I2S_NS_PER_PULSE) + 1;
-        ones_for_zero =T1/pgc_  ;
-        // Serial.print("Zero bit:  target ");
-        // Serial.print(T1ns); Serial.print("ns --- ");
-        //Serial.print(ones_for_zero); Serial.print(" 1 bits");
-        //Serial.print(" = "); Serial.print(ones_for_zero * FASTLED_I2S_NS_PER_PULSE); Serial.println("ns");
-        // Serial.printf("Zero bit : target %d ns --- %d pulses  1 bit =   %f ns\n",T1ns,ones_for_zero ,ones_for_zero*pulseduration);
-        i = 0;
-        while ( i < ones_for_zero ) {
-            gZeroBit[i] = 0xFFFFFF00;
-            ++i;
-        }
-        while ( i < gPulsesPerBit ) {
-            gZeroBit[i] = 0x00000000;
-            ++i;
-        }
-        
-        memset(gPixelRow, 0, NUM_COLOR_CHANNELS * 32);
-        memset(gPixelBits, 0, NUM_COLOR_CHANNELS * 32);
+        memset(gPixelRow, 0, sizeof(gPixelRow));
+
+        // -- As many pixels in each DMA buffer as asked for and fit
+        gPulsesPerPixel = NUM_COLOR_CHANNELS * 8 * gPulsesPerBit;
+        gPixelsPerBuffer = I2S_MAX_DMA_BUFFER / (gPulsesPerPixel * 4);
+        if (gPixelsPerBuffer > FASTLED_ESP32_I2S_PIXELS_PER_BUFFER) gPixelsPerBuffer = FASTLED_ESP32_I2S_PIXELS_PER_BUFFER;
+        if (gPixelsPerBuffer < 1) gPixelsPerBuffer = 1;
     }
     
     static DMABuffer * allocateDMABuffer(int bytes)
@@ -537,7 +439,7 @@ protected:
         // -- Allocate DMA buffers
         for (int i=0;i<NUM_DMA_BUFFERS;i++)
         {
-          dmaBuffers[i] = allocateDMABuffer(32 * NUM_COLOR_CHANNELS * gPulsesPerBit);
+          dmaBuffers[i] = allocateDMABuffer(4 * gPulsesPerPixel * gPixelsPerBuffer);
         }
         // -- Arrange them as a circularly linked list
         for (int i=0;i<NUM_DMA_BUFFERS;i++)
@@ -567,15 +469,38 @@ protected:
      */
     static void empty( uint32_t *buf)
     {
-        for(int i=0;i<8*NUM_COLOR_CHANNELS;++i)
-        {
-            int offset=gPulsesPerBit*i;
-            for(int j=0;j<ones_for_zero;++j)
-                buf[offset+j]=0xffffffff;
-            
-            for(int j=ones_for_one;j<gPulsesPerBit;++j)
-                buf[offset+j]=0;
+        i2s_init_pulses(buf, 8*NUM_COLOR_CHANNELS*gPixelsPerBuffer, gPulsesPerBit, ones_for_zero, ones_for_one);
+    }
+
+    /** Load pixel data
+     *
+     *  Scale the pixels (brightness, color correction, dithering) into
+     *  this strip's buffer, in the order they are sent, so that filling
+     *  the DMA buffers from the interrupt handler doesn't have to.
+     */
+    void loadPixelData(PixelController<RGB_ORDER> & pixels)
+    {
+        // -- Make sure the buffer is allocated
+        int size_in_bytes = pixels.size() * NUM_COLOR_CHANNELS;
+        if (gPixelData[mIndex] == NULL || mBufSize < size_in_bytes) {
+            free(gPixelData[mIndex]);
+            gPixelData[mIndex] = (uint8_t *) malloc(size_in_bytes);
+            mBufSize = (gPixelData[mIndex] != NULL) ? size_in_bytes : 0;
+        }
+        if (gPixelData[mIndex] == NULL) {
+            gPixelCount[mIndex] = 0;
+            return;
         }
+
+        uint8_t * pData = gPixelData[mIndex];
+        while (pixels.has(1)) {
+            *pData++ = pixels.loadAndScale0();
+            *pData++ = pixels.loadAndScale1();
+            *pData++ = pixels.loadAndScale2();
+            pixels.advanceData();
+            pixels.stepDithering();
+        }
+        gPixelCount[mIndex] = pixels.size();
     }
     
     // -- Show pixels
@@ -587,11 +512,9 @@ protected:
             xSemaphoreTake(gTX_sem, portMAX_DELAY);
         }
         
-        // -- Initialize the local state, save a pointer to the pixel
-        //    data. We need to make a copy because pixels is a local
-        //    variable in the calling function, and this data structure
-        //    needs to outlive this call to showPixels.
-        (*mPixels) = pixels;
+        // -- Scale this strip's pixel data into its buffer, where it
+        //    stays until all of it has been sent
+        loadPixelData(pixels);
         
         // -- Keep track of the number of strips we've seen
         ++gNumStarted;
@@ -607,6 +530,7 @@ protected:
               empty((uint32_t*)dmaBuffers[i]->buffer);
             }
             gCurBuffer = 0;
+            gCurPixel = 0;
             gDoneFilling = false;
 #if FASTLED_ESP32_I2S_NUM_DMA_BUFFERS>2
             // reset buffer counter (sometimes this value != 0 after last send, why?)
@@ -663,103 +587,56 @@ protected:
     
     /** Fill DMA buffer
      *
-     *  This is where the real work happens: take a row of pixels (one
-     *  from each strip), transpose and encode the bits, and store
-     *  them in the DMA buffer for the I2S peripheral to read.
+     *  This is where the real work happens: take a block of rows of
+     *  pixels (one pixel from each strip per row), transpose and encode
+     *  the bits, and store them in the DMA buffer for the I2S peripheral
+     *  to read. A buffer that runs out of pixel data part way through
+     *  is shortened to the pixels it has.
      */
     static void fillBuffer()
     {
         // -- Alternate between buffers
-        volatile uint32_t * buf = (uint32_t *) dmaBuffers[gCurBuffer]->buffer;
+        DMABuffer * pBuffer = dmaBuffers[gCurBuffer];
+        volatile uint32_t * buf = (uint32_t *) pBuffer->buffer;
         gCurBuffer = (gCurBuffer + 1) % NUM_DMA_BUFFERS;
         
-        // -- Get the requested pixel from each controller. Store the
-        //    data for each color channel in a separate array.
-        uint32_t has_data_mask = 0;
-        for (int i = 0; i < gNumControllers; ++i) {
-            // -- Store the pixels in reverse controller order starting at index 23
-            //    This causes the bits to come out in the right position after we
-            //    transpose them.
-            int bit_index = 23-i;
-            ClocklessController * pController = static_cast<ClocklessController*>(gControllers[i]);
-            if (pController->mPixels->has(1)) {
-                gPixelRow[0][bit_index] = pController->mPixels->loadAndScale0();
-                gPixelRow[1][bit_index] = pController->mPixels->loadAndScale1();
-                gPixelRow[2][bit_index] = pController->mPixels->loadAndScale2();
-                pController->mPixels->advanceData();
-                pController->mPixels->stepDithering();
-                
-                // -- Record that this controller still has data to send
-                has_data_mask |= (1 << (i+8));
+        int nPixels = 0;
+        while (nPixels < gPixelsPerBuffer) {
+            // -- Get the next pixel from each strip. Store the data for
+            //    each color channel in a separate array.
+            uint32_t has_data_mask = 0;
+            for (int i = 0; i < gNumControllers; ++i) {
+                if (gCurPixel < gPixelCount[i]) {
+                    const uint8_t * pixel = gPixelData[i] + gCurPixel * NUM_COLOR_CHANNELS;
+                    gPixelRow[0][i] = pixel[0];
+                    gPixelRow[1][i] = pixel[1];
+                    gPixelRow[2][i] = pixel[2];
+
+                    // -- Record that this strip still has data to send
+                    has_data_mask |= (1 << (i+8));
+                }
+            }
+
+            // -- None of the strips has data? We are done.
+            if (has_data_mask == 0) {
+                break;
             }
+
+            // -- Transpose and encode the pixel data for the DMA buffer
+            i2s_encode_pixel(gPixelRow, NUM_COLOR_CHANNELS, has_data_mask, buf + nPixels * gPulsesPerPixel,
+                             gPulsesPerBit, ones_for_zero, ones_for_one);
+            ++gCurPixel;
+            ++nPixels;
         }
-        
-        // -- None of the strips has data? We are done.
-        if (has_data_mask == 0) {
+
+        if (nPixels == 0) {
             gDoneFilling = true;
             return;
         }
+        pBuffer->descriptor.length = 4 * gPulsesPerPixel * nPixels;
 #if FASTLED_ESP32_I2S_NUM_DMA_BUFFERS>2
         gCntBuffer++;
 #endif        
-        // -- Transpose and encode the pixel data for the DMA buffer
-        // int buf_index = 0;
-        for (int channel = 0; channel < NUM_COLOR_CHANNELS; ++channel) {
-            
-            // -- Tranpose each array: all the bit 7's, then all the bit 6's, ...
-            transpose32(gPixelRow[channel], gPixelBits[channel][0] );
-            
-            //Serial.print("Channel: "); Serial.print(channel); Serial.print(" ");
-            for (int bitnum = 0; bitnum < 8; ++bitnum) {
-                uint8_t * row = (uint8_t *) (gPixelBits[channel][bitnum]);
-                uint32_t bit = (row[0] << 24) | (row[1] << 16) | (row[2] << 8) | row[3];
-                
-               /* SZG: More general, but too slow:
-                    for (int pulse_num = 0; pulse_num < gPulsesPerBit; ++pulse_num) {
-                        buf[buf_index++] = has_data_mask & ( (bit & gOneBit[pulse_num]) | (~bit & gZeroBit[pulse_num]) );
-                     }
-               */
-
-                // -- Only fill in the pulses that are different between the "0" and "1" encodings
-                for(int pulse_num = ones_for_zero; pulse_num < ones_for_one; ++pulse_num) {
-                    buf[bitnum*gPulsesPerBit+channel*8*gPulsesPerBit+pulse_num] = has_data_mask & bit;
-                }
-            }
-        }
-    }
-    
-    static void transpose32(uint8_t * pixels, uint8_t * bits)
-    {
-        transpose8rS32(& pixels[0],  1, 4, & bits[0]);
-        transpose8rS32(& pixels[8],  1, 4, & bits[1]);
-        transpose8rS32(& pixels[16], 1, 4, & bits[2]);
-        //transpose8rS32(& pixels[24], 1, 4, & bits[3]);  Can only use 24 bits
-    }
-    
-    /** Transpose 8x8 bit matrix
-     *  From Hacker's Delight
-     */
-    static void transpose8rS32(uint8_t * A, int m, int n, uint8_t * B)
-    {
-        uint32_t x, y, t;
-        
-        // Load the array and pack it into x and y.
-        
-        x = (A[0]<<24)   | (A[m]<<16)   | (A[2*m]<<8) | A[3*m];
-        y = (A[4*m]<<24) | (A[5*m]<<16) | (A[6*m]<<8) | A[7*m];
-        
-        t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
-        t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
-        
-        t = (x ^ (x >>14)) & 0x0000CCCC;  x = x ^ t ^ (t <<14);
-        t = (y ^ (y >>14)) & 0x0000CCCC;  y = y ^ t ^ (t <<14);
-        
-        t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
-        y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
-        x = t;
-        
-        B[0]=x>>24;    B[n]=x>>16;    B[2*n]=x>>8;  B[3*n]=x;
-        B[4*n]=y>>24;  B[5*n]=y>>16;  B[6*n]=y>>8;  B[7*n]=y;
     }
     
     /** Start I2S transmission
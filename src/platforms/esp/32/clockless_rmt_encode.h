@@ -0,0 +1,102 @@
+/*
+ * Encoding of pixel data into RMT items for the ESP32 RMT driver
+ *
+ * These functions don't touch the RMT peripheral, or depend on the
+ * ESP-IDF: an RMT item is handled as the 32 bit value of an
+ * rmt_item32_t. That lets the encoding be checked on the host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+FASTLED_NAMESPACE_BEGIN
+
+// -- Number of RMT items for each byte of pixel data: one per bit
+#define RMT_ITEMS_PER_BYTE 8
+
+// -- Number of RMT items for each nibble of pixel data
+#define RMT_ITEMS_PER_NIBBLE 4
+
+// -- Table of the RMT items for each nibble of pixel data
+//    Built once from the items for a zero and a one bit, so that
+//    encoding a byte is two copies of four items rather than a branch
+//    for every bit. A table for whole bytes would take 8K per
+//    controller, this one takes 256 bytes.
+typedef uint32_t rmt_nibble_table_t[16][RMT_ITEMS_PER_NIBBLE];
+
+// -- Encode one byte of pixel data into RMT items, a bit at a time
+//    Bits go out MSB first, each one as the item for a zero or a one bit.
+//    This is the reference for the tables built by rmt_build_nibble_table.
+__attribute__ ((always_inline)) inline static void rmt_encode_byte(uint8_t byteval, uint32_t * dest, uint32_t zero, uint32_t one)
+{
+    for (int j = 0; j < RMT_ITEMS_PER_BYTE; j++) {
+        dest[j] = (byteval & 0x80) ? one : zero;
+        byteval <<= 1;
+    }
+}
+
+// -- Build the table of RMT items for each nibble
+inline static void rmt_build_nibble_table(rmt_nibble_table_t table, uint32_t zero, uint32_t one)
+{
+    for (int nibble = 0; nibble < 16; nibble++) {
+        uint32_t items[RMT_ITEMS_PER_BYTE];
+        rmt_encode_byte(nibble << 4, items, zero, one);
+        for (int j = 0; j < RMT_ITEMS_PER_NIBBLE; j++) {
+            table[nibble][j] = items[j];
+        }
+    }
+}
+
+// -- Encode one byte of pixel data into RMT items, from the nibble table
+//    This is a template so that dest can be volatile, for writing
+//    straight into the RMT memory.
+template <typename ITEM>
+__attribute__ ((always_inline)) inline static void rmt_encode_byte(uint8_t byteval, ITEM * dest, const rmt_nibble_table_t table)
+{
+    const uint32_t * hi = table[byteval >> 4];
+    const uint32_t * lo = table[byteval & 0x0F];
+    dest[0] = hi[0];
+    dest[1] = hi[1];
+    dest[2] = hi[2];
+    dest[3] = hi[3];
+    dest[4] = lo[0];
+    dest[5] = lo[1];
+    dest[6] = lo[2];
+    dest[7] = lo[3];
+}
+
+// -- Encode as much pixel data as fits into a block of RMT items
+//    This has the same contract as an ESP-IDF RMT translator
+//    (sample_to_rmt_t), so that the built-in driver can call it to
+//    convert pixel data on demand, as it refills the RMT memory:
+//    whole bytes are encoded, as many as there are and as fit in
+//    the space for items.
+//      src             -- the pixel data left to send
+//      src_size        -- the number of bytes of it
+//      dest            -- where the items go
+//      wanted_num      -- the space for items
+//      table           -- the items for each nibble
+//      translated_size -- set to the number of bytes encoded
+//      item_num        -- set to the number of items written
+//    It's called from the translator, in IRAM, so it's always inlined
+//    to keep it out of flash.
+__attribute__ ((always_inline)) inline static void rmt_encode_bytes(const uint8_t * src, size_t src_size, uint32_t * dest, size_t wanted_num,
+                                    const rmt_nibble_table_t table, size_t * translated_size, size_t * item_num)
+{
+    size_t nBytes = wanted_num / RMT_ITEMS_PER_BYTE;
+    if (src == NULL || nBytes > src_size) {
+        nBytes = (src == NULL) ? 0 : src_size;
+    }
+
+    for (size_t i = 0; i < nBytes; i++) {
+        rmt_encode_byte(src[i], dest, table);
+        dest += RMT_ITEMS_PER_BYTE;
+    }
+
+    *translated_size = nBytes;
+    *item_num = nBytes * RMT_ITEMS_PER_BYTE;
+}
+
+FASTLED_NAMESPACE_END
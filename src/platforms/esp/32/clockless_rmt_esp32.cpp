@@ -34,6 +34,10 @@ CMinWait<50>   gWait;
 
 static bool gInitialized = false;
 
+// -- Set while a show is still being written out in the background
+//    (see FastLED.setAsyncShow)
+static bool gTXPending = false;
+
 // -- Stored values for FASTLED_RMT_MAX_CHANNELS and FASTLED_RMT_MEM_BLOCKS
 int ESP32RMTController::gMaxChannel;
 int ESP32RMTController::gMemBlocks;
@@ -69,6 +73,10 @@ ESP32RMTController::ESP32RMTController(int DATA_PIN, int T1, int T2, int T3, int
     mZero.level1 = 0;
     mZero.duration1 = ESP_TO_RMT_CYCLES(T2+T3); // TO_RMT_CYCLES(T2 + T3);
 
+    // -- Precompute the items for each nibble, so that encoding pixel
+    //    data is a copy rather than a branch for every bit
+    rmt_build_nibble_table(mNibbles, mZero.val, mOne.val);
+
     gControllers[gNumControllers] = this;
     gNumControllers++;
 
@@ -133,6 +141,10 @@ void ESP32RMTController::init(gpio_num_t pin)
 
         if (FASTLED_RMT_BUILTIN_DRIVER) {
             rmt_driver_install(rmt_channel_t(i), 0, 0);
+#if FASTLED_RMT_BUILTIN_STREAMING
+            // -- Have the driver convert the pixel data as it goes
+            rmt_translator_init(rmt_channel_t(i), translateToRMT);
+#endif
         } else {
             // -- Set up the RMT to send 32 bits of the pulse buffer and then
             //    generate an interrupt. When we get this interrupt we
@@ -161,9 +173,11 @@ void ESP32RMTController::init(gpio_num_t pin)
     (void)espErr;
 }
 
-// -- Show this string of pixels
-//    This is the main entry point for the pixel controller
-void IRAM_ATTR ESP32RMTController::showPixels()
+// -- Start showing this string of pixels
+//    This is the main entry point for the pixel controller. The last
+//    controller to get here starts all of them; it does not wait for
+//    the data to be sent (see waitForShowComplete)
+void IRAM_ATTR ESP32RMTController::beginShowPixels()
 {
     if (gNumStarted == 0) {
         // -- First controller: make sure everything is set up
@@ -198,26 +212,38 @@ void IRAM_ATTR ESP32RMTController::showPixels()
             channel += gMemBlocks;
         }
 
-        // -- Wait here while the data is sent. The interrupt handler
-        //    will keep refilling the RMT buffers until it is all
-        //    done; then it gives the semaphore back.
-        xSemaphoreTake(gTX_sem, portMAX_DELAY);
-        xSemaphoreGive(gTX_sem);
+        // -- Reset the counters for the next round of showPixels calls.
+        //    The interrupt handler keeps refilling the RMT buffers in
+        //    the background until all of the data is sent.
+        gNumStarted = 0;
+        gTXPending = true;
+    }
+}
+
+// -- Wait for the current show to finish
+//    The interrupt handler gives the semaphore back once all of the
+//    data has been sent.
+void ESP32RMTController::waitForShowComplete()
+{
+    if (!gTXPending) {
+        return;
+    }
 
-        // -- Make sure we don't call showPixels too quickly
-        gWait.mark();
+    xSemaphoreTake(gTX_sem, portMAX_DELAY);
+    xSemaphoreGive(gTX_sem);
 
-        // -- Reset the counters
-        gNumStarted = 0;
-        gNumDone = 0;
-        gNext = 0;
+    // -- Make sure we don't call showPixels too quickly
+    gWait.mark();
+
+    // -- Reset the counters
+    gNumDone = 0;
+    gNext = 0;
+    gTXPending = false;
 
 #if FASTLED_ESP32_FLASH_LOCK == 1
-        // -- Release the lock on flash operations
-        spi_flash_op_unlock();
+    // -- Release the lock on flash operations
+    spi_flash_op_unlock();
 #endif
-
-    }
 }
 
 // -- Start up the next controller
@@ -257,7 +283,14 @@ void IRAM_ATTR ESP32RMTController::startOnChannel(int channel)
     if (FASTLED_RMT_BUILTIN_DRIVER) {
         // -- Use the built-in RMT driver to send all the data in one shot
         rmt_register_tx_end_callback(doneOnChannel, 0);
+#if FASTLED_RMT_BUILTIN_STREAMING
+        // -- The driver calls translateToRMT to convert the pixel data
+        //    a block at a time, as it refills the RMT memory
+        rmt_translator_set_context(mRMT_channel, this);
+        rmt_write_sample(mRMT_channel, mPixelData, mSize, false);
+#else
         rmt_write_items(mRMT_channel, mBuffer, mBufferSize, false);
+#endif
     } else {
         // -- Use our custom driver to send the data incrementally
 
@@ -489,28 +522,17 @@ void IRAM_ATTR ESP32RMTController::fillNext(bool check_time)
     }
     mLastFill = now;
 
-    // -- Get the zero and one values into local variables
-    FASTLED_REGISTER uint32_t one_val = mOne.val;
-    FASTLED_REGISTER uint32_t zero_val = mZero.val;
-
     // -- Use locals for speed
     volatile FASTLED_REGISTER uint32_t * pItem =  mRMT_mem_ptr;
 
     for (FASTLED_REGISTER int i = 0; i < PULSES_PER_FILL/8; i++) {
         if (mCur < mSize) {
 
-            // -- Get the next four bytes of pixel data
-            FASTLED_REGISTER uint32_t pixeldata = mPixelData[mCur] << 24;
+            // -- Copy the items for the next byte of pixel data, MSB first,
+            //    from the nibble table into RMTMEM.chan[n].data32[x]
+            rmt_encode_byte(mPixelData[mCur], pItem, mNibbles);
+            pItem += RMT_ITEMS_PER_BYTE;
             mCur++;
-            
-            // Shift bits out, MSB first, setting RMTMEM.chan[n].data32[x] to the 
-            // rmt_item32_t value corresponding to the buffered bit value
-            for (FASTLED_REGISTER uint32_t j = 0; j < 8; j++) {
-                *pItem++ = (pixeldata & 0x80000000L) ? one_val : zero_val;
-                // Replaces: RMTMEM.chan[mRMT_channel].data32[mCurPulse].val = val;
-
-                pixeldata <<= 1;
-            }
         } else {
             // -- No more data; signal to the RMT we are done by filling the
             //    rest of the buffer with zeros
@@ -535,11 +557,13 @@ void IRAM_ATTR ESP32RMTController::fillNext(bool check_time)
 //    This function is only used when the built-in RMT driver is chosen
 void ESP32RMTController::initPulseBuffer(int size_in_bytes)
 {
-    if (mBuffer == 0) {
-        // -- Each byte has 8 bits, each bit needs a 32-bit RMT item
-        mBufferSize = size_in_bytes * 8 * 4;
-        mBuffer = (rmt_item32_t *) calloc( mBufferSize, sizeof(rmt_item32_t));
+    // -- Each byte has 8 bits, each bit needs a 32-bit RMT item
+    int items = size_in_bytes * RMT_ITEMS_PER_BYTE;
+    if (mBuffer == 0 || mBufferSize < items) {
+        free(mBuffer);
+        mBuffer = (rmt_item32_t *) calloc( items, sizeof(rmt_item32_t));
     }
+    mBufferSize = items;
     mCurPulse = 0;
 }
 
@@ -548,12 +572,29 @@ void ESP32RMTController::initPulseBuffer(int size_in_bytes)
 void ESP32RMTController::convertByte(uint32_t byteval)
 {
     // -- Write one byte's worth of RMT pulses to the big buffer
-    byteval <<= 24;
-    for (FASTLED_REGISTER uint32_t j = 0; j < 8; j++) {
-        mBuffer[mCurPulse] = (byteval & 0x80000000L) ? mOne : mZero;
-        byteval <<= 1;
-        mCurPulse++;
-    }
+    rmt_encode_byte(byteval, (uint32_t *) &mBuffer[mCurPulse], mNibbles);
+    mCurPulse += RMT_ITEMS_PER_BYTE;
+}
+
+// -- Translate pixel data into RMT pulses
+//    The built-in driver calls this to fill the RMT memory, first
+//    from rmt_write_sample and then from its interrupt handler.
+void IRAM_ATTR ESP32RMTController::translateToRMT(const void * src, rmt_item32_t * dest, size_t src_size,
+                                                  size_t wanted_num, size_t * translated_size, size_t * item_num)
+{
+#if FASTLED_RMT_BUILTIN_STREAMING
+    // -- The context has to be looked up before item_num is written,
+    //    since the driver finds the channel from it
+    void * context = NULL;
+    rmt_translator_get_context(item_num, &context);
+    ESP32RMTController * pController = (ESP32RMTController *) context;
+
+    rmt_encode_bytes((const uint8_t *) src, src_size, (uint32_t *) dest, wanted_num,
+                     pController->mNibbles, translated_size, item_num);
+#else
+    *translated_size = 0;
+    *item_num = 0;
+#endif
 }
 
 #endif // ! FASTLED_ESP32_I2S
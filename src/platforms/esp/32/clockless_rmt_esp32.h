@@ -51,12 +51,18 @@
  *
  *      #define FASTLED_RMT_BUILTIN_DRIVER 1
  *
- * There may be a performance penalty for using this mode. We need to
- * compute the RMT signal for the entire LED strip ahead of time,
- * rather than overlapping it with communication. We also need a large
- * buffer to hold the signal specification. Each bit of pixel data is
- * represented by a 32-bit pulse specification, so it is a 32X blow-up
- * in memory use.
+ * In this mode the pixel data is converted into RMT pulses on demand,
+ * by a translator that the core driver calls as it refills the RMT
+ * memory, so it only needs the same 3 bytes per pixel as our own
+ * driver. The translator needs rmt_translator_get_context(), which
+ * came with ESP-IDF 4.3. With older versions, or with the following
+ * directive, the RMT signal for the entire LED strip is computed ahead
+ * of time instead, rather than overlapping it with communication. That
+ * needs a large buffer to hold the signal specification. Each bit of
+ * pixel data is represented by a 32-bit pulse specification, so it is
+ * a 32X blow-up in memory use (96 bytes per pixel):
+ *
+ *      #define FASTLED_RMT_BUILTIN_STREAMING 0
  *
  * NEW: Use of Flash memory on the ESP32 can interfere with the timing
  *      of pixel output. The ESP-IDF system code disables all other
@@ -113,6 +119,8 @@
 
 #pragma once
 
+#include "clockless_rmt_encode.h"
+
 FASTLED_NAMESPACE_BEGIN
 
 #ifdef __cplusplus
@@ -216,6 +224,17 @@ __attribute__ ((always_inline)) inline static uint32_t __clock_cycles() {
 #define FASTLED_RMT_BUILTIN_DRIVER false
 #endif
 
+// -- With the core driver, convert the pixel data as it is sent, or
+//    all of it up front. Converting as it is sent needs the translator
+//    context, added in ESP-IDF 4.3.
+#ifndef FASTLED_RMT_BUILTIN_STREAMING
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 3, 0)
+#define FASTLED_RMT_BUILTIN_STREAMING true
+#else
+#define FASTLED_RMT_BUILTIN_STREAMING false
+#endif
+#endif
+
 // -- Max number of controllers we can support
 #ifndef FASTLED_RMT_MAX_CONTROLLERS
 #define FASTLED_RMT_MAX_CONTROLLERS 32
@@ -249,6 +268,9 @@ private:
     rmt_item32_t   mZero;
     rmt_item32_t   mOne;
 
+    // -- The items for each nibble of pixel data, built from mZero and mOne
+    rmt_nibble_table_t mNibbles;
+
     // -- Total expected time to send 32 bits
     //    Each strip should get an interrupt roughly at this interval
     uint32_t       mCyclesPerFill;
@@ -267,9 +289,9 @@ private:
     int                 mWhichHalf;
 
     // -- Buffer to hold all of the pulses. For the version that uses
-    //    the RMT driver built into the ESP core.
+    //    the RMT driver built into the ESP core, without streaming.
     rmt_item32_t * mBuffer;
-    uint16_t       mBufferSize; // bytes
+    int            mBufferSize; // items
     int            mCurPulse;
 
     // -- These values need to be real variables, so we can access them
@@ -295,9 +317,15 @@ public:
     //    because we need to configure the RMT channels on the fly.
     static void init(gpio_num_t pin);
 
-    // -- Show this string of pixels
-    //    This is the main entry point for the pixel controller
-    void IRAM_ATTR showPixels();
+    // -- Start showing this string of pixels
+    //    This is the main entry point for the pixel controller. The
+    //    last controller to be started kicks off all of them at once.
+    void IRAM_ATTR beginShowPixels();
+
+    // -- Wait for the current show to finish
+    //    Returns immediately if nothing is being sent. All of the
+    //    controllers go out together, so this is static.
+    static void waitForShowComplete();
 
     // -- Start up the next controller
     //    This method is static so that it can dispatch to the
@@ -344,6 +372,13 @@ public:
     // -- Convert a byte into RMT pulses
     //    This function is only used when the built-in RMT driver is chosen
     void convertByte(uint32_t byteval);
+
+    // -- Translate pixel data into RMT pulses
+    //    Called by the built-in RMT driver as it refills the RMT memory,
+    //    with the controller as the translator context. This function is
+    //    only used with FASTLED_RMT_BUILTIN_STREAMING.
+    static void IRAM_ATTR translateToRMT(const void * src, rmt_item32_t * dest, size_t src_size,
+                                         size_t wanted_num, size_t * translated_size, size_t * item_num);
 };
 
 template <int DATA_PIN, int T1, int T2, int T3, EOrder RGB_ORDER = RGB, int XTRA0 = 0, bool FLIP = false, int WAIT_TIME = 5>
@@ -369,6 +404,22 @@ public:
 
     virtual uint16_t getMaxRefreshRate() const { return 400; }
 
+    // -- All of the strips go out together, started by the last
+    //    one, so none of them can be skipped on its own
+    virtual bool canSkipShow() const { return false; }
+
+    // -- Wait for the data from the last show to be sent
+    virtual void waitForShowComplete()
+    {
+        ESP32RMTController::waitForShowComplete();
+    }
+
+    // -- Finish a two phase show: wait for all of the strips
+    virtual void endShow()
+    {
+        ESP32RMTController::waitForShowComplete();
+    }
+
 protected:
 
     // -- Load pixel data
@@ -396,19 +447,32 @@ protected:
     //    This is the main entry point for the controller.
     virtual void showPixels(PixelController<RGB_ORDER> & pixels)
     {
-        if (FASTLED_RMT_BUILTIN_DRIVER) {
+        beginShowPixels(pixels);
+        endShow();
+    }
+
+    // -- Start showing pixels
+    //    Encodes the data and hands it to the RMT, without waiting for
+    //    it to be sent.
+    virtual void beginShowPixels(PixelController<RGB_ORDER> & pixels)
+    {
+        // -- The interrupt handler may still be reading the buffers
+        //    from an asynchronous show
+        ESP32RMTController::waitForShowComplete();
+
+        if (FASTLED_RMT_BUILTIN_DRIVER && ! FASTLED_RMT_BUILTIN_STREAMING) {
             convertAllPixelData(pixels);
         } else {
             loadPixelData(pixels);
         }
 
-        mRMTController.showPixels();
+        mRMTController.beginShowPixels();
     }
 
     // -- Convert all pixels to RMT pulses
     //    This function is only used when the user chooses to use the
-    //    built-in RMT driver, which needs all of the RMT pulses
-    //    up-front.
+    //    built-in RMT driver without streaming, which needs all of the
+    //    RMT pulses up-front.
     void convertAllPixelData(PixelController<RGB_ORDER> & pixels)
     {
         // -- Make sure the data buffer is allocated
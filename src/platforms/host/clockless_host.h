@@ -0,0 +1,103 @@
+#ifndef __INC_CLOCKLESS_HOST_H
+#define __INC_CLOCKLESS_HOST_H
+
+FASTLED_NAMESPACE_BEGIN
+
+#define FASTLED_HAS_CLOCKLESS 1
+
+/// Clockless controller for the host platform.  Instead of bit-banging, each scaled and
+/// dithered byte is recorded on the data pin's HostWire, along with the pulse train that a
+/// real controller would emit for it (if pulse recording is turned on for that wire).
+/// Each bit is T1+T2+T3 ticks long: a 1 is high for T1+T2 and low for T3, a 0 is high for T1
+/// and low for T2+T3.  XTRA0 extra 0 bits follow each byte.
+/// With HostWire::simulateTiming() turned on, the controller behaves like a DMA driver: the frame is
+/// recorded right away, and the wire then stays busy for as long as the bits would take to send.
+template <int DATA_PIN, int T1, int T2, int T3, EOrder RGB_ORDER = RGB, int XTRA0 = 0, bool FLIP = false, int WAIT_TIME = 50>
+class ClocklessController : public CPixelLEDController<RGB_ORDER> {
+	HostWire *mWire;
+
+public:
+	ClocklessController() : mWire(NULL) {}
+
+	virtual void init() {
+		FastPin<DATA_PIN>::setOutput();
+		mWire = &HostWire::get(DATA_PIN);
+	}
+
+	virtual uint16_t getMaxRefreshRate() const { return 400; }
+
+	virtual void waitForShowComplete() {
+		if(mWire) { mWire->waitForTransmit(); }
+	}
+
+	virtual void endShow() { waitForShowComplete(); }
+
+protected:
+
+	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
+		beginShowPixels(pixels);
+		endShow();
+	}
+
+	virtual void beginShowPixels(PixelController<RGB_ORDER> & pixels) {
+		// don't overwrite a frame that's still being sent
+		mWire->waitForTransmit();
+
+		mWire->beginFrame();
+		showRGBInternal(*mWire, pixels);
+		mWire->endFrame();
+
+		if(mWire->simulatingTiming()) {
+			mWire->startTransmit(transmitMicros(pixels.size()));
+		}
+	}
+
+	/// How long it takes to clock out the given number of leds, in µs
+	static uint32_t transmitMicros(int nLeds) {
+		uint64_t ticks = (uint64_t)nLeds * 3 * (8+XTRA0) * (T1+T2+T3);
+		return (uint32_t)(ticks / (F_CPU / 1000000));
+	}
+
+	template<int BITS> __attribute__ ((always_inline)) inline static void writeBits(HostWire & wire, FASTLED_REGISTER uint8_t b) {
+		wire.writeByte(b);
+		if(wire.recordingPulses()) {
+			for(FASTLED_REGISTER uint32_t i = 0; i < BITS; ++i) {
+				if(i < 8 && (b & (0x80 >> i))) {
+					wire.writePulse(T1+T2, T3);
+				} else {
+					wire.writePulse(T1, T2+T3);
+				}
+			}
+		}
+	}
+
+	static void showRGBInternal(HostWire & wire, PixelController<RGB_ORDER> pixels) {
+		// Setup the pixel controller and load/scale the first byte.  Unlike the drivers for
+		// real hardware, this never reads past the last led, so it runs clean under ASan.
+		pixels.preStepFirstByteDithering();
+		FASTLED_REGISTER uint8_t b = pixels.has(1) ? pixels.loadAndScale0() : 0;
+
+		while(pixels.has(1)) {
+			pixels.stepDithering();
+
+			// Write first byte, read next byte
+			writeBits<8+XTRA0>(wire, b);
+			b = pixels.loadAndScale1();
+
+			// Write second byte, read 3rd byte
+			writeBits<8+XTRA0>(wire, b);
+			b = pixels.loadAndScale2();
+
+			// Write third byte, read 1st byte of next pixel (if there is one)
+			writeBits<8+XTRA0>(wire, b);
+			pixels.advanceData();
+			if(pixels.has(1)) {
+				b = pixels.loadAndScale0();
+			}
+		};
+	}
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef __INC_FASTLED_HOST_H
+#define __INC_FASTLED_HOST_H
+
+#include "host_wire.h"
+#include "fastpin_host.h"
+#include "fastspi_host.h"
+#include "clockless_host.h"
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef __INC_FASTPIN_HOST_H
+#define __INC_FASTPIN_HOST_H
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Simulated gpio registers for the host platform.  Each port is a plain 32 bit word of
+/// memory, so pin twiddling code (bit-banged spi, etc...) runs unmodified.
+template<int PORT> struct __HostGPIO {
+	static volatile uint32_t & r() { static volatile uint32_t reg = 0; return reg; }
+};
+
+template<uint8_t PIN, uint32_t MASK, int PORT> class _HOSTPIN {
+public:
+	typedef volatile uint32_t * port_ptr_t;
+	typedef uint32_t port_t;
+
+	inline static void setOutput() { }
+	inline static void setInput() { }
+
+	inline static void hi() __attribute__ ((always_inline)) { __HostGPIO<PORT>::r() |= MASK; }
+	inline static void lo() __attribute__ ((always_inline)) { __HostGPIO<PORT>::r() &= ~MASK; }
+	inline static void set(FASTLED_REGISTER port_t val) __attribute__ ((always_inline)) { __HostGPIO<PORT>::r() = val; }
+
+	inline static void strobe() __attribute__ ((always_inline)) { toggle(); toggle(); }
+
+	inline static void toggle() __attribute__ ((always_inline)) { __HostGPIO<PORT>::r() ^= MASK; }
+
+	inline static void hi(FASTLED_REGISTER port_ptr_t port) __attribute__ ((always_inline)) { *port |= MASK; }
+	inline static void lo(FASTLED_REGISTER port_ptr_t port) __attribute__ ((always_inline)) { *port &= ~MASK; }
+	inline static void fastset(FASTLED_REGISTER port_ptr_t port, FASTLED_REGISTER port_t val) __attribute__ ((always_inline)) { *port = val; }
+
+	inline static port_t hival() __attribute__ ((always_inline)) { return __HostGPIO<PORT>::r() | MASK; }
+	inline static port_t loval() __attribute__ ((always_inline)) { return __HostGPIO<PORT>::r() & ~MASK; }
+	inline static port_ptr_t port() __attribute__ ((always_inline)) { return &__HostGPIO<PORT>::r(); }
+	inline static port_t mask() __attribute__ ((always_inline)) { return MASK; }
+
+	inline static bool isset() __attribute__ ((always_inline)) { return (__HostGPIO<PORT>::r() & MASK) != 0; }
+};
+
+#define _FL_DEFPIN(PIN) template<> class FastPin<PIN> : public _HOSTPIN<PIN, ((uint32_t)1 << ((PIN) & 0x1F)), ((PIN) >> 5)> {};
+
+#define MAX_PIN 63
+_FL_DEFPIN(0); _FL_DEFPIN(1); _FL_DEFPIN(2); _FL_DEFPIN(3);
+_FL_DEFPIN(4); _FL_DEFPIN(5); _FL_DEFPIN(6); _FL_DEFPIN(7);
+_FL_DEFPIN(8); _FL_DEFPIN(9); _FL_DEFPIN(10); _FL_DEFPIN(11);
+_FL_DEFPIN(12); _FL_DEFPIN(13); _FL_DEFPIN(14); _FL_DEFPIN(15);
+_FL_DEFPIN(16); _FL_DEFPIN(17); _FL_DEFPIN(18); _FL_DEFPIN(19);
+_FL_DEFPIN(20); _FL_DEFPIN(21); _FL_DEFPIN(22); _FL_DEFPIN(23);
+_FL_DEFPIN(24); _FL_DEFPIN(25); _FL_DEFPIN(26); _FL_DEFPIN(27);
+_FL_DEFPIN(28); _FL_DEFPIN(29); _FL_DEFPIN(30); _FL_DEFPIN(31);
+_FL_DEFPIN(32); _FL_DEFPIN(33); _FL_DEFPIN(34); _FL_DEFPIN(35);
+_FL_DEFPIN(36); _FL_DEFPIN(37); _FL_DEFPIN(38); _FL_DEFPIN(39);
+_FL_DEFPIN(40); _FL_DEFPIN(41); _FL_DEFPIN(42); _FL_DEFPIN(43);
+_FL_DEFPIN(44); _FL_DEFPIN(45); _FL_DEFPIN(46); _FL_DEFPIN(47);
+_FL_DEFPIN(48); _FL_DEFPIN(49); _FL_DEFPIN(50); _FL_DEFPIN(51);
+_FL_DEFPIN(52); _FL_DEFPIN(53); _FL_DEFPIN(54); _FL_DEFPIN(55);
+_FL_DEFPIN(56); _FL_DEFPIN(57); _FL_DEFPIN(58); _FL_DEFPIN(59);
+_FL_DEFPIN(60); _FL_DEFPIN(61); _FL_DEFPIN(62); _FL_DEFPIN(63);
+
+#define SPI_DATA 11
+#define SPI_CLOCK 13
+
+#define HAS_HARDWARE_PIN_SUPPORT 1
+
+FASTLED_NAMESPACE_END
+
+#endif // __INC_FASTPIN_HOST_H
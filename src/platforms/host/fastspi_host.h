@@ -0,0 +1,109 @@
+#ifndef __INC_FASTSPI_HOST_H
+#define __INC_FASTSPI_HOST_H
+
+FASTLED_NAMESPACE_BEGIN
+
+/// SPI output for the host platform.  Nothing is clocked out anywhere - each byte is recorded
+/// on the HostWire for the data pin, with a select()/release() pair bracketing a frame.
+/// @note Single bits written with writeBit() (e.g. the SM16716 start bit) are recorded as
+/// a whole byte holding 0 or 1.
+template <uint8_t DATA_PIN, uint8_t CLOCK_PIN, uint32_t SPI_SPEED>
+class HostSPIOutput {
+	Selectable 	*m_pSelect;
+
+	static HostWire & wire() { return HostWire::get(DATA_PIN); }
+
+public:
+	HostSPIOutput() { m_pSelect = NULL; }
+	HostSPIOutput(Selectable *pSelect) { m_pSelect = pSelect; }
+	void setSelect(Selectable *pSelect) { m_pSelect = pSelect; }
+
+	void init() {
+		FastPin<DATA_PIN>::setOutput();
+		FastPin<CLOCK_PIN>::setOutput();
+		release();
+	}
+
+	// stop the SPI output.  Nothing to stop when recording
+	static void stop() { }
+
+	// wait until the SPI subsystem is ready for more data to write.  Recording never has to wait
+	static void wait() __attribute__((always_inline)) { }
+	static void waitFully() __attribute__((always_inline)) { wait(); }
+
+	static void writeByteNoWait(uint8_t b) __attribute__((always_inline)) { writeByte(b); }
+	static void writeBytePostWait(uint8_t b) __attribute__((always_inline)) { writeByte(b); wait(); }
+
+	static void writeWord(uint16_t w) __attribute__((always_inline)) { writeByte(w>>8); writeByte(w&0xFF); }
+
+	static void writeByte(uint8_t b) { wire().writeByte(b); }
+
+	// select the SPI output, starting a new frame on the wire
+	void select() {
+		wire().beginFrame();
+		if(m_pSelect != NULL) { m_pSelect->select(); }
+	}
+
+	// release the SPI line, finishing the frame on the wire
+	void release() {
+		if(m_pSelect != NULL) { m_pSelect->release(); }
+		wire().endFrame();
+	}
+
+	// Write out len bytes of the given value out over SPI.  Useful for quickly flushing, say, a line of 0's down the line.
+	void writeBytesValue(uint8_t value, int len) {
+		select();
+		writeBytesValueRaw(value, len);
+		release();
+	}
+
+	static void writeBytesValueRaw(uint8_t value, int len) {
+		while(len--) {
+			writeByte(value);
+		}
+	}
+
+	// write a block of len uint8_ts out.  Need to type this better so that explicit casts into the call aren't required.
+	// note that this template version takes a class parameter for a per-byte modifier to the data.
+	template <class D> void writeBytes(FASTLED_REGISTER uint8_t *data, int len) {
+		select();
+		uint8_t *end = data + len;
+		while(data != end) {
+			writeByte(D::adjust(*data++));
+		}
+		D::postBlock(len);
+		release();
+	}
+
+	// default version of writing a block of data out to the SPI port, with no data modifications being made
+	void writeBytes(FASTLED_REGISTER uint8_t *data, int len) { writeBytes<DATA_NOP>(data, len); }
+
+	// write a single bit out, which bit from the passed in byte is determined by template parameter
+	template <uint8_t BIT> inline static void writeBit(uint8_t b) {
+		writeByte((b >> BIT) & 0x01);
+	}
+
+	// write a block of uint8_ts out in groups of three.  len is the total number of uint8_ts to write out.  The template
+	// parameters indicate how many uint8_ts to skip at the beginning of each grouping, as well as a class specifying a per
+	// byte of data modification to be made.  (See DATA_NOP above)
+	template <uint8_t FLAGS, class D, EOrder RGB_ORDER>  __attribute__((noinline)) void writePixels(PixelController<RGB_ORDER> pixels) {
+		select();
+		int len = pixels.mLen;
+		while(pixels.has(1)) {
+			if(FLAGS & FLAG_START_BIT) {
+				writeBit<0>(1);
+			}
+			writeByte(D::adjust(pixels.loadAndScale0()));
+			writeByte(D::adjust(pixels.loadAndScale1()));
+			writeByte(D::adjust(pixels.loadAndScale2()));
+			pixels.advanceData();
+			pixels.stepDithering();
+		}
+		D::postBlock(len);
+		release();
+	}
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
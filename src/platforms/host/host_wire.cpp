@@ -0,0 +1,88 @@
+/// @file host_wire.cpp
+/// Output recording and timing functions for the host platform
+
+/// Disables pragma messages and warnings
+#define FASTLED_INTERNAL
+
+#include "FastLED.h"
+
+#if defined(FASTLED_HOST)
+
+#include <stdlib.h>
+#include <time.h>
+#include <sched.h>
+
+FASTLED_NAMESPACE_BEGIN
+
+void HostWire::writeByte(uint8_t b) {
+	if(mSize == mCapacity) {
+		mCapacity = mCapacity ? (mCapacity * 2) : 256;
+		mBytes = (uint8_t*)realloc(mBytes, mCapacity);
+	}
+	mBytes[mSize++] = b;
+}
+
+void HostWire::writePulse(uint16_t high, uint16_t low) {
+	if(mPulseCount == mPulseCapacity) {
+		mPulseCapacity = mPulseCapacity ? (mPulseCapacity * 2) : 256;
+		mPulses = (HostPulse*)realloc(mPulses, mPulseCapacity * sizeof(HostPulse));
+	}
+	mPulses[mPulseCount].high = high;
+	mPulses[mPulseCount].low = low;
+	++mPulseCount;
+}
+
+void HostWire::startTransmit(uint32_t us) {
+	mTransmitStart = micros();
+	mTransmitLength = us;
+	mTransmitting = true;
+}
+
+void HostWire::waitForTransmit() {
+	if(!mTransmitting) { return; }
+	uint32_t elapsed = micros() - mTransmitStart;
+	if(elapsed < mTransmitLength) {
+		delayMicroseconds(mTransmitLength - elapsed);
+	}
+	mTransmitting = false;
+}
+
+HostWire & HostWire::get(uint8_t pin) {
+	static HostWire wires[FASTLED_HOST_NUM_PINS];
+	return wires[pin % FASTLED_HOST_NUM_PINS];
+}
+
+FASTLED_NAMESPACE_END
+
+static uint64_t host_now_us() {
+	static uint64_t start = 0;
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	uint64_t now = ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+	if(start == 0) { start = now; }
+	return now - start;
+}
+
+extern "C" {
+
+// Both wrap at 32 bits, the same as they do on the microcontrollers
+unsigned long millis(void) { return (uint32_t)(host_now_us() / 1000); }
+
+unsigned long micros(void) { return (uint32_t)host_now_us(); }
+
+void delayMicroseconds(unsigned int us) {
+	struct timespec ts;
+	ts.tv_sec = us / 1000000;
+	ts.tv_nsec = (long)(us % 1000000) * 1000;
+	nanosleep(&ts, NULL);
+}
+
+void delay(unsigned long ms) {
+	while(ms--) { delayMicroseconds(1000); }
+}
+
+void yield(void) { sched_yield(); }
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef __INC_HOST_WIRE_H
+#define __INC_HOST_WIRE_H
+
+/// @file host_wire.h
+/// Recording "wire" used by the host platform's led controllers.  Every data pin has a
+/// HostWire that captures the bytes (and, optionally, the pulse train) of the most recent
+/// frame written out on it, so output can be checked byte-for-byte against known good data.
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Number of pins that the host platform simulates
+#define FASTLED_HOST_NUM_PINS 64
+
+/// A single clockless bit on the wire, expressed in F_CPU clock ticks
+struct HostPulse {
+	uint16_t high;  ///< time the line is held high
+	uint16_t low;   ///< time the line is held low afterwards
+};
+
+/// Captures the output of a controller for one data pin.  A frame begins with beginFrame(),
+/// and everything written until endFrame() is kept until the next frame starts.
+/// @note SPI chipsets that select/release the bus more than once per show() (e.g. SM16716)
+/// will only have their last transaction kept.
+class HostWire {
+	uint8_t *mBytes;        ///< recorded bytes for the current frame
+	int mSize;              ///< number of recorded bytes
+	int mCapacity;          ///< allocated size of mBytes
+	HostPulse *mPulses;     ///< recorded pulses for the current frame
+	int mPulseCount;        ///< number of recorded pulses
+	int mPulseCapacity;     ///< allocated size of mPulses
+	uint32_t mFrames;       ///< number of completed frames
+	bool mRecordPulses;     ///< whether clockless controllers should record pulse trains
+	bool mSimulateTiming;   ///< whether controllers should take as long as real hardware to write out
+	bool mTransmitting;     ///< whether a simulated transmission is in progress
+	uint32_t mTransmitStart;  ///< micros() at the start of the simulated transmission
+	uint32_t mTransmitLength; ///< length of the simulated transmission, in µs
+
+public:
+	HostWire() : mBytes(NULL), mSize(0), mCapacity(0), mPulses(NULL), mPulseCount(0), mPulseCapacity(0), mFrames(0), mRecordPulses(false),
+		mSimulateTiming(false), mTransmitting(false), mTransmitStart(0), mTransmitLength(0) {}
+
+	/// Start a new frame, discarding the data of the previous one
+	void beginFrame() { mSize = 0; mPulseCount = 0; }
+
+	/// Mark the current frame as complete
+	void endFrame() { ++mFrames; }
+
+	/// Record a byte of output
+	void writeByte(uint8_t b);
+
+	/// Record a single clockless bit
+	/// @param high ticks the line is high
+	/// @param low ticks the line is low
+	void writePulse(uint16_t high, uint16_t low);
+
+	/// Enable or disable recording of pulse trains by clockless controllers.  Off by default,
+	/// since a pulse per bit is a lot of memory for long strips.
+	void recordPulses(bool record) { mRecordPulses = record; }
+
+	/// Are pulse trains being recorded?
+	bool recordingPulses() const { return mRecordPulses; }
+
+	/// Enable or disable simulated transmit times.  When on, clockless controllers treat the wire as
+	/// busy for as long as the frame would have taken to clock out on real hardware, the same way a
+	/// DMA driver would, so the cost of show() (and the gain from overlapping strips) can be measured.
+	void simulateTiming(bool simulate) { mSimulateTiming = simulate; }
+
+	/// Are transmit times being simulated?
+	bool simulatingTiming() const { return mSimulateTiming; }
+
+	/// Mark the wire as busy transmitting, starting now
+	/// @param us how long the transmission takes, in µs
+	void startTransmit(uint32_t us);
+
+	/// Sleep until the simulated transmission in progress (if any) is done
+	void waitForTransmit();
+
+	/// The bytes recorded for the most recent frame
+	const uint8_t *bytes() const { return mBytes; }
+	/// The number of bytes recorded for the most recent frame
+	int size() const { return mSize; }
+
+	/// The pulses recorded for the most recent frame
+	const HostPulse *pulses() const { return mPulses; }
+	/// The number of pulses recorded for the most recent frame
+	int pulseCount() const { return mPulseCount; }
+
+	/// The number of frames written out on this wire
+	uint32_t frames() const { return mFrames; }
+
+	/// Drop all recorded data and reset the frame counter
+	void reset() { mSize = 0; mPulseCount = 0; mFrames = 0; }
+
+	/// Get the wire attached to a pin
+	/// @param pin the data pin
+	static HostWire & get(uint8_t pin);
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __INC_LED_SYSDEFS_HOST_H
+#define __INC_LED_SYSDEFS_HOST_H
+
+/// @file led_sysdefs_host.h
+/// System definitions for building FastLED natively on a desktop (Linux/macOS) host.
+/// There's no real hardware here - pins are simulated registers, and the SPI and
+/// clockless controllers record what they would have put on the wire (see host_wire.h)
+/// so that the color math and the show() pipeline can be profiled and checked off-target.
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef FASTLED_HOST
+#define FASTLED_HOST
+#endif
+
+// Use the host's own clock for millis()
+#define FASTLED_HAS_MILLIS
+
+// Simulated registers are plain memory
+typedef volatile uint32_t RoReg;
+typedef volatile uint32_t RwReg;
+typedef uint32_t prog_uint32_t;
+
+// No Arduino pin mapping functions on the host
+#define FASTLED_NO_PINMAP
+
+// All spi output goes through the recording spi class
+#define FASTLED_ALL_PINS_HARDWARE_SPI
+
+// The clock that the clockless timings (T1/T2/T3) are expressed in.  This only
+// determines the resolution of the recorded pulse trains.
+#ifndef F_CPU
+#define F_CPU 80000000
+#endif
+
+// Default to NOT using PROGMEM here
+#ifndef FASTLED_USE_PROGMEM
+# define FASTLED_USE_PROGMEM 0
+#endif
+
+// Nothing can interrupt a recording, so there's never a need to retry
+#ifndef FASTLED_ALLOW_INTERRUPTS
+# define FASTLED_ALLOW_INTERRUPTS 1
+# define INTERRUPT_THRESHOLD 0
+#endif
+
+#define FASTLED_ACCURATE_CLOCK
+
+#define cli()
+#define sei()
+
+#ifndef INPUT
+#define INPUT 0x0
+#endif
+#ifndef OUTPUT
+#define OUTPUT 0x1
+#endif
+
+/// @name Host timing functions
+/// Stand-ins for the Arduino core timing functions, implemented on top of the host's
+/// monotonic clock in host_wire.cpp.
+/// @{
+extern "C" {
+unsigned long millis(void);                      ///< Milliseconds since startup
+unsigned long micros(void);                      ///< Microseconds since startup
+void delay(unsigned long ms);                    ///< Sleep for the given number of milliseconds
+void delayMicroseconds(unsigned int us);         ///< Sleep for the given number of microseconds
+void yield(void);                                ///< Give up the rest of the time slice
+}
+/// @}
+
+#endif
@@ -10,7 +10,7 @@ FASTLED_NAMESPACE_BEGIN
 
 // POWER MANAGEMENT
 
-/// @name Power Usage Values
+/// Power usage values for DefaultPowerModel.
 /// These power usage values are approximate, and your exact readings
 /// will be slightly (10%?) different from these.
 ///
@@ -23,24 +23,19 @@ FASTLED_NAMESPACE_BEGIN
 /// However, this is good enough for most cases, and almost certainly better
 /// than no power management at all.
 ///
-/// You're welcome to adjust these values as needed; there may eventually be an API
-/// for changing these on the fly, but it saves codespace and RAM to have them
-/// be compile-time constants.
-/// @{
-static const uint8_t gRed_mW   = 16 * 5; ///< 16mA @ 5v = 80mW
-static const uint8_t gGreen_mW = 11 * 5; ///< 11mA @ 5v = 55mW
-static const uint8_t gBlue_mW  = 15 * 5; ///< 15mA @ 5v = 75mW
-static const uint8_t gDark_mW  =  1 * 5; ///<  1mA @ 5v =  5mW
-/// @}
+/// You're welcome to adjust these values as needed, at runtime, with
+/// DefaultPowerModel.setChannelPower(), or give individual controllers their
+/// own CPowerModel.
+CPowerModel DefaultPowerModel(16 * 5,  ///< 16mA @ 5v = 80mW
+                              11 * 5,  ///< 11mA @ 5v = 55mW
+                              15 * 5,  ///< 15mA @ 5v = 75mW
+                               1 * 5); ///<  1mA @ 5v =  5mW
 
 // Alternate calibration by RAtkins via pre-PSU wattage measurments;
 // these are all probably about 20%-25% too high due to PSU heat losses,
 // but if you're measuring wattage on the PSU input side, this may
 // be a better set of calibrations.  (WS2812B)
-//  static const uint8_t gRed_mW   = 100;
-//  static const uint8_t gGreen_mW =  48;
-//  static const uint8_t gBlue_mW  = 100;
-//  static const uint8_t gDark_mW  =  12;
+//  DefaultPowerModel.setChannelPower(100, 48, 100, 12);
 
 
 /// Debug Option: Set to 1 to enable the power limiting LED
@@ -57,9 +52,19 @@ static const uint8_t gMCU_mW  =  25 * 5; // 25mA @ 5v = 125 mW
 static uint8_t  gMaxPowerIndicatorLEDPinNumber = 0; // default = Arduino onboard LED pin.  set to zero to skip this.
 
 
+uint32_t CPowerModel::unscaledPower_mW(const uint32_t *sums, uint16_t numLeds) const
+{
+    // 64 bits, since the channel power is no longer limited to 8 bits
+    uint64_t red64   = (uint64_t)sums[0] * mRed_mW;
+    uint64_t green64 = (uint64_t)sums[1] * mGreen_mW;
+    uint64_t blue64  = (uint64_t)sums[2] * mBlue_mW;
+
+    return (uint32_t)((red64 >> 8) + (green64 >> 8) + (blue64 >> 8)) + ((uint32_t)mDark_mW * numLeds);
+}
+
 uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds ) //25354
 {
-    uint32_t red32 = 0, green32 = 0, blue32 = 0;
+    uint32_t sums[3] = { 0, 0, 0 };
     const CRGB* firstled = &(ledbuffer[0]);
     uint8_t* p = (uint8_t*)(firstled);
 
@@ -67,25 +72,34 @@ uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds )
 
     // This loop might benefit from an AVR assembly version -MEK
     while( count) {
-        red32   += *p++;
-        green32 += *p++;
-        blue32  += *p++;
+        sums[0] += *p++;
+        sums[1] += *p++;
+        sums[2] += *p++;
         --count;
     }
 
-    red32   *= gRed_mW;
-    green32 *= gGreen_mW;
-    blue32  *= gBlue_mW;
-
-    red32   >>= 8;
-    green32 >>= 8;
-    blue32  >>= 8;
-
-    uint32_t total = red32 + green32 + blue32 + (gDark_mW * numLeds);
+    return DefaultPowerModel.unscaledPower_mW(sums, numLeds);
+}
 
-    return total;
+/// Determines how many milliwatts a controller's leds would draw at max brightness (255),
+/// using the channel sums it has already gathered for this frame.
+static uint32_t calculate_unscaled_power_mW( CLEDController & controller)
+{
+    const CPowerModel *pModel = controller.getPowerModel();
+    if(pModel == NULL) { pModel = &DefaultPowerModel; }
+    // the sums cover every lane of a block controller, and a reversed strip's size is negative
+    return pModel->unscaledPower_mW(controller.getChannelSums(), abs(controller.size()));
 }
 
+/// Scales the target brightness down so that a demand of total_mW at max brightness stays under max_power_mW
+static uint8_t limit_brightness_for_power_mW(uint32_t total_mW, uint8_t target_brightness, uint32_t max_power_mW)
+{
+    uint32_t requested_power_mW = ((uint32_t)total_mW * target_brightness) / 256;
+    if(requested_power_mW <= max_power_mW) {
+        return target_brightness;
+    }
+    return (uint32_t)((uint8_t)(target_brightness) * (uint32_t)(max_power_mW)) / ((uint32_t)(requested_power_mW));
+}
 
 uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_V, uint32_t max_power_mA) {
 	return calculate_max_brightness_for_power_mW(ledbuffer, numLeds, target_brightness, max_power_V * max_power_mA);
@@ -94,14 +108,7 @@ uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t n
 uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_mW) {
  	uint32_t total_mW = calculate_unscaled_power_mW( ledbuffer, numLeds);
 
-	uint32_t requested_power_mW = ((uint32_t)total_mW * target_brightness) / 256;
-
-	uint8_t recommended_brightness = target_brightness;
-	if(requested_power_mW > max_power_mW) { 
-        recommended_brightness = (uint32_t)((uint8_t)(target_brightness) * (uint32_t)(max_power_mW)) / ((uint32_t)(requested_power_mW));
-	}
-
-	return recommended_brightness;
+	return limit_brightness_for_power_mW(total_mW, target_brightness, max_power_mW);
 }
 
 // sets brightness to
@@ -111,9 +118,12 @@ uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32
 {
     uint32_t total_mW = gMCU_mW;
 
+    // controllers on their own rail are limited by calculate_max_brightness_for_power_rails()
     CLEDController *pCur = CLEDController::head();
 	while(pCur) {
-        total_mW += calculate_unscaled_power_mW( pCur->leds(), pCur->size());
+        if(pCur->getPowerRail() == NULL) {
+            total_mW += calculate_unscaled_power_mW( *pCur);
+        }
 		pCur = pCur->next();
 	}
 
@@ -166,6 +176,46 @@ uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32
 }
 
 
+bool calculate_max_brightness_for_power_rails(uint8_t target_brightness)
+{
+    bool bRails = false;
+
+    CLEDController *pCur = CLEDController::head();
+    while(pCur) {
+        CPowerRail *pRail = pCur->getPowerRail();
+        if(pRail) {
+            pRail->mUnscaledPower_mW = 0;
+            bRails = true;
+        }
+        pCur = pCur->next();
+    }
+
+    if(!bRails) {
+        return false;
+    }
+
+    pCur = CLEDController::head();
+    while(pCur) {
+        CPowerRail *pRail = pCur->getPowerRail();
+        if(pRail) {
+            pRail->mUnscaledPower_mW += calculate_unscaled_power_mW( *pCur);
+        }
+        pCur = pCur->next();
+    }
+
+    pCur = CLEDController::head();
+    while(pCur) {
+        CPowerRail *pRail = pCur->getPowerRail();
+        if(pRail) {
+            // recomputed once per controller on the rail, which is cheap next to summing the leds
+            pRail->mBrightness = limit_brightness_for_power_mW(pRail->mUnscaledPower_mW, target_brightness, pRail->mMaxPower_mW);
+        }
+        pCur = pCur->next();
+    }
+
+    return true;
+}
+
 void set_max_power_indicator_LED( uint8_t pinNumber)
 {
     gMaxPowerIndicatorLEDPinNumber = pinNumber;
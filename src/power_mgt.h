@@ -15,6 +15,97 @@ FASTLED_NAMESPACE_BEGIN
 /// @{
 
 
+/// @name Power Models and Supply Rails
+/// By default every controller is assumed to draw the same current per channel (DefaultPowerModel),
+/// and all of them are limited together by CFastLED::setMaxPowerInMilliWatts().  Rigs that mix chipsets,
+/// or that feed groups of strips from separate supplies, can give each controller its own CPowerModel,
+/// and put controllers that share a supply on a CPowerRail with its own budget.
+/// @{
+
+/// Power drawn by one led of a given chipset.  The values can be changed at any time, e.g. after
+/// measuring a strip's actual draw.
+class CPowerModel {
+public:
+	uint16_t mRed_mW;    ///< power drawn by a led's red channel at full brightness
+	uint16_t mGreen_mW;  ///< power drawn by a led's green channel at full brightness
+	uint16_t mBlue_mW;   ///< power drawn by a led's blue channel at full brightness
+	uint16_t mDark_mW;   ///< power drawn by a led that is fully off
+
+	/// Create a power model
+	/// @param red_mW power drawn by the red channel at full brightness, in milliwatts
+	/// @param green_mW power drawn by the green channel at full brightness, in milliwatts
+	/// @param blue_mW power drawn by the blue channel at full brightness, in milliwatts
+	/// @param dark_mW power drawn by a led that is off, in milliwatts
+	CPowerModel(uint16_t red_mW, uint16_t green_mW, uint16_t blue_mW, uint16_t dark_mW)
+		: mRed_mW(red_mW), mGreen_mW(green_mW), mBlue_mW(blue_mW), mDark_mW(dark_mW) {}
+
+	/// Set the power drawn per channel
+	/// @param red_mW power drawn by the red channel at full brightness, in milliwatts
+	/// @param green_mW power drawn by the green channel at full brightness, in milliwatts
+	/// @param blue_mW power drawn by the blue channel at full brightness, in milliwatts
+	/// @param dark_mW power drawn by a led that is off, in milliwatts
+	void setChannelPower(uint16_t red_mW, uint16_t green_mW, uint16_t blue_mW, uint16_t dark_mW) {
+		mRed_mW = red_mW; mGreen_mW = green_mW; mBlue_mW = blue_mW; mDark_mW = dark_mW;
+	}
+
+	/// Set the current drawn per channel, as listed in most led datasheets
+	/// @param volts the voltage the leds are driven at
+	/// @param red_mA current drawn by the red channel at full brightness, in milliamps
+	/// @param green_mA current drawn by the green channel at full brightness, in milliamps
+	/// @param blue_mA current drawn by the blue channel at full brightness, in milliamps
+	/// @param dark_mA current drawn by a led that is off, in milliamps
+	void setChannelCurrent(uint8_t volts, uint16_t red_mA, uint16_t green_mA, uint16_t blue_mA, uint16_t dark_mA) {
+		setChannelPower(volts * red_mA, volts * green_mA, volts * blue_mA, volts * dark_mA);
+	}
+
+	/// Determines how many milliwatts leds would draw at max brightness (255)
+	/// @param sums the red, green, and blue values summed over all of the leds
+	/// @param numLeds the number of leds
+	/// @returns the number of milliwatts the leds would consume at max brightness
+	/// @see CLEDController::getChannelSums()
+	uint32_t unscaledPower_mW(const uint32_t *sums, uint16_t numLeds) const;
+};
+
+/// The power model used for controllers that haven't been given one.  Approximately a WS2812B
+/// at 5 volts: 16mA red, 11mA green, 15mA blue, and 1mA with the led off.
+extern CPowerModel DefaultPowerModel;
+
+/// A power supply shared by a group of controllers, with its own budget.  Controllers on a rail are
+/// limited together, independently of the global limit set with CFastLED::setMaxPowerInMilliWatts()
+/// (which then only covers controllers that aren't on a rail).
+/// @see CLEDController::setPowerRail()
+class CPowerRail {
+	friend bool calculate_max_brightness_for_power_rails(uint8_t target_brightness);
+	uint32_t mMaxPower_mW;      ///< the budget for this rail, in milliwatts
+	uint32_t mUnscaledPower_mW; ///< demand of the controllers on this rail at max brightness, for the current frame
+	uint8_t mBrightness;        ///< the limited brightness for the current frame
+
+public:
+	/// Create a rail
+	/// @param max_power_mW the max power draw for the rail, in milliwatts
+	CPowerRail(uint32_t max_power_mW = 0xFFFFFFFF) : mMaxPower_mW(max_power_mW), mUnscaledPower_mW(0), mBrightness(255) {}
+
+	/// Set the maximum power for the rail, given in volts and milliamps
+	/// @param volts the supply voltage (usually 5)
+	/// @param milliamps the maximum current the supply can deliver
+	void setMaxPowerInVoltsAndMilliamps(uint8_t volts, uint32_t milliamps) { setMaxPowerInMilliWatts(volts * milliamps); }
+
+	/// Set the maximum power for the rail, given in milliwatts
+	/// @param milliwatts the max power draw desired, in milliwatts
+	void setMaxPowerInMilliWatts(uint32_t milliwatts) { mMaxPower_mW = milliwatts; }
+
+	/// Get the maximum power for the rail
+	/// @returns the max power draw, in milliwatts
+	uint32_t getMaxPowerInMilliWatts() const { return mMaxPower_mW; }
+
+	/// Get the brightness the controllers on this rail were limited to for the last show
+	/// @returns the limited brightness
+	uint8_t getBrightness() const { return mBrightness; }
+};
+
+/// @} PowerModels
+
+
 /// @name Power Control Setup Functions
 /// Functions to initialize the power control system
 /// @{
@@ -99,6 +190,12 @@ uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t n
 /// but may be lower depending on the power limit.
 uint8_t  calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32_t max_power_mW);
 
+/// Determines the highest brightness level for each CPowerRail in use, given each rail's budget,
+/// and stores it in the rail.  Controllers that aren't on a rail are left to the global limit.
+/// @param target_brightness the brightness you'd ideally like to use
+/// @returns true if any controller is on a rail
+bool calculate_max_brightness_for_power_rails(uint8_t target_brightness);
+
 /// @} PowerInternal
 
 
@@ -0,0 +1,88 @@
+/// Disables pragma messages and warnings
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+#include <stdlib.h>
+
+/// @file xymap.cpp
+/// Compiled matrix layouts, see xymap.h
+
+FASTLED_NAMESPACE_BEGIN
+
+XYMap::XYMap(uint16_t width, uint16_t height) : mWidth(width), mHeight(height), mOwnsTable(true) {
+	mTable = (uint16_t*)malloc(getSize() * sizeof(uint16_t));
+	setRowMajor();
+}
+
+XYMap::XYMap(uint16_t width, uint16_t height, uint16_t *storage) : mWidth(width), mHeight(height), mTable(storage), mOwnsTable(false) {
+	setRowMajor();
+}
+
+XYMap::~XYMap() {
+	if(mOwnsTable) {
+		free(mTable);
+	}
+}
+
+void XYMap::rotate(uint16_t x, uint16_t y, uint8_t rotation, uint16_t & px, uint16_t & py) const {
+	// the physical matrix is height wide and width high for odd turns
+	switch(rotation & 0x3) {
+		case 0: px = x; py = y; break;
+		case 1: px = mHeight - 1 - y; py = x; break;
+		case 2: px = mWidth - 1 - x; py = mHeight - 1 - y; break;
+		case 3: px = y; py = mWidth - 1 - x; break;
+	}
+}
+
+XYMap & XYMap::setPanels(uint16_t panelWidth, uint16_t panelHeight, bool serpentine, bool serpentinePanels, uint8_t rotation) {
+	if(mTable == NULL) { return *this; }
+
+	uint16_t physWidth = (rotation & 0x1) ? mHeight : mWidth;
+	uint16_t physHeight = (rotation & 0x1) ? mWidth : mHeight;
+	if(panelWidth == 0 || panelWidth > physWidth) { panelWidth = physWidth; }
+	if(panelHeight == 0 || panelHeight > physHeight) { panelHeight = physHeight; }
+	uint16_t panelsAcross = physWidth / panelWidth;
+	uint32_t panelSize = (uint32_t)panelWidth * panelHeight;
+
+	uint16_t *p = mTable;
+	for(uint16_t y = 0; y < mHeight; ++y) {
+		for(uint16_t x = 0; x < mWidth; ++x) {
+			uint16_t px, py;
+			rotate(x, y, rotation, px, py);
+
+			uint16_t panelX = px / panelWidth;
+			uint16_t panelY = py / panelHeight;
+			uint16_t lx = px % panelWidth;
+			uint16_t ly = py % panelHeight;
+			if(serpentinePanels && (panelY & 0x1)) {
+				panelX = panelsAcross - 1 - panelX;
+			}
+			if(serpentine && (ly & 0x1)) {
+				lx = panelWidth - 1 - lx;
+			}
+
+			*p++ = ((uint32_t)panelY * panelsAcross + panelX) * panelSize + (uint32_t)ly * panelWidth + lx;
+		}
+	}
+	return *this;
+}
+
+XYMap & XYMap::setFunction(uint16_t (*xy)(uint16_t x, uint16_t y)) {
+	if(mTable == NULL) { return *this; }
+
+	uint16_t *p = mTable;
+	for(uint16_t y = 0; y < mHeight; ++y) {
+		for(uint16_t x = 0; x < mWidth; ++x) {
+			*p++ = xy(x, y);
+		}
+	}
+	return *this;
+}
+
+XYMap & XYMap::setTable(const uint16_t *table) {
+	if(mTable == NULL) { return *this; }
+
+	memcpy(mTable, table, getSize() * sizeof(uint16_t));
+	return *this;
+}
+
+FASTLED_NAMESPACE_END
@@ -0,0 +1,113 @@
+#ifndef __INC_XYMAP_H
+#define __INC_XYMAP_H
+
+/// @file xymap.h
+/// Compiled matrix layouts, mapping (x, y) coordinates to led indices with a table lookup
+
+#include "FastLED.h"
+
+FASTLED_NAMESPACE_BEGIN
+
+/// @defgroup XYMap Matrix Layout Maps
+/// Layouts of 2D led matrices, compiled into a table of led indices.
+/// @{
+
+/// The layout of a 2D led matrix, built once from a description (serpentine, tiled panels,
+/// rotated, or an arbitrary function or table) into a flat, row-major table of led indices.
+/// The 2D functions (blur2d(), blurBox2d(), fill_2dnoise8(), etc...) take an XYMap in place of
+/// calling an XY() function for every pixel:
+///
+///     XYMap xymap(32, 16);
+///     xymap.setSerpentine();
+///     leds[xymap(x, y)] = CRGB::Red;
+///     blur2d(leds, xymap, 64);
+///
+/// @note The table takes 2 bytes per pixel.  It's allocated on the heap, unless storage
+/// is passed to the constructor.  If the allocation fails, getTable() returns NULL and the
+/// 2D functions treat the matrix as row-major.
+class XYMap {
+	uint16_t mWidth;     ///< logical width of the matrix
+	uint16_t mHeight;    ///< logical height of the matrix
+	uint16_t *mTable;    ///< led index of each pixel, `mTable[y * mWidth + x]`
+	bool mOwnsTable;     ///< whether mTable was allocated by this map
+
+	// not copyable, the table is owned
+	XYMap(const XYMap &);
+	XYMap & operator=(const XYMap &);
+
+	/// Map a logical position to its position on the physical (unrotated) matrix
+	void rotate(uint16_t x, uint16_t y, uint8_t rotation, uint16_t & px, uint16_t & py) const;
+
+public:
+	/// Create a map, allocating its table.  The layout starts out row-major.
+	/// @param width the width of the matrix
+	/// @param height the height of the matrix
+	XYMap(uint16_t width, uint16_t height);
+
+	/// Create a map using the given storage for its table.  The layout starts out row-major.
+	/// @param width the width of the matrix
+	/// @param height the height of the matrix
+	/// @param storage width * height entries for the table
+	XYMap(uint16_t width, uint16_t height, uint16_t *storage);
+
+	~XYMap();
+
+	/// Lay the matrix out in rows, every row running the same way
+	/// @param rotation quarter turns clockwise that the matrix is mounted at, with
+	/// the width and height swapped for odd turns
+	/// @returns a reference to the map
+	XYMap & setRowMajor(uint8_t rotation = 0) { return setPanels(0, 0, false, false, rotation); }
+
+	/// Lay the matrix out in rows, alternating direction ("as the ox plows")
+	/// @param rotation quarter turns clockwise that the matrix is mounted at
+	/// @returns a reference to the map
+	XYMap & setSerpentine(uint8_t rotation = 0) { return setPanels(0, 0, true, false, rotation); }
+
+	/// Lay the matrix out as a grid of panels.  Each panel's leds are consecutive on the strip,
+	/// and the panels are chained a row of panels at a time.
+	/// @note The panel size has to divide the size of the (unrotated) matrix evenly
+	/// @param panelWidth the width of one panel (0 for a single panel)
+	/// @param panelHeight the height of one panel (0 for a single panel)
+	/// @param serpentine whether the rows within a panel alternate direction
+	/// @param serpentinePanels whether the rows of panels alternate direction
+	/// @param rotation quarter turns clockwise that the whole matrix is mounted at
+	/// @returns a reference to the map
+	XYMap & setPanels(uint16_t panelWidth, uint16_t panelHeight, bool serpentine, bool serpentinePanels, uint8_t rotation = 0);
+
+	/// Lay the matrix out with a function that maps coordinates to led indices.  It's called
+	/// once per pixel here, and never again.
+	/// @param xy the function
+	/// @returns a reference to the map
+	XYMap & setFunction(uint16_t (*xy)(uint16_t x, uint16_t y));
+
+	/// Lay the matrix out from a table of led indices, in row-major order
+	/// @param table width * height led indices, copied into the map
+	/// @returns a reference to the map
+	XYMap & setTable(const uint16_t *table);
+
+	/// Get the led index of a pixel.  No bounds checking is done.
+	/// @param x the column
+	/// @param y the row
+	/// @returns the led index
+	uint16_t operator()(uint16_t x, uint16_t y) const { return mTable ? mTable[(uint32_t)y * mWidth + x] : (uint16_t)((uint32_t)y * mWidth + x); }
+
+	/// @copydoc operator()()
+	uint16_t mapXY(uint16_t x, uint16_t y) const { return (*this)(x, y); }
+
+	/// Get the width of the matrix
+	uint16_t getWidth() const { return mWidth; }
+	/// Get the height of the matrix
+	uint16_t getHeight() const { return mHeight; }
+	/// Get the number of pixels in the matrix
+	uint32_t getSize() const { return (uint32_t)mWidth * mHeight; }
+
+	/// Get the table of led indices, `table[y * width + x]`
+	/// @returns the table, or NULL if it couldn't be allocated
+	const uint16_t *getTable() const { return mTable; }
+};
+
+/// @} XYMap
+
+FASTLED_NAMESPACE_END
+
+#endif
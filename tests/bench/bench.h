@@ -0,0 +1,58 @@
+#ifndef __INC_FASTLED_BENCH_H
+#define __INC_FASTLED_BENCH_H
+
+/// @file bench.h
+/// Timing for the host benchmarks.  Each benchmark is a program of its own that prints one line
+/// per case: the time per call, and per item where a call covers many (leds, bytes...).  Run them
+/// all with the `bench` target, on a Release build:
+///
+///     cmake -S . -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build --target bench
+
+#include <stdio.h>
+#include "FastLED.h"
+
+/// Shortest time to run each case for, in µs, so that the clock's resolution doesn't matter
+#define BENCH_MIN_MICROS 200000UL
+
+/// Keeps the compiler from optimizing away results that aren't otherwise used
+static volatile uint32_t bench_sink;
+
+/// Time a function, calling it until BENCH_MIN_MICROS have passed, and print the result
+/// @param name the name of the case
+/// @param items how many items (leds, bytes...) each call works on, for the time per item
+/// @param fn the function to time, anything that can be called with no arguments
+/// @returns the time per call, in ns
+template<typename F> double bench(const char *name, uint32_t items, F fn) {
+	// warm up the caches, and anything allocated on the first call
+	fn();
+
+	uint32_t calls = 0;
+	uint32_t start = micros();
+	uint32_t elapsed;
+	do {
+		for(int i = 0; i < 16; ++i) { fn(); }
+		calls += 16;
+		elapsed = micros() - start;
+	} while(elapsed < BENCH_MIN_MICROS);
+
+	double ns = (elapsed * 1000.0) / calls;
+	if(items > 1) {
+		printf("%-44s %12.1f ns/call %10.3f ns/item\n", name, ns, ns / items);
+	} else {
+		printf("%-44s %12.1f ns/call\n", name, ns);
+	}
+	return ns;
+}
+
+/// Print how much faster one case was than another
+/// @param name what's being compared
+/// @param before_ns the time of the slower (original) version
+/// @param after_ns the time of the faster version
+static inline void bench_speedup(const char *name, double before_ns, double after_ns) {
+	printf("%-44s %12.2fx\n", name, before_ns / after_ns);
+}
+
+/// The XY() that the 2D functions in colorutils expect the sketch to provide
+uint16_t XY(uint8_t x, uint8_t y) { return (uint16_t)y * 16 + x; }
+
+#endif
@@ -0,0 +1,32 @@
+// Frame time of several strips with simulated transmit times: show() starting every controller
+// before waiting on any of them, against showing the controllers one after another (the way
+// show() used to).
+
+#include "bench.h"
+
+#define NUM_STRIPS 4
+#define NUM_LEDS_PER_STRIP 256
+
+CRGB leds[NUM_STRIPS][NUM_LEDS_PER_STRIP];
+
+int main() {
+	FastLED.addLeds<WS2812B, 2, GRB>(leds[0], NUM_LEDS_PER_STRIP);
+	FastLED.addLeds<WS2812B, 3, GRB>(leds[1], NUM_LEDS_PER_STRIP);
+	FastLED.addLeds<WS2812B, 4, GRB>(leds[2], NUM_LEDS_PER_STRIP);
+	FastLED.addLeds<WS2812B, 5, GRB>(leds[3], NUM_LEDS_PER_STRIP);
+	FastLED.setMaxRefreshRate(0);
+	for(int i = 0; i < NUM_STRIPS; ++i) {
+		fill_rainbow(leds[i], NUM_LEDS_PER_STRIP, i * 64, 1);
+		HostWire::get(2 + i).simulateTiming(true);
+	}
+
+	double serial = bench("serial showLeds(), 4 strips", 1, []() {
+		for(int i = 0; i < FastLED.count(); ++i) {
+			FastLED[i].showLeds(255);
+		}
+	});
+	double dispatch = bench("show(), 4 strips", 1, []() { FastLED.show(); });
+	bench_speedup("show() speedup", serial, dispatch);
+
+	return 0;
+}
@@ -0,0 +1,46 @@
+// The array forms of hsv2rgb_rainbow() and hsv2rgb_spectrum(), which convert a block of pixels
+// at a time, against converting the same pixels one by one.
+
+#include "bench.h"
+
+#define NUM_LEDS 1024
+
+CHSV hsv[NUM_LEDS];
+CRGB leds[NUM_LEDS];
+
+int main() {
+	uint32_t seed = 1;
+	for(int i = 0; i < NUM_LEDS; ++i) {
+		seed = seed * 1664525UL + 1013904223UL;
+		hsv[i] = CHSV(seed >> 8, seed >> 16, seed >> 24);
+	}
+
+	double before, after;
+	before = bench("per pixel hsv2rgb_rainbow", NUM_LEDS, []() {
+		for(int i = 0; i < NUM_LEDS; ++i) { hsv2rgb_rainbow(hsv[i], leds[i]); }
+	});
+	after = bench("hsv2rgb_rainbow array", NUM_LEDS, []() { hsv2rgb_rainbow(hsv, leds, NUM_LEDS); });
+	bench_speedup("hsv2rgb_rainbow speedup", before, after);
+
+	before = bench("per pixel hsv2rgb_spectrum", NUM_LEDS, []() {
+		for(int i = 0; i < NUM_LEDS; ++i) { hsv2rgb_spectrum(hsv[i], leds[i]); }
+	});
+	after = bench("hsv2rgb_spectrum array", NUM_LEDS, []() { hsv2rgb_spectrum(hsv, leds, NUM_LEDS); });
+	bench_speedup("hsv2rgb_spectrum speedup", before, after);
+
+	// short arrays pay for the block setup
+	before = bench("per pixel hsv2rgb_rainbow, 8 leds", 8, []() {
+		for(int i = 0; i < 8; ++i) { hsv2rgb_rainbow(hsv[i], leds[i]); }
+	});
+	after = bench("hsv2rgb_rainbow array, 8 leds", 8, []() { hsv2rgb_rainbow(hsv, leds, 8); });
+	bench_speedup("hsv2rgb_rainbow speedup, 8 leds", before, after);
+
+	before = bench("per pixel hsv2rgb_spectrum, 8 leds", 8, []() {
+		for(int i = 0; i < 8; ++i) { hsv2rgb_spectrum(hsv[i], leds[i]); }
+	});
+	after = bench("hsv2rgb_spectrum array, 8 leds", 8, []() { hsv2rgb_spectrum(hsv, leds, 8); });
+	bench_speedup("hsv2rgb_spectrum speedup, 8 leds", before, after);
+
+	bench_sink = leds[0].r;
+	return 0;
+}
@@ -0,0 +1,42 @@
+// The 2D noise fills, on a 64x64 matrix, moving through time from one call to the next.
+
+#include "bench.h"
+
+#define WIDTH 64
+#define HEIGHT 64
+
+uint8_t data8[WIDTH * HEIGHT];
+uint16_t data16[WIDTH * HEIGHT];
+CRGB leds[WIDTH * HEIGHT];
+
+static uint32_t t = 0;
+
+int main() {
+	bench("fill_raw_2dnoise8, 1 octave", WIDTH * HEIGHT, []() {
+		t += 16;
+		fill_raw_2dnoise8(data8, WIDTH, HEIGHT, 1, 1000, 300, 2000, 300, t);
+	});
+	bench("fill_raw_2dnoise8, 2 octaves", WIDTH * HEIGHT, []() {
+		t += 16;
+		fill_raw_2dnoise8(data8, WIDTH, HEIGHT, 2, 1000, 300, 2000, 300, t);
+	});
+	bench("fill_raw_2dnoise16, 1 octave", WIDTH * HEIGHT, []() {
+		t += 1000;
+		fill_raw_2dnoise16(data16, WIDTH, HEIGHT, 1, q88(1, 0), 65535, 1, 100000, 2000, 200000, 2000, t);
+	});
+	bench("fill_raw_2dnoise16into8, 1 octave", WIDTH * HEIGHT, []() {
+		t += 1000;
+		fill_raw_2dnoise16into8(data8, WIDTH, HEIGHT, 1, 100000, 2000, 200000, 2000, t);
+	});
+	bench("fill_2dnoise8, 2 octaves", WIDTH * HEIGHT, []() {
+		t += 16;
+		fill_2dnoise8(leds, WIDTH, HEIGHT, false, 2, 1000, 300, 2000, 300, t, 1, 500, 30, 700, 30, t, false);
+	});
+	bench("fill_2dnoise16, 2 octaves", WIDTH * HEIGHT, []() {
+		t += 1000;
+		fill_2dnoise16(leds, WIDTH, HEIGHT, false, 2, 100000, 2000, 200000, 2000, t, 1, 5000, 300, 7000, 300, t, false);
+	});
+
+	bench_sink = data8[0] + data16[0] + leds[0].r;
+	return 0;
+}
@@ -0,0 +1,36 @@
+// Bulk scaling of a large led array (nscale8 and nscale8_video, which the fades are built on),
+// against scaling it led by led with the CRGB member functions.
+
+#include "bench.h"
+
+#define NUM_LEDS 60000
+
+CRGB leds[NUM_LEDS];
+
+static void refill() {
+	for(int i = 0; i < NUM_LEDS; ++i) {
+		leds[i] = CRGB(i, i >> 3, i * 5);
+	}
+}
+
+int main() {
+	refill();
+	double scalar = bench("per led nscale8", NUM_LEDS, []() {
+		for(int i = 0; i < NUM_LEDS; ++i) { leds[i].nscale8(250); }
+	});
+	refill();
+	double bulk = bench("bulk nscale8", NUM_LEDS, []() { nscale8(leds, NUM_LEDS, 250); });
+	bench_speedup("nscale8 speedup", scalar, bulk);
+
+	// the video scale keeps nonzero values lit, so the array never fades out to all zeros
+	refill();
+	scalar = bench("per led nscale8_video", NUM_LEDS, []() {
+		for(int i = 0; i < NUM_LEDS; ++i) { leds[i].nscale8_video(250); }
+	});
+	refill();
+	bulk = bench("bulk nscale8_video", NUM_LEDS, []() { nscale8_video(leds, NUM_LEDS, 250); });
+	bench_speedup("nscale8_video speedup", scalar, bulk);
+
+	bench_sink = leds[0].r;
+	return 0;
+}
@@ -0,0 +1,44 @@
+// Cost of encoding a frame through the show() pipeline, and of a few common effects, on the host.
+// Transmission isn't simulated here, so show() is the CPU time a driver spends scaling,
+// dithering and handing over the bytes.
+
+#include "bench.h"
+
+#define NUM_LEDS 1024
+
+CRGB leds[NUM_LEDS];
+CRGB16 leds16[NUM_LEDS];
+CRGB spi[NUM_LEDS];
+
+int main() {
+	FastLED.addLeds<WS2812B, 2, GRB>(leds, NUM_LEDS);
+	FastLED.setMaxRefreshRate(0);
+
+	CLEDController & controller = FastLED[0];
+	fill_rainbow(leds, NUM_LEDS, 0, 1);
+
+	controller.setDither(DISABLE_DITHER);
+	bench("show, WS2812, no dithering", NUM_LEDS, []() { FastLED.show(); });
+	controller.setDither(BINARY_DITHER);
+	bench("show, WS2812, dithering", NUM_LEDS, []() { FastLED.show(128); });
+
+	controller.setLeds(leds16, NUM_LEDS);
+	fill_gradient_RGB(leds16, NUM_LEDS, CRGB16(0, 1000, 65535), CRGB16(65535, 30000, 0));
+	bench("show, WS2812, CRGB16 error diffusion", NUM_LEDS, []() { FastLED.show(128); });
+	controller.setLeds(leds, NUM_LEDS);
+
+	FastLED.addLeds<APA102, 4, 5, BGR>(spi, NUM_LEDS);
+	controller.setLeds(leds, 0);
+	fill_rainbow(spi, NUM_LEDS, 0, 1);
+	bench("show, APA102", NUM_LEDS, []() { FastLED.show(); });
+
+	static uint8_t hue = 0;
+	bench("fill_rainbow", NUM_LEDS, []() { fill_rainbow(leds, NUM_LEDS, hue++, 1); });
+	CRGBPalette16 palette = PartyColors_p;
+	bench("fill_palette", NUM_LEDS, [&]() { fill_palette(leds, NUM_LEDS, hue++, 1, palette, 255, LINEARBLEND); });
+	bench("fadeToBlackBy", NUM_LEDS, []() { fadeToBlackBy(leds, NUM_LEDS, 20); });
+	bench("blur1d", NUM_LEDS, []() { blur1d(leds, NUM_LEDS, 64); });
+
+	bench_sink = leds[0].r;
+	return 0;
+}
@@ -0,0 +1,45 @@
+// transposeLanes() (bitswap.h), the bit transpose that the parallel output drivers share, for
+// each lane count, against a loop that moves a bit at a time.
+
+#include "bench.h"
+
+// a row of 32 lanes of a parallel strip set, 3 bytes apart as one channel of a CRGB row
+uint8_t row[32 * 3];
+uint32_t planes[8];
+
+// transpose LANES lanes a bit at a time, MSB plane first
+template<int LANES, int m>
+static void transpose_bits(const uint8_t *A, uint32_t *B) {
+	for(int k = 0; k < 8; ++k) {
+		uint32_t plane = 0;
+		for(int lane = 0; lane < LANES; ++lane) {
+			plane |= (uint32_t)((A[lane * m] >> (7 - k)) & 1) << lane;
+		}
+		B[k] = plane;
+	}
+}
+
+template<int LANES>
+static void bench_lanes(const char *bits_name, const char *name, const char *speedup_name) {
+	double before = bench(bits_name, 1, []() {
+		transpose_bits<LANES, 3>(row, planes);
+		row[0] += planes[3];
+	});
+	double after = bench(name, 1, []() {
+		transposeLanes<LANES, true, 3>(row, planes);
+		row[0] += planes[3];
+	});
+	bench_speedup(speedup_name, before, after);
+}
+
+int main() {
+	for(unsigned i = 0; i < sizeof(row); ++i) { row[i] = i * 37 + 11; }
+
+	bench_lanes<8>("per bit, 8 lanes", "transposeLanes<8>", "8 lanes speedup");
+	bench_lanes<16>("per bit, 16 lanes", "transposeLanes<16>", "16 lanes speedup");
+	bench_lanes<24>("per bit, 24 lanes", "transposeLanes<24>", "24 lanes speedup");
+	bench_lanes<32>("per bit, 32 lanes", "transposeLanes<32>", "32 lanes speedup");
+
+	bench_sink = planes[0];
+	return 0;
+}
@@ -0,0 +1,63 @@
+#ifndef __INC_FASTLED_TEST_H
+#define __INC_FASTLED_TEST_H
+
+/// @file test.h
+/// Checks for the host tests.  Each test is a program of its own, built against the host
+/// platform (see src/platforms/host), which prints the checks that failed and exits
+/// non-zero if there were any.
+
+#include <stdio.h>
+#include "FastLED.h"
+
+/// Number of checks that have failed so far
+static int test_failures = 0;
+
+/// Check that a condition holds
+#define CHECK(cond) do { \
+	if(!(cond)) { \
+		printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+		++test_failures; \
+	} \
+} while(0)
+
+/// Check that two integer values are equal, printing both if they aren't
+#define CHECK_EQ(a, b) do { \
+	long long test_a = (long long)(a); \
+	long long test_b = (long long)(b); \
+	if(test_a != test_b) { \
+		printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, test_a, test_b); \
+		++test_failures; \
+	} \
+} while(0)
+
+/// Stop checking a loop after this many failures, so that a broken kernel doesn't print millions of lines
+#define TEST_MAX_FAILURES 20
+
+/// Whether enough checks have failed to give up
+#define TEST_GIVE_UP() (test_failures >= TEST_MAX_FAILURES)
+
+/// Print the result of the test, and return from main() with it
+#define TEST_RESULT() do { \
+	if(test_failures) { printf("%d check(s) failed\n", test_failures); } \
+	else { printf("passed\n"); } \
+	return test_failures ? 1 : 0; \
+} while(0)
+
+/// Width of the row-major matrix that XY() maps, for the functions that call it
+static uint8_t test_xy_width = 16;
+
+/// Layout for XY() to follow instead, if it's set
+static const XYMap *test_xymap = NULL;
+
+/// The XY() that the 2D functions in colorutils expect the sketch to provide
+uint16_t XY(uint8_t x, uint8_t y) { return test_xymap ? (*test_xymap)(x, y) : (uint16_t)y * test_xy_width + x; }
+
+/// A repeatable sequence of pseudo random values for test data
+/// @param seed the state, updated on each call
+/// @returns the next value
+static inline uint32_t test_random(uint32_t & seed) {
+	seed = seed * 1664525UL + 1013904223UL;
+	return seed >> 8;
+}
+
+#endif
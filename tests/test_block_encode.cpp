@@ -0,0 +1,93 @@
+// Checks of the RP2040 block clockless packing (src/platforms/arm/rp2040/clockless_block_encode.h),
+// which doesn't depend on the pico SDK, so that it can run on the host: the planes for a set of
+// strips are decoded back into what each strip's pin sends, and compared with its led data.
+
+#include "test.h"
+#include "platforms/arm/rp2040/clockless_block_encode.h"
+#include <string.h>
+
+#define NUM_LEDS 37
+
+template<int LANES, int XTRA0>
+static void check_block(const char *name) {
+	typedef ClocklessBlockPlane<LANES> Plane;
+	typedef typename Plane::type plane_t;
+
+	// the smallest plane that fits the lanes, and the lane count it's transposed as
+	CHECK_EQ(sizeof(plane_t), LANES <= 8 ? 1 : (LANES <= 16 ? 2 : 4));
+	CHECK_EQ(Plane::PLANE_LANES, sizeof(plane_t) * 8);
+
+	// the strips one after another, as the controller gets them
+	static uint8_t data[LANES][NUM_LEDS * 3];
+	uint32_t seed = LANES * 8 + XTRA0;
+	for(int lane = 0; lane < LANES; ++lane) {
+		for(int i = 0; i < NUM_LEDS * 3; ++i) { data[lane][i] = test_random(seed); }
+	}
+
+	const uint32_t count = clockless_block_plane_count(NUM_LEDS, XTRA0);
+	CHECK_EQ(count, NUM_LEDS * 3 * (8 + XTRA0));
+	// a marker after the planes, which must be left alone
+	static plane_t buf[NUM_LEDS * 3 * (8 + XTRA0) + 1];
+	memset(buf, 0xA5, sizeof(buf));
+	const plane_t marker = buf[count];
+
+	// packed a byte from every lane at a time, as the controller does
+	plane_t *out = buf;
+	for(int i = 0; i < NUM_LEDS * 3; ++i) {
+		uint8_t b[Plane::PLANE_LANES] = {};
+		for(int lane = 0; lane < LANES; ++lane) { b[lane] = data[lane][i]; }
+		out = clockless_block_encode_byte<Plane::PLANE_LANES>(b, out, XTRA0);
+	}
+	CHECK(out == buf + count);
+	CHECK_EQ(buf[count], marker);
+
+	// each pin sends its strip's bytes MSB first, then XTRA0 zero bits
+	for(int lane = 0; lane < LANES && !TEST_GIVE_UP(); ++lane) {
+		const plane_t *plane = buf;
+		for(int i = 0; i < NUM_LEDS * 3; ++i) {
+			uint8_t sent = 0;
+			for(int bit = 0; bit < 8; ++bit) {
+				sent = (sent << 1) | ((*plane++ >> lane) & 1);
+			}
+			int extra = 0;
+			for(int x = 0; x < XTRA0; ++x) {
+				extra |= (*plane++ >> lane) & 1;
+			}
+			if(sent != data[lane][i] || extra) {
+				printf("%s: lane %d, byte %d sent as %02x (extra bits %d), want %02x\n", name, lane, i, sent, extra, data[lane][i]);
+				++test_failures;
+				break;
+			}
+		}
+	}
+
+	// and the pins past the last strip stay low
+	if(LANES < Plane::PLANE_LANES) {
+		for(uint32_t p = 0; p < count; ++p) {
+			if((uint32_t)buf[p] >> LANES) {
+				printf("%s: plane %u drives a pin past the last strip\n", name, (unsigned)p);
+				++test_failures;
+				break;
+			}
+		}
+	}
+}
+
+#define CHECK_BLOCK(LANES, XTRA0) check_block<LANES, XTRA0>(#LANES " lanes, " #XTRA0 " extra bits")
+
+int main() {
+	CHECK_BLOCK(1, 0);
+	CHECK_BLOCK(3, 1);
+	CHECK_BLOCK(8, 0);
+	CHECK_BLOCK(8, 4);
+	CHECK_BLOCK(9, 0);
+	CHECK_BLOCK(12, 0);
+	CHECK_BLOCK(16, 2);
+	CHECK_BLOCK(17, 0);
+	CHECK_BLOCK(20, 0);
+	CHECK_BLOCK(24, 1);
+	CHECK_BLOCK(32, 0);
+	CHECK_BLOCK(32, 4);
+
+	TEST_RESULT();
+}
@@ -0,0 +1,224 @@
+// Checks of the blurs over mapped matrices: blurRows(), blurColumns() and blur2d() with an
+// XYMap (or a NULL map) against the ones that call XY() for every pixel, and against blur1d()
+// on each line, for serpentine, rotated, tiled and shuffled layouts, square and not, and
+// wider than the block of columns that blurColumns() works through at a time.  Then
+// blurBox2d() and blurGaussian2d() against a box blur that sums every window out in full,
+// including windows wider than the matrix, and radii over the largest that's supported.
+
+#include "test.h"
+#include <string.h>
+
+#define MAX_LEDS 4096
+#define MAX_LINE 512
+/// the largest radius blurBox2d() takes on the host, see colorutils.cpp
+#define MAX_RADIUS 63
+
+CRGB original[MAX_LEDS];
+CRGB leds[MAX_LEDS];
+CRGB want[MAX_LEDS];
+CRGB line[MAX_LINE];
+uint16_t table[MAX_LEDS];
+
+enum Layout { ROW_MAJOR, SERPENTINE, ROTATED, PANELS, SHUFFLED };
+
+struct Matrix {
+	uint16_t width;
+	uint16_t height;
+	Layout layout;
+	uint8_t rotation;
+};
+
+static const Matrix matrices[] = {
+	{ 16, 16, ROW_MAJOR, 0 },
+	{ 16, 16, SERPENTINE, 0 },
+	{ 37, 11, SERPENTINE, 0 },
+	{ 11, 37, SERPENTINE, 0 },
+	{ 20, 12, ROTATED, 1 },
+	{ 9, 30, ROTATED, 3 },
+	{ 16, 8, PANELS, 0 },
+	{ 24, 16, PANELS, 2 },
+	{ 70, 5, SERPENTINE, 0 },
+	{ 130, 3, SHUFFLED, 0 },
+	{ 1, 50, SERPENTINE, 0 },
+	{ 50, 1, SERPENTINE, 0 },
+	{ 255, 16, SERPENTINE, 0 },
+	{ 300, 7, SERPENTINE, 0 },
+	{ 5, 400, SHUFFLED, 0 },
+};
+
+static void lay_out(XYMap & xymap, const Matrix & m, uint32_t & seed) {
+	switch(m.layout) {
+		case ROW_MAJOR: xymap.setRowMajor(m.rotation); break;
+		case SERPENTINE:
+		case ROTATED: xymap.setSerpentine(m.rotation); break;
+		case PANELS: xymap.setPanels(8, 4, true, true, m.rotation); break;
+		case SHUFFLED: {
+			uint32_t n = xymap.getSize();
+			for(uint32_t i = 0; i < n; ++i) { table[i] = i; }
+			for(uint32_t i = n - 1; i > 0; --i) {
+				uint32_t j = test_random(seed) % (i + 1);
+				uint16_t t = table[i]; table[i] = table[j]; table[j] = t;
+			}
+			xymap.setTable(table);
+			break;
+		}
+	}
+}
+
+static void fill_random(CRGB *data, uint32_t n, uint32_t & seed) {
+	for(uint32_t i = 0; i < n; ++i) {
+		// mostly dim, with a few bright pixels, so there's something to spread
+		uint8_t mask = (test_random(seed) & 7) ? 0x3F : 0xFF;
+		data[i] = CRGB(test_random(seed) & mask, test_random(seed) & mask, test_random(seed) & mask);
+	}
+}
+
+// blur1d() each row, or each column, gathered into a line of its own
+static void blur_lines(CRGB *data, const XYMap & xymap, fract8 amount, bool columns) {
+	uint16_t lines = columns ? xymap.getWidth() : xymap.getHeight();
+	uint16_t len = columns ? xymap.getHeight() : xymap.getWidth();
+	for(uint16_t l = 0; l < lines; ++l) {
+		for(uint16_t k = 0; k < len; ++k) { line[k] = data[columns ? xymap(l, k) : xymap(k, l)]; }
+		blur1d(line, len, amount);
+		for(uint16_t k = 0; k < len; ++k) { data[columns ? xymap(l, k) : xymap(k, l)] = line[k]; }
+	}
+}
+
+// box blur each row, or each column, summing the whole window for every pixel, with the
+// pixels past the ends repeating the end ones
+static void box_lines(CRGB *data, const XYMap & xymap, uint8_t radius, bool columns) {
+	uint16_t lines = columns ? xymap.getWidth() : xymap.getHeight();
+	int len = columns ? xymap.getHeight() : xymap.getWidth();
+	uint16_t window = 2 * radius + 1;
+	// the same rounding as blurBox2d(), so that a flat window averages to its value
+	uint32_t recip = (65536UL + window - 1) / window;
+	for(uint16_t l = 0; l < lines; ++l) {
+		for(int k = 0; k < len; ++k) { line[k] = data[columns ? xymap(l, k) : xymap(k, l)]; }
+		for(int k = 0; k < len; ++k) {
+			uint32_t sum[3] = { 0, 0, 0 };
+			for(int j = k - radius; j <= k + radius; ++j) {
+				const CRGB & px = line[(j < 0) ? 0 : ((j >= len) ? len - 1 : j)];
+				for(int c = 0; c < 3; ++c) { sum[c] += px.raw[c]; }
+			}
+			data[columns ? xymap(l, k) : xymap(k, l)] = CRGB((sum[0] * recip) >> 16, (sum[1] * recip) >> 16, (sum[2] * recip) >> 16);
+		}
+	}
+}
+
+static void check_same(const CRGB *got, const CRGB *expected, uint32_t n, const Matrix & m, const char *what, int amount) {
+	for(uint32_t i = 0; i < n; ++i) {
+		if(got[i] != expected[i]) {
+			printf("%s, %dx%d layout %d rotation %d, amount %d: led %u is %d/%d/%d, not %d/%d/%d\n",
+			       what, m.width, m.height, m.layout, m.rotation, amount, (unsigned)i,
+			       got[i].r, got[i].g, got[i].b, expected[i].r, expected[i].g, expected[i].b);
+			++test_failures;
+			return;
+		}
+	}
+}
+
+// the mapped blurs against blur1d() on every line, and against the XY() ones where they fit
+static void test_blurs(const Matrix & m, uint32_t & seed) {
+	static const uint8_t amounts[] = { 0, 1, 64, 172, 255 };
+	XYMap xymap(m.width, m.height);
+	lay_out(xymap, m, seed);
+	uint32_t n = xymap.getSize();
+	bool legacy = m.width < 256 && m.height < 256;
+	test_xymap = &xymap;
+
+	for(size_t a = 0; a < sizeof(amounts) / sizeof(amounts[0]) && !TEST_GIVE_UP(); ++a) {
+		fract8 amount = amounts[a];
+		fill_random(original, n, seed);
+
+		memcpy(leds, original, n * sizeof(CRGB));
+		memcpy(want, original, n * sizeof(CRGB));
+		blurRows(leds, xymap, amount);
+		blur_lines(want, xymap, amount, false);
+		check_same(leds, want, n, m, "blurRows", amount);
+		if(legacy) {
+			memcpy(want, original, n * sizeof(CRGB));
+			blurRows(want, (uint8_t)m.width, (uint8_t)m.height, amount);
+			check_same(leds, want, n, m, "blurRows against XY()", amount);
+		}
+
+		memcpy(leds, original, n * sizeof(CRGB));
+		memcpy(want, original, n * sizeof(CRGB));
+		blurColumns(leds, xymap, amount);
+		blur_lines(want, xymap, amount, true);
+		check_same(leds, want, n, m, "blurColumns", amount);
+		if(legacy) {
+			memcpy(want, original, n * sizeof(CRGB));
+			blurColumns(want, (uint8_t)m.width, (uint8_t)m.height, amount);
+			check_same(leds, want, n, m, "blurColumns against XY()", amount);
+		}
+
+		memcpy(leds, original, n * sizeof(CRGB));
+		memcpy(want, original, n * sizeof(CRGB));
+		blur2d(leds, xymap, amount);
+		blur_lines(want, xymap, amount, false);
+		blur_lines(want, xymap, amount, true);
+		check_same(leds, want, n, m, "blur2d", amount);
+		if(legacy) {
+			memcpy(want, original, n * sizeof(CRGB));
+			blur2d(want, (uint8_t)m.width, (uint8_t)m.height, amount);
+			check_same(leds, want, n, m, "blur2d against XY()", amount);
+		}
+
+		// no map is row-major
+		if(m.layout == ROW_MAJOR) {
+			memcpy(leds, original, n * sizeof(CRGB));
+			memcpy(want, original, n * sizeof(CRGB));
+			blur2d(leds, m.width, m.height, amount, NULL);
+			blur2d(want, xymap, amount);
+			check_same(leds, want, n, m, "blur2d, no map", amount);
+		}
+	}
+	test_xymap = NULL;
+}
+
+// the box and gaussian blurs against the full sums, and the radius they're capped at
+static void test_box(const Matrix & m, uint32_t & seed) {
+	static const uint8_t radii[] = { 0, 1, 2, 3, 7, 8, 31, MAX_RADIUS, MAX_RADIUS + 1, 255 };
+	XYMap xymap(m.width, m.height);
+	lay_out(xymap, m, seed);
+	uint32_t n = xymap.getSize();
+
+	for(size_t r = 0; r < sizeof(radii) / sizeof(radii[0]) && !TEST_GIVE_UP(); ++r) {
+		uint8_t radius = radii[r];
+		// bigger radii are quietly blurred at the largest one
+		uint8_t capped = (radius > MAX_RADIUS) ? MAX_RADIUS : radius;
+		fill_random(original, n, seed);
+
+		memcpy(leds, original, n * sizeof(CRGB));
+		memcpy(want, original, n * sizeof(CRGB));
+		blurBox2d(leds, xymap, radius);
+		if(capped) {
+			box_lines(want, xymap, capped, false);
+			box_lines(want, xymap, capped, true);
+		}
+		check_same(leds, want, n, m, "blurBox2d", radius);
+
+		memcpy(leds, original, n * sizeof(CRGB));
+		blurGaussian2d(leds, xymap, radius);
+		for(int pass = 1; pass < 3 && capped; ++pass) {
+			box_lines(want, xymap, capped, false);
+			box_lines(want, xymap, capped, true);
+		}
+		check_same(leds, want, n, m, "blurGaussian2d", radius);
+	}
+
+	// a flat matrix stays flat, at any radius
+	for(uint32_t i = 0; i < n; ++i) { leds[i] = CRGB(200, 1, 255); }
+	blurBox2d(leds, xymap, MAX_RADIUS);
+	for(uint32_t i = 0; i < n; ++i) { want[i] = CRGB(200, 1, 255); }
+	check_same(leds, want, n, m, "blurBox2d, flat", MAX_RADIUS);
+}
+
+int main() {
+	uint32_t seed = 9;
+	for(size_t i = 0; i < sizeof(matrices) / sizeof(matrices[0]) && !TEST_GIVE_UP(); ++i) {
+		test_blurs(matrices[i], seed);
+		test_box(matrices[i], seed);
+	}
+	TEST_RESULT();
+}
@@ -0,0 +1,211 @@
+// Checks of the compile time timing conversions in clockless_timing.h, for every clockless
+// chipset in chipsets.h on every platform whose driver uses them: the ESP32 I2S pulse patterns
+// and clock dividers, and the RP2040 PIO ticks.  Each result is worked out again at run time, the
+// way the drivers used to (or by brute force), and every combination must be one that the
+// driver accepts, since the drivers static_assert it.  Run it with -v to print the whole table.
+//
+// The test is built with CLOCKLESS_FREQUENCY set to 1GHz, so that the chipsets' T1, T2 and T3
+// come out in nanoseconds, and converts them to each platform's clock the way chipsets.h does.
+
+#include "test.h"
+#include "clockless_timing.h"
+#include <math.h>
+#include <string.h>
+
+#if CLOCKLESS_FREQUENCY != 1000000000
+#error "test_clockless_timing must be built with CLOCKLESS_FREQUENCY=1000000000"
+#endif
+
+static bool verbose = false;
+
+/// A chipset time in nanoseconds, as cycles of a platform's clockless clock (C_NS in chipsets.h)
+template<int NS, uint32_t HZ>
+struct PlatformCycles {
+	static const int VALUE = (int)(((int64_t)NS * (HZ / 1000000L) + 999) / 1000);
+};
+
+// the largest error on an edge that a driver accepts
+static const double MAX_ERROR_NS = FASTLED_CLOCKLESS_MAX_ERROR_NS;
+
+// ---- ESP32 I2S ----------------------------------------------------------------------------
+
+// the values from clockless_i2s_esp32.h
+#define I2S_BASE_CLK 80000000UL
+#define I2S_MAX_PULSE_PER_BIT 20
+#define I2S_MAX_DIVIDER_A 63
+
+// the largest pulse length, at most smallest, that T1, T2 and T3 are multiples of give or take
+// precision cycles: the search the I2S driver used to run at startup
+static int i2s_pgcd(int smallest, int precision, int a, int b, int c) {
+	for(int i = smallest; i > 0; --i) {
+		if(a % i <= precision && b % i <= precision && c % i <= precision) {
+			return i;
+		}
+	}
+	return 1;
+}
+
+template<int NS1, int NS2, int NS3, uint32_t F_CPU_HZ>
+static void check_esp32_i2s(const char *chipset) {
+	const int T1 = PlatformCycles<NS1, F_CPU_HZ>::VALUE;
+	const int T2 = PlatformCycles<NS2, F_CPU_HZ>::VALUE;
+	const int T3 = PlatformCycles<NS3, F_CPU_HZ>::VALUE;
+	typedef CClocklessTiming<T1, T2, T3, F_CPU_HZ> Timing;
+	typedef CClocklessPulses<Timing, I2S_MAX_PULSE_PER_BIT> Pulses;
+	typedef CFractionalDivider<(uint64_t)I2S_BASE_CLK * Pulses::PULSE_HZ_DEN, Pulses::PULSE_HZ_NUM, I2S_MAX_DIVIDER_A> Divider;
+
+	// the pulse pattern, from the old search
+	int smallest = T1 < T2 ? T1 : T2;
+	if(smallest > T3) { smallest = T3; }
+	int precision = 0;
+	int pulse = i2s_pgcd(smallest, precision, T1, T2, T3);
+	while(pulse == 1 || (T1 / pulse + T2 / pulse + T3 / pulse) > I2S_MAX_PULSE_PER_BIT) {
+		++precision;
+		pulse = i2s_pgcd(smallest, precision, T1, T2, T3);
+		if(precision > smallest) { break; }
+	}
+	int pulsesPerBit = T1 / pulse + T2 / pulse + T3 / pulse;
+	CHECK_EQ(Pulses::PULSE, pulse);
+	CHECK_EQ(Pulses::PULSES_PER_BIT, pulsesPerBit);
+	CHECK_EQ(Pulses::ONES_FOR_ZERO, T1 / pulse);
+	CHECK_EQ(Pulses::ONES_FOR_ONE, T1 / pulse + T2 / pulse);
+
+	// the edges, with the bit period cut into pulsesPerBit equal pulses
+	double period = (T1 + T2 + T3) * 1e9 / F_CPU_HZ;
+	double t0hError = (T1 / pulse) * period / pulsesPerBit - T1 * 1e9 / F_CPU_HZ;
+	double t1hError = (T1 / pulse + T2 / pulse) * period / pulsesPerBit - (T1 + T2) * 1e9 / F_CPU_HZ;
+	// the templates round each time to a nanosecond
+	CHECK(fabs(Pulses::T0H_ERROR_NS - t0hError) <= 1.0);
+	CHECK(fabs(Pulses::T1H_ERROR_NS - t1hError) <= 1.0);
+	bool valid = pulsesPerBit <= I2S_MAX_PULSE_PER_BIT && T1 / pulse > 0 && T2 / pulse > 0 && T3 / pulse > 0
+		&& fabs(t0hError) <= MAX_ERROR_NS && fabs(t1hError) <= MAX_ERROR_NS;
+	// only differs from the templates' verdict when an error is within the rounding of the limit
+	if(fabs(fabs(t0hError) - MAX_ERROR_NS) > 1.0 && fabs(fabs(t1hError) - MAX_ERROR_NS) > 1.0) {
+		CHECK_EQ(Pulses::VALID, valid);
+	}
+
+	// the divider: no N + B/A, with A up to 63, is closer to the division wanted
+	double wanted = (double)I2S_BASE_CLK * Pulses::PULSE_HZ_DEN / (double)Pulses::PULSE_HZ_NUM;
+	double got = Divider::N + (double)Divider::B / Divider::A;
+	CHECK(Divider::A >= 1 && Divider::A <= I2S_MAX_DIVIDER_A);
+	CHECK(Divider::B < Divider::A || (Divider::B == 0 && Divider::A == 1));
+	double best = 1e9;
+	for(int a = 1; a <= I2S_MAX_DIVIDER_A; ++a) {
+		double b = floor((wanted - floor(wanted)) * a + 0.5);
+		double d = fabs(floor(wanted) + b / a - wanted);
+		if(d < best) { best = d; }
+	}
+	CHECK(fabs(got - wanted) <= best + 1e-12);
+	double ppm = (got - wanted) / wanted * 1e6;
+
+	// what the driver static_asserts
+	if(!Pulses::VALID) {
+		printf("ESP32 I2S at %lu MHz: %s can't be sent (errors %d and %d ns)\n", (unsigned long)(F_CPU_HZ / 1000000),
+			chipset, (int)Pulses::T0H_ERROR_NS, (int)Pulses::T1H_ERROR_NS);
+		++test_failures;
+	}
+	if(verbose) {
+		printf("ESP32 I2S %3lu MHz  %-28s %2d pulses (%d/%d high), errors %4d %4d ns, divider %u %u/%u (%+.1f ppm)%s\n",
+			(unsigned long)(F_CPU_HZ / 1000000), chipset, Pulses::PULSES_PER_BIT, Pulses::ONES_FOR_ZERO, Pulses::ONES_FOR_ONE,
+			(int)Pulses::T0H_ERROR_NS, (int)Pulses::T1H_ERROR_NS, (unsigned)Divider::N, (unsigned)Divider::B, (unsigned)Divider::A,
+			ppm, Pulses::VALID ? "" : "  INVALID");
+	}
+}
+
+// ---- RP2040 PIO ---------------------------------------------------------------------------
+
+// the longest delay the clockless PIO program has for an interval, in PIO cycles (pio_gen.h)
+#define CLOCKLESS_PIO_MAX_TIME_PERIOD 32
+
+template<int NS1, int NS2, int NS3, uint32_t HZ>
+static void check_rp2040_pio(const char *chipset) {
+	const int T1 = PlatformCycles<NS1, HZ>::VALUE;
+	const int T2 = PlatformCycles<NS2, HZ>::VALUE;
+	const int T3 = PlatformCycles<NS3, HZ>::VALUE;
+	// as in clockless_arm_rp2040.h and clockless_block_arm_rp2040.h
+	static const int MAX_T = (T1 > T2) ? (T1 > T3 ? T1 : T3) : (T2 > T3 ? T2 : T3);
+	static const uint32_t PIO_CLOCK_HZ = (MAX_T > CLOCKLESS_PIO_MAX_TIME_PERIOD)
+		? (uint32_t)(((uint64_t)HZ * CLOCKLESS_PIO_MAX_TIME_PERIOD) / MAX_T)
+		: HZ;
+	typedef CClocklessTicks<CClocklessTiming<T1, T2, T3, HZ>, PIO_CLOCK_HZ> Ticks;
+
+	// each edge rounded to the nearest tick
+	double tick = 1e9 / PIO_CLOCK_HZ;
+	double edges[3] = { T1 * 1e9 / HZ, (T1 + T2) * 1e9 / HZ, (T1 + T2 + T3) * 1e9 / HZ };
+	int ticks[3];
+	double maxError = 0;
+	for(int e = 0; e < 3; ++e) {
+		ticks[e] = (int)floor(edges[e] / tick + 0.5);
+		double error = fabs(ticks[e] * tick - edges[e]);
+		if(error > maxError) { maxError = error; }
+	}
+	CHECK_EQ(Ticks::T0H, ticks[0]);
+	CHECK_EQ(Ticks::T1H, ticks[1]);
+	CHECK_EQ(Ticks::PERIOD, ticks[2]);
+	CHECK_EQ(Ticks::T1 + Ticks::T2 + Ticks::T3, Ticks::PERIOD);
+	CHECK(fabs(Ticks::MAX_ERROR_NS - maxError) <= 1.0);
+	// every interval fits in the PIO program's delays
+	CHECK(Ticks::T1 <= CLOCKLESS_PIO_MAX_TIME_PERIOD && Ticks::T2 <= CLOCKLESS_PIO_MAX_TIME_PERIOD && Ticks::T3 <= CLOCKLESS_PIO_MAX_TIME_PERIOD);
+
+	// what the drivers static_assert
+	const bool accepted = Ticks::VALID && Ticks::T3 >= 2;
+	if(!accepted) {
+		printf("RP2040 PIO at %lu MHz: %s can't be sent (ticks %u %u %u, error %u ns)\n", (unsigned long)(HZ / 1000000),
+			chipset, (unsigned)Ticks::T1, (unsigned)Ticks::T2, (unsigned)Ticks::T3, (unsigned)Ticks::MAX_ERROR_NS);
+		++test_failures;
+	}
+	if(verbose) {
+		printf("RP2040 PIO %3lu MHz %-28s PIO clock %9lu Hz, ticks %2u %2u %2u, error %3u ns%s\n", (unsigned long)(HZ / 1000000),
+			chipset, (unsigned long)PIO_CLOCK_HZ, (unsigned)Ticks::T1, (unsigned)Ticks::T2, (unsigned)Ticks::T3,
+			(unsigned)Ticks::MAX_ERROR_NS, accepted ? "" : "  INVALID");
+	}
+}
+
+// ---- every chipset on every platform ------------------------------------------------------
+
+// the chipset's T1, T2 and T3, in nanoseconds, taken from the ClocklessController it derives from
+template<int DATA_PIN, int NS1, int NS2, int NS3, EOrder RGB_ORDER, int XTRA0, bool FLIP, int WAIT_TIME>
+static void check_chipset(const char *chipset, ClocklessController<DATA_PIN, NS1, NS2, NS3, RGB_ORDER, XTRA0, FLIP, WAIT_TIME> *) {
+	int failures = test_failures;
+	check_esp32_i2s<NS1, NS2, NS3, 240000000>(chipset);
+	check_esp32_i2s<NS1, NS2, NS3, 160000000>(chipset);
+	check_esp32_i2s<NS1, NS2, NS3, 80000000>(chipset);
+
+	check_rp2040_pio<NS1, NS2, NS3, 125000000>(chipset);
+	check_rp2040_pio<NS1, NS2, NS3, 133000000>(chipset);
+	check_rp2040_pio<NS1, NS2, NS3, 150000000>(chipset);
+
+	if(test_failures != failures) {
+		printf("  (checks above failed for %s, %d/%d/%d ns)\n", chipset, NS1, NS2, NS3);
+	}
+}
+
+#define CHECK_CHIPSET(CHIPSET) check_chipset(#CHIPSET, (CHIPSET<0, RGB> *)NULL)
+
+int main(int argc, char **argv) {
+	verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+
+	CHECK_CHIPSET(GE8822Controller800Khz);
+	CHECK_CHIPSET(GW6205Controller400Khz);
+	CHECK_CHIPSET(GW6205Controller800Khz);
+	CHECK_CHIPSET(UCS1903Controller400Khz);
+	CHECK_CHIPSET(UCS1903BController800Khz);
+	CHECK_CHIPSET(UCS1904Controller800Khz);
+	CHECK_CHIPSET(UCS2903Controller);
+	CHECK_CHIPSET(TM1809Controller800Khz);
+	CHECK_CHIPSET(WS2811Controller800Khz);
+	CHECK_CHIPSET(WS2813Controller);
+	CHECK_CHIPSET(WS2812Controller800Khz);
+	CHECK_CHIPSET(WS2811Controller400Khz);
+	CHECK_CHIPSET(TM1803Controller400Khz);
+	CHECK_CHIPSET(TM1829Controller800Khz);
+	CHECK_CHIPSET(TM1829Controller1600Khz);
+	CHECK_CHIPSET(LPD1886Controller1250Khz);
+	CHECK_CHIPSET(LPD1886Controller1250Khz_8bit);
+	CHECK_CHIPSET(SK6822Controller);
+	CHECK_CHIPSET(SK6812Controller);
+	CHECK_CHIPSET(SM16703Controller);
+	CHECK_CHIPSET(PL9823Controller);
+
+	TEST_RESULT();
+}
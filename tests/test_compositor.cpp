@@ -0,0 +1,237 @@
+// Checks of CCompositor against a led at a time reference: each blend mode, at a range of
+// opacities, against what its documentation says it's the same as (nblend(), `+=`, and so on),
+// stacks of layers that cover spans of the output straddling the blocks that it works in, over
+// black and over what's already there, and compositing into a controller's buffer.
+
+#include "test.h"
+#include <string.h>
+
+#define NUM_LEDS 200
+#define BLOCK 64
+#define LAYERS COMPOSITOR_MAX_LAYERS
+
+CRGB layers[LAYERS][NUM_LEDS];
+CRGB leds[NUM_LEDS];
+CRGB want[NUM_LEDS];
+CRGB strip[NUM_LEDS];
+
+static const TBlendMode modes[] = { LAYER_BLEND_ALPHA, LAYER_BLEND_ADD, LAYER_BLEND_SCREEN, LAYER_BLEND_MULTIPLY, LAYER_BLEND_MAX };
+
+static void fill_random(CRGB *data, int n, uint32_t & seed) {
+	for(int i = 0; i < n; ++i) {
+		data[i] = CRGB(test_random(seed), test_random(seed), test_random(seed));
+	}
+	// and the extremes of every channel
+	if(n > 4) {
+		data[0] = CRGB::Black;
+		data[1] = CRGB::White;
+		data[2] = CRGB(255, 0, 1);
+		data[3] = CRGB(0, 254, 128);
+	}
+}
+
+// a layer's led on the led below it, the way the modes are documented
+static void reference(CRGB & d, const CRGB & s, TBlendMode mode, uint8_t opacity) {
+	CRGB faded = s;
+	faded.nscale8(opacity);
+	switch(mode) {
+		case LAYER_BLEND_ALPHA:
+			nblend(d, s, opacity);
+			break;
+		case LAYER_BLEND_ADD:
+			d += faded;
+			break;
+		case LAYER_BLEND_SCREEN:
+			// the inverse of multiplying the inverses
+			d = -((-d).nscale8(-faded));
+			break;
+		case LAYER_BLEND_MULTIPLY: {
+			// the layer fades toward white
+			CRGB x = -s;
+			d.nscale8(-x.nscale8(opacity));
+			break;
+		}
+		case LAYER_BLEND_MAX:
+			d |= faded;
+			break;
+	}
+}
+
+struct Span {
+	uint16_t start;
+	uint16_t count;
+};
+
+// stack the layers a led at a time
+static void composite_reference(CRGB *out, uint16_t numLeds, int numLayers, const TBlendMode *mode,
+                                const uint8_t *opacity, const Span *span, bool overExisting) {
+	if(!overExisting) {
+		for(int i = 0; i < numLeds; ++i) { out[i] = CRGB::Black; }
+	}
+	for(int l = 0; l < numLayers; ++l) {
+		uint32_t end = span[l].count ? (uint32_t)span[l].start + span[l].count : numLeds;
+		for(uint32_t i = span[l].start; i < end && i < numLeds; ++i) {
+			reference(out[i], layers[l][i - span[l].start], mode[l], opacity[l]);
+		}
+	}
+}
+
+// one layer over what's in the output, for each mode and opacity
+static void test_modes(uint32_t & seed) {
+	static const uint8_t opacities[] = { 0, 1, 2, 127, 128, 129, 254, 255 };
+	for(size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+		for(size_t o = 0; o < sizeof(opacities) / sizeof(opacities[0]) + 4 && !TEST_GIVE_UP(); ++o) {
+			uint8_t opacity = (o < sizeof(opacities) / sizeof(opacities[0])) ? opacities[o] : test_random(seed);
+			fill_random(layers[0], NUM_LEDS, seed);
+			fill_random(leds, NUM_LEDS, seed);
+			memcpy(want, leds, sizeof(leds));
+			for(int i = 0; i < NUM_LEDS; ++i) { reference(want[i], layers[0][i], modes[m], opacity); }
+
+			CCompositor compositor;
+			CHECK_EQ(compositor.addLayer(layers[0], modes[m], opacity), 0);
+			compositor.composite(leds, NUM_LEDS, true);
+			for(int i = 0; i < NUM_LEDS; ++i) {
+				if(leds[i] != want[i]) {
+					printf("mode %d, opacity %d, led %d is %d/%d/%d, not %d/%d/%d\n", modes[m], opacity, i,
+					       leds[i].r, leds[i].g, leds[i].b, want[i].r, want[i].g, want[i].b);
+					CHECK(leds[i] == want[i]);
+					break;
+				}
+			}
+		}
+	}
+
+	// the ones that are documented to be the same as an operation on CRGB
+	fill_random(layers[0], NUM_LEDS, seed);
+	fill_random(leds, NUM_LEDS, seed);
+	memcpy(want, leds, sizeof(leds));
+	CCompositor add;
+	add.addLayer(layers[0], LAYER_BLEND_ADD);
+	add.composite(leds, NUM_LEDS, true);
+	for(int i = 0; i < NUM_LEDS; ++i) {
+		CRGB sum = want[i];
+		sum += layers[0][i];
+		CHECK(leds[i] == sum);
+	}
+	memcpy(want, leds, sizeof(leds));
+	CCompositor alpha;
+	alpha.addLayer(layers[0], LAYER_BLEND_ALPHA, 100);
+	alpha.composite(leds, NUM_LEDS, true);
+	for(int i = 0; i < NUM_LEDS; ++i) {
+		CRGB blended = want[i];
+		nblend(blended, layers[0][i], 100);
+		CHECK(leds[i] == blended);
+	}
+	// white multiplies to no change, black screens to no change
+	for(int i = 0; i < NUM_LEDS; ++i) { layers[0][i] = CRGB::White; layers[1][i] = CRGB::Black; }
+	memcpy(want, leds, sizeof(leds));
+	CCompositor identity;
+	identity.addLayer(layers[0], LAYER_BLEND_MULTIPLY);
+	identity.addLayer(layers[1], LAYER_BLEND_SCREEN);
+	identity.composite(leds, NUM_LEDS, true);
+	CHECK(memcmp(leds, want, sizeof(leds)) == 0);
+}
+
+// stacks of layers covering spans of the output that start and end on either side of the blocks
+static void test_spans(uint32_t & seed) {
+	static const Span spans[] = {
+		{ 0, 0 }, { 0, BLOCK }, { BLOCK - 1, 2 }, { BLOCK - 4, BLOCK + 8 }, { BLOCK, 1 }, { 60, 10 },
+		{ 2 * BLOCK - 1, 1 }, { 2 * BLOCK + 1, 0 }, { NUM_LEDS - 1, 1 }, { NUM_LEDS - 5, 20 },
+		{ NUM_LEDS, 4 }, { 3 * BLOCK - 3, 0 }, { 1, NUM_LEDS - 2 },
+	};
+	const int numSpans = sizeof(spans) / sizeof(spans[0]);
+	static const uint16_t sizes[] = { NUM_LEDS, BLOCK, BLOCK + 1, 2 * BLOCK - 1, 1 };
+
+	for(int trial = 0; trial < 400 && !TEST_GIVE_UP(); ++trial) {
+		int numLayers = 1 + trial % LAYERS;
+		uint16_t numLeds = sizes[(trial / LAYERS) % (sizeof(sizes) / sizeof(sizes[0]))];
+		bool overExisting = (trial & 1) != 0;
+		TBlendMode mode[LAYERS];
+		uint8_t opacity[LAYERS];
+		Span span[LAYERS];
+
+		CCompositor compositor;
+		for(int l = 0; l < numLayers; ++l) {
+			fill_random(layers[l], NUM_LEDS, seed);
+			mode[l] = modes[test_random(seed) % 5];
+			opacity[l] = (test_random(seed) & 3) ? 255 - (test_random(seed) & 7) * 32 : 0;
+			span[l] = spans[test_random(seed) % numSpans];
+			// the layer buffers only run to the end of the output
+			if(span[l].count > NUM_LEDS - span[l].start) { span[l].count = NUM_LEDS - span[l].start; }
+			CHECK_EQ(compositor.addLayer(layers[l], mode[l], opacity[l], span[l].start, span[l].count), l);
+		}
+
+		fill_random(leds, NUM_LEDS, seed);
+		memcpy(want, leds, sizeof(leds));
+		composite_reference(want, numLeds, numLayers, mode, opacity, span, overExisting);
+		compositor.composite(leds, numLeds, overExisting);
+		CHECK(memcmp(leds, want, sizeof(leds)) == 0);
+		if(test_failures) {
+			printf("%d layers over %d leds, %s existing leds:\n", numLayers, numLeds, overExisting ? "over" : "not over");
+			for(int l = 0; l < numLayers; ++l) {
+				printf("  mode %d, opacity %d, start %d, count %d\n", mode[l], opacity[l], span[l].start, span[l].count);
+			}
+			return;
+		}
+	}
+}
+
+// the setters, the limit on the layers, and a layer without leds
+static void test_layers(uint32_t & seed) {
+	CCompositor compositor;
+	for(int l = 0; l < LAYERS; ++l) { CHECK_EQ(compositor.addLayer(layers[l]), l); }
+	CHECK_EQ(compositor.addLayer(layers[0]), -1);
+	CHECK_EQ(compositor.getNumLayers(), LAYERS);
+	compositor.clearLayers();
+	CHECK_EQ(compositor.getNumLayers(), 0);
+
+	fill_random(layers[0], NUM_LEDS, seed);
+	fill_random(layers[1], NUM_LEDS, seed);
+	compositor.addLayer(layers[0]);
+	compositor.addLayer(NULL, LAYER_BLEND_ADD);
+	compositor.composite(leds, NUM_LEDS);
+	CHECK(memcmp(leds, layers[0], sizeof(leds)) == 0);
+
+	compositor.setLeds(1, layers[1]);
+	compositor.setBlendMode(1, LAYER_BLEND_MAX);
+	compositor.setOpacity(1, 77);
+	CHECK_EQ(compositor.getOpacity(1), 77);
+	CHECK_EQ(compositor.getOpacity(9), 0);
+	compositor.setSpan(1, BLOCK - 2, 5);
+	compositor.composite(leds, NUM_LEDS);
+	memcpy(want, layers[0], sizeof(want));
+	for(int i = BLOCK - 2; i < BLOCK + 3; ++i) { reference(want[i], layers[1][i - (BLOCK - 2)], LAYER_BLEND_MAX, 77); }
+	CHECK(memcmp(leds, want, sizeof(leds)) == 0);
+
+	// nothing below the layer, and nothing over black, except where it covers
+	compositor.setOpacity(0, 0);
+	fill_random(leds, NUM_LEDS, seed);
+	compositor.composite(leds, NUM_LEDS);
+	for(int i = 0; i < NUM_LEDS; ++i) {
+		want[i] = CRGB::Black;
+		if(i >= BLOCK - 2 && i < BLOCK + 3) { reference(want[i], layers[1][i - (BLOCK - 2)], LAYER_BLEND_MAX, 77); }
+	}
+	CHECK(memcmp(leds, want, sizeof(leds)) == 0);
+}
+
+// a reversed strip's buffer is composited from its lowest address, the same as the array
+static void test_controller(uint32_t & seed) {
+	CLEDController & reversed = FastLED.addLeds<WS2812B, 2, GRB>(strip + NUM_LEDS - 1, -NUM_LEDS);
+	fill_random(layers[0], NUM_LEDS, seed);
+	fill_random(layers[1], NUM_LEDS, seed);
+	CCompositor compositor;
+	compositor.addLayer(layers[0]);
+	compositor.addLayer(layers[1], LAYER_BLEND_SCREEN, 90, BLOCK - 10, BLOCK);
+	CHECK(compositor.composite(reversed));
+	compositor.composite(want, NUM_LEDS);
+	CHECK(memcmp(strip, want, sizeof(strip)) == 0);
+}
+
+int main() {
+	uint32_t seed = 14;
+	test_modes(seed);
+	test_spans(seed);
+	test_layers(seed);
+	test_controller(seed);
+	TEST_RESULT();
+}
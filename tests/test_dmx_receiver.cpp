@@ -0,0 +1,424 @@
+// Checks of CDMXReceiver with Art-Net and sACN (E1.31) packets sent over loopback UDP: where
+// each universe's data lands, offsets into a universe, data that's shorter or longer than the
+// leds, the sequence numbers that drop packets, the E1.31 packets that have to be ignored,
+// and that a frame is shown exactly once, when it's complete or when it's synced.
+
+#include "test.h"
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define MAX_PACKET 1024
+
+CRGB leds[400];
+CRGB strip[200];
+uint8_t data[512];
+uint8_t packet[MAX_PACKET];
+
+static int frames_shown = 0;
+static void on_frame() { ++frames_shown; }
+
+/// A pair of UDP sockets on the loopback interface, one sending to the other
+class Loopback {
+	int mRx;
+	int mTx;
+	sockaddr_in mAddr;
+	uint8_t mBuffer[MAX_PACKET];
+
+public:
+	Loopback() {
+		mRx = socket(AF_INET, SOCK_DGRAM, 0);
+		mTx = socket(AF_INET, SOCK_DGRAM, 0);
+		memset(&mAddr, 0, sizeof(mAddr));
+		mAddr.sin_family = AF_INET;
+		mAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		// any free port, rather than the Art-Net and sACN ones, which may be taken
+		mAddr.sin_port = 0;
+		socklen_t len = sizeof(mAddr);
+		if(bind(mRx, (sockaddr*)&mAddr, sizeof(mAddr)) != 0 || getsockname(mRx, (sockaddr*)&mAddr, &len) != 0) {
+			printf("can't bind a loopback socket\n");
+			++test_failures;
+		}
+		timeval timeout = { 1, 0 };
+		setsockopt(mRx, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	}
+
+	~Loopback() { close(mRx); close(mTx); }
+
+	/// Send a packet, receive it, and hand it to the receiver the way a sketch would
+	bool deliver(CDMXReceiver & receiver, const uint8_t *p, uint16_t size) {
+		if(sendto(mTx, p, size, 0, (sockaddr*)&mAddr, sizeof(mAddr)) != size) {
+			printf("can't send a loopback packet\n");
+			++test_failures;
+			return false;
+		}
+		ssize_t got = recv(mRx, mBuffer, sizeof(mBuffer), 0);
+		CHECK_EQ(got, size);
+		return got > 0 && receiver.parsePacket(mBuffer, got);
+	}
+};
+
+static void put_be16(uint8_t *p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; }
+static void put_be32(uint8_t *p, uint32_t v) { put_be16(p, v >> 16); put_be16(p + 2, v & 0xFFFF); }
+
+// an ArtDmx packet, returning its size
+static uint16_t artdmx(uint16_t universe, uint8_t sequence, const uint8_t *dmx, uint16_t length) {
+	memset(packet, 0, 18);
+	memcpy(packet, "Art-Net", 8);
+	packet[8] = 0x00; packet[9] = 0x50;     // OpDmx, little endian
+	packet[11] = 14;                        // protocol version
+	packet[12] = sequence;
+	packet[14] = universe & 0xFF;           // sub-net and universe
+	packet[15] = universe >> 8;             // net
+	put_be16(packet + 16, length);
+	memcpy(packet + 18, dmx, length);
+	return 18 + length;
+}
+
+static uint16_t artsync() {
+	memset(packet, 0, 14);
+	memcpy(packet, "Art-Net", 8);
+	packet[8] = 0x00; packet[9] = 0x52;     // OpSync
+	packet[11] = 14;
+	return 14;
+}
+
+// the root layer of an E1.31 packet
+static void e131_root(uint16_t size, uint32_t vector) {
+	memset(packet, 0, size);
+	put_be16(packet, 0x0010);
+	memcpy(packet + 4, "ASC-E1.17\0\0\0", 12);
+	put_be16(packet + 16, 0x7000 | (size - 16));
+	put_be32(packet + 18, vector);
+	memset(packet + 22, 0x5A, 16);          // CID
+}
+
+// an E1.31 data packet, returning its size
+static uint16_t e131(uint16_t universe, uint8_t sequence, const uint8_t *dmx, uint16_t slots,
+                     uint16_t syncUniverse = 0, uint8_t options = 0) {
+	uint16_t size = 126 + slots;
+	e131_root(size, 0x00000004);
+	put_be16(packet + 38, 0x7000 | (size - 38));
+	put_be32(packet + 40, 0x00000002);
+	memcpy(packet + 44, "test", 4);         // source name
+	packet[108] = 100;                      // priority
+	put_be16(packet + 109, syncUniverse);
+	packet[111] = sequence;
+	packet[112] = options;
+	put_be16(packet + 113, universe);
+	put_be16(packet + 115, 0x7000 | (size - 115));
+	packet[117] = 0x02;                     // set property
+	packet[118] = 0xA1;                     // address and data types
+	put_be16(packet + 119, 0);              // first address
+	put_be16(packet + 121, 1);              // address increment
+	put_be16(packet + 123, slots + 1);      // the start code and the data
+	packet[125] = 0;                        // start code
+	memcpy(packet + 126, dmx, slots);
+	return size;
+}
+
+static uint16_t e131_sync(uint16_t syncUniverse, uint8_t sequence) {
+	e131_root(49, 0x00000008);
+	put_be16(packet + 38, 0x7000 | (49 - 38));
+	put_be32(packet + 40, 0x00000001);
+	packet[44] = sequence;
+	put_be16(packet + 45, syncUniverse);
+	return 49;
+}
+
+static void fill_random(uint8_t *p, int n, uint32_t & seed) {
+	for(int i = 0; i < n; ++i) { p[i] = test_random(seed); }
+}
+
+static void clear_leds() { memset(leds, 0xEE, sizeof(leds)); }
+
+// whether count leds hold the data
+static bool landed(const CRGB *l, int count, const uint8_t *dmx) {
+	return memcmp(l, dmx, count * 3) == 0;
+}
+
+// whether count leds still hold what clear_leds() wrote
+static bool untouched(const CRGB *l, int count) {
+	for(int i = 0; i < count; ++i) {
+		if(l[i] != CRGB(0xEE, 0xEE, 0xEE)) { return false; }
+	}
+	return true;
+}
+
+// universes to ranges of leds, offsets within a universe, and when frames are complete
+static void test_mapping(Loopback & udp, uint32_t & seed) {
+	CDMXReceiver receiver;
+	receiver.setFrameCallback(on_frame);
+	CHECK_EQ(receiver.addUniverse(0x123, leds, 10), 0);
+	CHECK_EQ(receiver.addUniverse(0x123, leds + 10, 5, 30), 1);
+	// more than a universe holds is cut down to one
+	CHECK_EQ(receiver.addUniverse(7, leds + 20, 200, 0), 2);
+	CHECK_EQ(receiver.addUniverses(1, leds + 229, 171), 2);
+	clear_leds();
+	frames_shown = 0;
+
+	// net 1, sub-net 2, universe 3
+	fill_random(data, 512, seed);
+	CHECK(udp.deliver(receiver, packet, artdmx(0x123, 1, data, 512)));
+	CHECK(landed(leds, 10, data));
+	CHECK(landed(leds + 10, 5, data + 30));
+	CHECK(untouched(leds + 15, 5));
+	CHECK_EQ(frames_shown, 0);
+
+	// not mapped, and the top bit of the net isn't part of the address
+	CHECK(!udp.deliver(receiver, packet, artdmx(0x124, 1, data, 512)));
+	CHECK(udp.deliver(receiver, packet, artdmx(0x8007, 1, data + 1, 511)));
+	CHECK(landed(leds + 20, 170, data + 1));
+	CHECK(untouched(leds + 190, 39));
+
+	CHECK(udp.deliver(receiver, packet, artdmx(1, 1, data, 512)));
+	CHECK(landed(leds + 229, 170, data));
+	CHECK_EQ(frames_shown, 0);
+	// the same universe again doesn't finish the frame
+	CHECK(udp.deliver(receiver, packet, artdmx(1, 2, data, 512)));
+	CHECK_EQ(frames_shown, 0);
+	CHECK(udp.deliver(receiver, packet, artdmx(2, 1, data + 100, 3)));
+	CHECK(landed(leds + 400 - 1, 1, data + 100));
+	CHECK_EQ(frames_shown, 1);
+	CHECK_EQ(receiver.getFrames(), 1);
+
+	// and then it starts over
+	for(uint16_t u = 0; u < 3; ++u) {
+		CHECK(udp.deliver(receiver, packet, artdmx(u ? u : 0x123, 3, data, 512)));
+		CHECK_EQ(frames_shown, 1);
+	}
+	CHECK(udp.deliver(receiver, packet, artdmx(7, 3, data, 512)));
+	CHECK_EQ(frames_shown, 2);
+
+	// E1.31 universes are used as they are too
+	CDMXReceiver sacn;
+	sacn.setFrameCallback(on_frame);
+	sacn.addUniverse(1, leds, 20, 3);
+	clear_leds();
+	fill_random(data, 512, seed);
+	CHECK(udp.deliver(sacn, packet, e131(1, 0, data, 512)));
+	CHECK(landed(leds, 20, data + 3));
+	CHECK_EQ(frames_shown, 3);
+}
+
+// data shorter than the leds only writes what it has, and bad lengths are dropped
+static void test_clipping(Loopback & udp, uint32_t & seed) {
+	CDMXReceiver receiver;
+	receiver.setFrameCallback(on_frame);
+	receiver.addUniverse(0, leds, 20, 10);
+	receiver.addUniverse(1, leds + 20, 20, 505);
+	fill_random(data, 512, seed);
+	clear_leds();
+
+	// 7 channels from channel 10, two leds and a byte
+	CHECK(udp.deliver(receiver, packet, artdmx(0, 0, data, 17)));
+	CHECK(memcmp(leds, data + 10, 7) == 0);
+	CHECK_EQ(leds[2].g, 0xEE);
+	CHECK(untouched(leds + 3, 17));
+
+	// nothing at all reaches the leds, but the universe is still received
+	CHECK(udp.deliver(receiver, packet, artdmx(0, 0, data, 10)));
+	CHECK(memcmp(leds, data + 10, 7) == 0);
+
+	// the end of the universe cuts the leds off
+	CHECK(udp.deliver(receiver, packet, artdmx(1, 0, data, 512)));
+	CHECK(landed(leds + 20, 2, data + 505));
+	CHECK_EQ(leds[22].r, data[511]);
+	CHECK_EQ(leds[22].g, 0xEE);
+	CHECK(untouched(leds + 23, 17));
+
+	// more than a universe, or more than the packet has
+	clear_leds();
+	uint16_t size = artdmx(0, 0, data, 512);
+	put_be16(packet + 16, 513);
+	CHECK(!udp.deliver(receiver, packet, size));
+	size = artdmx(0, 0, data, 100);
+	CHECK(!udp.deliver(receiver, packet, size - 1));
+	CHECK(!udp.deliver(receiver, packet, 17));
+	size = e131(0, 0, data, 100);
+	put_be16(packet + 123, 102);
+	CHECK(!udp.deliver(receiver, packet, size));
+	size = e131(0, 0, data, 512);
+	put_be16(packet + 123, 514);
+	CHECK(!udp.deliver(receiver, packet, size));
+	CHECK(untouched(leds, 40));
+
+	// and a packet longer than its data is fine
+	size = artdmx(0, 0, data, 40);
+	CHECK(udp.deliver(receiver, packet, size + 10));
+	CHECK(landed(leds, 10, data + 10));
+}
+
+// packets up to 20 behind the last one are dropped, for each mapping of its own
+static void test_sequence(Loopback & udp, uint32_t & seed) {
+	CDMXReceiver receiver;
+	receiver.setFrameCallback(on_frame);
+	receiver.addUniverse(5, leds, 4);
+	receiver.addUniverse(6, leds + 4, 4);
+	fill_random(data, 512, seed);
+
+	struct Step { uint8_t sequence; bool used; };
+	static const Step steps[] = {
+		{ 100, true },   // the first is always taken
+		{ 100, false },  // the same again
+		{ 99, false },
+		{ 81, false },   // 19 behind
+		{ 101, true },
+		{ 81, true },    // 20 behind, so the source has restarted
+		{ 82, true },
+		{ 200, true },   // any distance ahead
+		{ 255, true },
+		{ 0, true },     // wrapping around
+		{ 240, false },  // 16 behind, across the wrap
+		{ 236, true },   // 20 behind, across the wrap
+	};
+	for(int proto = 0; proto < 2; ++proto) {
+		receiver.clearUniverses();
+		receiver.addUniverse(5, leds, 4);
+		receiver.addUniverse(6, leds + 4, 4);
+		for(size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); ++s) {
+			clear_leds();
+			data[0] = s;
+			uint16_t size = proto ? e131(5, steps[s].sequence, data, 12) : artdmx(5, steps[s].sequence, data, 12);
+			bool used = udp.deliver(receiver, packet, size);
+			if(used != steps[s].used) {
+				printf("%s sequence %d, step %d, was %s\n", proto ? "E1.31" : "Art-Net", steps[s].sequence, (int)s, used ? "used" : "dropped");
+				++test_failures;
+			}
+			CHECK(used ? landed(leds, 4, data) : untouched(leds, 4));
+		}
+		// the other universe has its own sequence
+		CHECK(udp.deliver(receiver, packet, proto ? e131(6, 3, data, 12) : artdmx(6, 3, data, 12)));
+		CHECK(udp.deliver(receiver, packet, proto ? e131(6, 4, data, 12) : artdmx(6, 4, data, 12)));
+		CHECK(!udp.deliver(receiver, packet, proto ? e131(6, 4, data, 12) : artdmx(6, 4, data, 12)));
+	}
+
+	// a sequence number of 0 turns the check off for Art-Net
+	receiver.clearUniverses();
+	receiver.addUniverse(5, leds, 4);
+	CHECK(udp.deliver(receiver, packet, artdmx(5, 50, data, 12)));
+	CHECK(udp.deliver(receiver, packet, artdmx(5, 0, data, 12)));
+	CHECK(udp.deliver(receiver, packet, artdmx(5, 0, data, 12)));
+}
+
+// E1.31 packets that aren't live data for the leds
+static void test_rejected(Loopback & udp, uint32_t & seed) {
+	CDMXReceiver receiver;
+	receiver.setFrameCallback(on_frame);
+	receiver.addUniverse(9, leds, 30);
+	fill_random(data, 512, seed);
+	clear_leds();
+	frames_shown = 0;
+
+	uint8_t sequence = 1;
+	CHECK(!udp.deliver(receiver, packet, e131(9, sequence++, data, 90, 0, 0x80)));  // preview
+	CHECK(!udp.deliver(receiver, packet, e131(9, sequence++, data, 90, 0, 0x40)));  // terminated
+	CHECK(!udp.deliver(receiver, packet, e131(9, sequence++, data, 90, 0, 0xC0)));
+	uint16_t size = e131(9, sequence++, data, 90);
+	packet[125] = 0xDD;                                                              // not DMX
+	CHECK(!udp.deliver(receiver, packet, size));
+	size = e131(9, sequence++, data, 90);
+	packet[118] = 0xA2;
+	CHECK(!udp.deliver(receiver, packet, size));
+	size = e131(9, sequence++, data, 90);
+	put_be32(packet + 40, 0x00000003);
+	CHECK(!udp.deliver(receiver, packet, size));
+	size = e131(9, sequence++, data, 90);
+	packet[4] = 'B';
+	CHECK(!udp.deliver(receiver, packet, size));
+	size = artdmx(9, sequence++, data, 90);
+	packet[9] = 0x20;                                                                // OpPoll
+	CHECK(!udp.deliver(receiver, packet, size));
+	CHECK(untouched(leds, 30));
+	CHECK_EQ(frames_shown, 0);
+
+	// the options that are allowed
+	CHECK(udp.deliver(receiver, packet, e131(9, sequence++, data, 90, 0, 0x20)));
+	CHECK(landed(leds, 30, data));
+	CHECK_EQ(frames_shown, 1);
+}
+
+// with syncs, a frame is shown on the sync and only then, whether it's complete or not
+static void test_sync(Loopback & udp, uint32_t & seed) {
+	CDMXReceiver receiver;
+	receiver.setFrameCallback(on_frame);
+	receiver.addUniverse(1, leds, 10);
+	receiver.addUniverse(2, leds + 10, 10);
+	fill_random(data, 512, seed);
+	frames_shown = 0;
+
+	// a sync before any data doesn't show anything, but switches to syncing
+	CHECK(udp.deliver(receiver, packet, artsync()));
+	CHECK_EQ(frames_shown, 0);
+	CHECK(udp.deliver(receiver, packet, artdmx(1, 1, data, 60)));
+	CHECK(udp.deliver(receiver, packet, artdmx(2, 1, data, 60)));
+	CHECK_EQ(frames_shown, 0);
+	CHECK(udp.deliver(receiver, packet, artsync()));
+	CHECK_EQ(frames_shown, 1);
+	CHECK(udp.deliver(receiver, packet, artsync()));
+	CHECK_EQ(frames_shown, 1);
+	// part of a frame is shown on a sync too
+	CHECK(udp.deliver(receiver, packet, artdmx(1, 2, data, 60)));
+	CHECK(udp.deliver(receiver, packet, artsync()));
+	CHECK_EQ(frames_shown, 2);
+	CHECK_EQ(receiver.getFrames(), 2);
+
+	// E1.31 syncs to the universe named in the data
+	CDMXReceiver sacn;
+	sacn.setFrameCallback(on_frame);
+	sacn.addUniverse(1, leds, 10);
+	sacn.addUniverse(2, leds + 10, 10);
+	CHECK(!udp.deliver(sacn, packet, e131_sync(7000, 1)));
+	CHECK(udp.deliver(sacn, packet, e131(1, 1, data, 60, 7000)));
+	CHECK(udp.deliver(sacn, packet, e131(2, 1, data, 60, 7000)));
+	CHECK_EQ(frames_shown, 2);
+	CHECK(!udp.deliver(sacn, packet, e131_sync(7001, 2)));
+	CHECK_EQ(frames_shown, 2);
+	CHECK(udp.deliver(sacn, packet, e131_sync(7000, 3)));
+	CHECK_EQ(frames_shown, 3);
+	CHECK(udp.deliver(sacn, packet, e131_sync(7000, 4)));
+	CHECK_EQ(frames_shown, 3);
+	// and goes back to complete frames when the data stops naming one
+	CHECK(udp.deliver(sacn, packet, e131(1, 2, data, 60)));
+	CHECK(udp.deliver(sacn, packet, e131(2, 2, data, 60)));
+	CHECK_EQ(frames_shown, 4);
+	CHECK(!udp.deliver(sacn, packet, e131_sync(7000, 5)));
+	CHECK_EQ(frames_shown, 4);
+}
+
+// without a callback, a frame is FastLED.show(), with the controller flagged as changed
+static void test_show(Loopback & udp, uint32_t & seed) {
+	CLEDController & controller = FastLED.addLeds<WS2812B, 2, RGB>(strip, 200);
+	controller.setChangeDetection(CHANGE_DETECT_MANUAL);
+	FastLED.setMaxRefreshRate(0);
+	FastLED.setBrightness(255);
+	FastLED.show();
+	HostWire & wire = HostWire::get(2);
+	uint32_t frames = wire.frames();
+
+	CDMXReceiver receiver;
+	CHECK_EQ(receiver.addUniverses(10, controller), 2);
+	for(int f = 0; f < 3; ++f) {
+		fill_random(data, 512, seed);
+		CHECK(udp.deliver(receiver, packet, artdmx(10, f + 1, data, 510)));
+		CHECK_EQ(wire.frames(), frames + f);
+		CHECK(udp.deliver(receiver, packet, artdmx(11, f + 1, data + 90, 90)));
+		CHECK_EQ(wire.frames(), frames + f + 1);
+		CHECK(wire.size() == 600 && memcmp(wire.bytes(), data, 510) == 0 && memcmp(wire.bytes() + 510, data + 90, 90) == 0);
+	}
+}
+
+int main() {
+	uint32_t seed = 17;
+	Loopback udp;
+	test_mapping(udp, seed);
+	test_clipping(udp, seed);
+	test_sequence(udp, seed);
+	test_rejected(udp, seed);
+	test_sync(udp, seed);
+	test_show(udp, seed);
+	TEST_RESULT();
+}
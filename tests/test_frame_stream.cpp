@@ -0,0 +1,401 @@
+// Checks of recording frames with CFrameRecorder and playing them back with CFramePlayer: the
+// bytes of the header, ops (short and long counts) and trailer, round trips of frames of every
+// kind, gathering several controllers' leds, seeking to keyframes and between them, streams
+// that were never finished, and truncated or corrupt streams, which have to fail without
+// writing a led past the end of where they're playing into.
+
+#include "test.h"
+#include <string.h>
+
+#define NUM_LEDS 300
+#define FRAMES 120
+#define KEY_INTERVAL 10
+#define GUARD 8
+#define STREAM_SIZE (FRAMES * (NUM_LEDS * 3 + 200) + 4096)
+
+CRGB frames[FRAMES][NUM_LEDS];
+uint8_t brightness[FRAMES];
+uint8_t stream[STREAM_SIZE];
+uint8_t broken[STREAM_SIZE];
+CRGB leds[NUM_LEDS];
+// playback goes into the middle, with guards on either side
+CRGB guarded[GUARD + NUM_LEDS + GUARD];
+
+static const CRGB GuardColor(0xA5, 0x5A, 0xC3);
+
+// a color that's different from its neighbors, so a run of them is all literal
+static CRGB distinct(int i) { return CRGB(i, 255 - i, i * 3); }
+
+// frames of every kind, each built from the one before
+static void make_frames(uint32_t & seed) {
+	for(int f = 0; f < FRAMES; ++f) {
+		CRGB *l = frames[f];
+		if(f) { memcpy(l, frames[f - 1], sizeof(frames[f])); }
+		brightness[f] = 255 - f;
+		switch(f % 8) {
+			case 0:  // all new
+				for(int i = 0; i < NUM_LEDS; ++i) { l[i] = CRGB(test_random(seed), test_random(seed), test_random(seed)); }
+				break;
+			case 1:  // no change at all
+				break;
+			case 2:  // one color
+				fill_solid(l, NUM_LEDS, CRGB(f, 2, 3));
+				break;
+			case 3:  // a few leds here and there
+				for(int k = 0; k < 5; ++k) { l[test_random(seed) % NUM_LEDS] = CRGB(test_random(seed), 0, f); }
+				break;
+			case 4:  // runs and literals either side of the longest short count
+				fill_solid(l + 10, 64, CRGB(1, f, 1));
+				for(int i = 100; i < 163; ++i) { l[i] = distinct(i + f); }
+				for(int i = 200; i < 265; ++i) { l[i] = distinct(i * 2 + f); }
+				break;
+			case 5:  // runs of every length
+				for(int i = 0, n = 1; i < NUM_LEDS; i += n, ++n) {
+					fill_solid(l + i, (i + n <= NUM_LEDS) ? n : NUM_LEDS - i, CRGB(n, f, 0));
+				}
+				break;
+			case 6:  // pairs, which aren't worth a run
+				for(int i = 0; i < NUM_LEDS; ++i) { l[i] = distinct(i / 2 + f); }
+				break;
+			case 7:  // the last led
+				l[NUM_LEDS - 1] = CRGB(f, f, f);
+				break;
+		}
+	}
+}
+
+static uint32_t record(CMemoryFrameWriter & writer, int count, bool finish) {
+	writer.clear();
+	CFrameRecorder recorder(writer, KEY_INTERVAL);
+	recorder.setLeds(leds, NUM_LEDS);
+	CHECK(recorder.begin(50));
+	for(int f = 0; f < count; ++f) {
+		memcpy(leds, frames[f], sizeof(leds));
+		CHECK(recorder.recordFrame(brightness[f]));
+	}
+	CHECK_EQ(recorder.getFrames(), count);
+	CHECK_EQ(recorder.getBytesWritten(), writer.size());
+	if(finish) {
+		CHECK(recorder.finish());
+		// frames after the end are ignored
+		CHECK(!recorder.recordFrame());
+	}
+	return writer.size();
+}
+
+static void clear_guarded() {
+	for(int i = 0; i < GUARD + NUM_LEDS + GUARD; ++i) { guarded[i] = GuardColor; }
+}
+
+static bool guards_intact(int count) {
+	for(int i = 0; i < GUARD; ++i) {
+		if(guarded[i] != GuardColor || guarded[GUARD + count + i] != GuardColor) { return false; }
+	}
+	return true;
+}
+
+// the exact bytes of a short stream
+static void test_bytes() {
+	uint8_t out[4096];
+	CMemoryFrameWriter writer(out, sizeof(out));
+	CFrameRecorder recorder(writer, 2);
+	recorder.setLeds(leds, NUM_LEDS);
+	CHECK(recorder.begin(30));
+
+	fill_solid(leds, NUM_LEDS, CRGB::Red);
+	recorder.recordFrame(200);
+	recorder.recordFrame(201);
+	fill_solid(leds, 63, CRGB::Lime);
+	fill_solid(leds + 63, 64, CRGB::Blue);
+	for(int i = 127; i < 192; ++i) { leds[i] = distinct(i); }
+	fill_solid(leds + 192, NUM_LEDS - 192, CRGB::Black);
+	uint32_t key = recorder.getBytesWritten();
+	recorder.recordFrame(202);
+	leds[5] = CRGB::White;
+	leds[200] = CRGB::White;
+	recorder.recordFrame(203);
+	uint32_t index = recorder.getBytesWritten();
+	CHECK(recorder.finish());
+
+	uint8_t want[4096];
+	uint32_t n = 0;
+	const uint8_t header[16] = { 'F', 'L', 'F', 'S', 1, 0, NUM_LEDS & 0xFF, NUM_LEDS >> 8, 30, 0, 2, 0, 0, 0, 0, 0 };
+	memcpy(want, header, 16); n = 16;
+	// a keyframe of one color, with a 3 byte op for its 300 leds
+	const uint8_t red[] = { 0x01, 200, 0x7F, 236, 0, 255, 0, 0 };
+	memcpy(want + n, red, sizeof(red)); n += sizeof(red);
+	// no change
+	const uint8_t same[] = { 0x00, 201, 0x3F, 236, 0 };
+	memcpy(want + n, same, sizeof(same)); n += sizeof(same);
+	// 63 leds fit in one byte, 64 don't
+	const uint8_t runs[] = { 0x01, 202, 0x40 | 62, 0, 255, 0, 0x7F, 0, 0, 0, 0, 255, 0xBF, 1, 0 };
+	memcpy(want + n, runs, sizeof(runs)); n += sizeof(runs);
+	for(int i = 127; i < 192; ++i) { memcpy(want + n, distinct(i).raw, 3); n += 3; }
+	const uint8_t black[] = { 0x7F, NUM_LEDS - 192 - 64, 0, 0, 0, 0 };
+	memcpy(want + n, black, sizeof(black)); n += sizeof(black);
+	// skips around the two leds that changed
+	const uint8_t changed[] = { 0x00, 203, 0x04, 0x80, 255, 255, 255, 0x3F, 194 - 64, 0, 0x80, 255, 255, 255, 0x3F, 99 - 64, 0 };
+	memcpy(want + n, changed, sizeof(changed)); n += sizeof(changed);
+	CHECK_EQ(n, index);
+	// the index of the two keyframes, and the trailer
+	const uint8_t trailer[] = { 16, 0, 0, 0, (uint8_t)key, (uint8_t)(key >> 8), 0, 0,
+	                            4, 0, 0, 0, (uint8_t)index, (uint8_t)(index >> 8), 0, 0, 'F', 'L', 'F', 'E' };
+	memcpy(want + n, trailer, sizeof(trailer)); n += sizeof(trailer);
+
+	CHECK_EQ(writer.size(), n);
+	for(uint32_t i = 0; i < n && i < writer.size(); ++i) {
+		if(out[i] != want[i]) {
+			printf("byte %u is %02x, not %02x\n", (unsigned)i, out[i], want[i]);
+			++test_failures;
+			break;
+		}
+	}
+}
+
+// every frame back, in order, with its brightness
+static void test_round_trip() {
+	CMemoryFrameWriter writer(stream, sizeof(stream));
+	uint32_t size = record(writer, FRAMES, true);
+	// the unchanged frames take a handful of bytes
+	CHECK(size < FRAMES * NUM_LEDS * 3 / 2);
+
+	CMemoryFrameReader reader(stream, size);
+	CFramePlayer player(reader);
+	player.setLeds(guarded + GUARD, NUM_LEDS);
+	clear_guarded();
+	CHECK(player.begin());
+	CHECK_EQ(player.getFrameCount(), FRAMES);
+	CHECK_EQ(player.getFrameRate(), 50);
+	CHECK_EQ(player.getNumLeds(), NUM_LEDS);
+	for(int f = 0; f < FRAMES && !TEST_GIVE_UP(); ++f) {
+		CHECK_EQ(player.getFrame(), f);
+		CHECK(player.readFrame());
+		CHECK(memcmp(guarded + GUARD, frames[f], sizeof(frames[f])) == 0);
+		CHECK_EQ(player.getBrightness(), brightness[f]);
+	}
+	CHECK(!player.readFrame());
+	CHECK(guards_intact(NUM_LEDS));
+
+	// into fewer leds than the stream has, and into more
+	static const uint16_t counts[] = { 0, 1, 63, 64, 65, 299, 100 };
+	for(size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+		clear_guarded();
+		player.setLeds(guarded + GUARD, counts[c]);
+		CHECK(player.begin());
+		for(int f = 0; f < FRAMES; ++f) { CHECK(player.readFrame()); }
+		CHECK(memcmp(guarded + GUARD, frames[FRAMES - 1], counts[c] * sizeof(CRGB)) == 0);
+		CHECK(guards_intact(counts[c]));
+	}
+	CRGB more[NUM_LEDS + 10];
+	fill_solid(more, NUM_LEDS + 10, GuardColor);
+	player.setLeds(more, NUM_LEDS + 10);
+	CHECK(player.begin());
+	CHECK(player.readFrame());
+	CHECK(memcmp(more, frames[0], sizeof(frames[0])) == 0);
+	for(int i = NUM_LEDS; i < NUM_LEDS + 10; ++i) { CHECK(more[i] == GuardColor); }
+}
+
+// seeking to every frame, keyframes and not, in a jumbled order
+static void test_seek(uint32_t & seed) {
+	CMemoryFrameWriter writer(stream, sizeof(stream));
+	uint32_t size = record(writer, FRAMES, true);
+	CMemoryFrameReader reader(stream, size);
+	CFramePlayer player(reader);
+	player.setLeds(leds, NUM_LEDS);
+	CHECK(player.begin());
+
+	for(int k = 0; k < 3 * FRAMES && !TEST_GIVE_UP(); ++k) {
+		uint32_t f = (k < FRAMES) ? (FRAMES - 1 - k) : test_random(seed) % FRAMES;
+		if(k % 7 == 0) { f = (f / KEY_INTERVAL) * KEY_INTERVAL; }
+		CHECK(player.seek(f));
+		CHECK_EQ(player.getFrame(), f);
+		// between keyframes the frames before it have been decoded
+		if(f % KEY_INTERVAL) { CHECK(memcmp(leds, frames[f - 1], sizeof(leds)) == 0); }
+		CHECK(player.readFrame());
+		if(memcmp(leds, frames[f], sizeof(leds)) != 0) {
+			printf("seeking to frame %u\n", (unsigned)f);
+			++test_failures;
+		}
+		CHECK_EQ(player.getBrightness(), brightness[f]);
+	}
+
+	// the end, and past it
+	CHECK(player.seek(FRAMES));
+	CHECK(!player.readFrame());
+	CHECK(!player.seek(FRAMES + 1));
+	CHECK(player.seek(0));
+	CHECK(player.readFrame());
+	CHECK(memcmp(leds, frames[0], sizeof(leds)) == 0);
+}
+
+// a stream with no trailer plays to its end, and seeks from the start
+static void test_unfinished(uint32_t & seed) {
+	static const int counts[] = { 0, 1, KEY_INTERVAL, 37 };
+	for(size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+		CMemoryFrameWriter writer(stream, sizeof(stream));
+		uint32_t size = record(writer, counts[c], false);
+		CMemoryFrameReader reader(stream, size);
+		CFramePlayer player(reader);
+		player.setLeds(leds, NUM_LEDS);
+		CHECK(player.begin());
+		CHECK_EQ(player.getFrameCount(), 0xFFFFFFFF);
+		for(int f = 0; f < counts[c]; ++f) {
+			CHECK(player.readFrame());
+			CHECK(memcmp(leds, frames[f], sizeof(leds)) == 0);
+		}
+		CHECK(!player.readFrame());
+
+		for(int k = 0; k < 10 && counts[c]; ++k) {
+			uint32_t f = test_random(seed) % counts[c];
+			CHECK(player.seek(f));
+			CHECK(player.readFrame());
+			CHECK(memcmp(leds, frames[f], sizeof(leds)) == 0);
+		}
+		CHECK(!player.seek(counts[c] + 1));
+	}
+}
+
+// play as much of a stream as it will, checking the frames that do decode
+static void play_broken(uint32_t size, int count, bool truncated) {
+	CMemoryFrameReader reader(broken, size);
+	CFramePlayer player(reader);
+	player.setLeds(guarded + GUARD, NUM_LEDS);
+	clear_guarded();
+	if(!player.begin()) {
+		CHECK(size < 16 || !truncated);
+		return;
+	}
+	int f = 0;
+	while(f < count + 5 && player.readFrame()) {
+		if(truncated) { CHECK(memcmp(guarded + GUARD, frames[f], sizeof(frames[f])) == 0); }
+		++f;
+	}
+	CHECK(guards_intact(NUM_LEDS));
+	if(truncated) { CHECK(f <= count); }
+	player.seek((f * 3) / 2);
+	player.seek(f / 2);
+	CHECK(guards_intact(NUM_LEDS));
+}
+
+// streams cut short, and streams with bytes changed, fail without writing past the leds
+static void test_broken(uint32_t & seed) {
+	CMemoryFrameWriter writer(stream, sizeof(stream));
+	uint32_t size = record(writer, 40, true);
+	for(uint32_t cut = 0; cut + 12 < size && !TEST_GIVE_UP(); cut += (cut < 200) ? 1 : 37) {
+		memcpy(broken, stream, cut);
+		play_broken(cut, 40, true);
+	}
+	for(int k = 0; k < 2000 && !TEST_GIVE_UP(); ++k) {
+		memcpy(broken, stream, size);
+		for(int n = 1 + k % 4; n > 0; --n) {
+			uint32_t at = 16 + test_random(seed) % (size - 16);
+			broken[at] = (k & 1) ? (uint8_t)test_random(seed) : (broken[at] ^ (1 << (k % 8)));
+		}
+		play_broken(size, 40, false);
+	}
+
+	// headers that aren't ones to play
+	CMemoryFrameReader reader(broken, size);
+	CFramePlayer player(reader);
+	const int bad[] = { 0, 3, 4, 10 };
+	for(size_t b = 0; b < sizeof(bad) / sizeof(bad[0]); ++b) {
+		memcpy(broken, stream, size);
+		broken[bad[b]] = (bad[b] == 10) ? 0 : broken[bad[b]] + 1;
+		if(bad[b] == 10) { broken[11] = 0; }
+		CHECK(!player.begin());
+		CHECK(!player.readFrame());
+		CHECK(!player.seek(0));
+	}
+}
+
+// several controllers recorded through FastLED.show(), gathered into one frame, and played
+// back into them
+static void test_controllers(uint32_t & seed) {
+	// the controllers' leds, with guards between them
+	static CRGB a[GUARD + 50 + GUARD], b[GUARD + 100 + GUARD];
+	static CRGB16 c16[20];
+	fill_solid(a, GUARD + 50 + GUARD, GuardColor);
+	fill_solid(b, GUARD + 100 + GUARD, GuardColor);
+	FastLED.addLeds<WS2812B, 2, GRB>(a + GUARD, 50);
+	FastLED.addLeds<WS2812B, 3, GRB>(leds, 0);
+	FastLED.addLeds<APA102, 4, 5, BGR>(b + GUARD, 100);
+	// 16 bit leds are left out
+	FastLED.addLeds<WS2812B, 6, GRB>(c16, 20);
+	FastLED.setMaxRefreshRate(0);
+
+	CMemoryFrameWriter writer(stream, sizeof(stream));
+	CFrameRecorder recorder(writer, 4);
+	FastLED.setRecorder(&recorder);
+	CHECK(recorder.begin(25));
+	static CRGB want[FRAMES][150];
+	for(int f = 0; f < 20; ++f) {
+		for(int i = 0; i < 150; ++i) {
+			want[f][i] = (f % 3 == 1) ? want[f - 1][i] : CRGB(test_random(seed), f, (i < 50) ? 1 : 2);
+		}
+		memcpy(a + GUARD, want[f], 50 * sizeof(CRGB));
+		memcpy(b + GUARD, want[f] + 50, 100 * sizeof(CRGB));
+		FastLED.show(100 + f);
+	}
+	FastLED.setRecorder(NULL);
+	CHECK_EQ(recorder.getFrames(), 20);
+	CHECK(recorder.finish());
+
+	// into an array, all of the leds one after the other
+	CMemoryFrameReader reader(stream, writer.size());
+	CFramePlayer player(reader);
+	player.setLeds(guarded + GUARD, NUM_LEDS);
+	CHECK(player.begin());
+	CHECK_EQ(player.getNumLeds(), 150);
+	for(int f = 0; f < 20; ++f) {
+		CHECK(player.readFrame());
+		CHECK(memcmp(guarded + GUARD, want[f], 150 * sizeof(CRGB)) == 0);
+		CHECK_EQ(player.getBrightness(), 100 + f);
+	}
+
+	// into the controllers, and shown
+	fill_solid(a + GUARD, 50, CRGB::Black);
+	fill_solid(b + GUARD, 100, CRGB::Black);
+	player.setLeds(NULL, 0);
+	CHECK(player.begin());
+	HostWire & wire = HostWire::get(4);
+	for(int f = 0; f < 20; ++f) {
+		uint32_t shown = wire.frames();
+		CHECK(player.showFrame());
+		CHECK_EQ(wire.frames(), shown + 1);
+		CHECK(memcmp(a + GUARD, want[f], 50 * sizeof(CRGB)) == 0);
+		CHECK(memcmp(b + GUARD, want[f] + 50, 100 * sizeof(CRGB)) == 0);
+	}
+	CHECK(!player.showFrame());
+	CHECK(player.seek(13));
+	CHECK(player.readFrame());
+	CHECK(memcmp(b + GUARD, want[13] + 50, 100 * sizeof(CRGB)) == 0);
+
+	// corrupt streams don't write past any of the controllers' leds
+	uint32_t size = writer.size();
+	for(int k = 0; k < 500; ++k) {
+		memcpy(broken, stream, size);
+		uint32_t at = 16 + test_random(seed) % (size - 16);
+		broken[at] = test_random(seed);
+		CMemoryFrameReader corrupt(broken, (k & 1) ? size : at + 1);
+		CFramePlayer bad(corrupt);
+		if(bad.begin()) {
+			while(bad.readFrame()) {}
+		}
+	}
+	for(int i = 0; i < GUARD; ++i) {
+		CHECK(a[i] == GuardColor && a[GUARD + 50 + i] == GuardColor);
+		CHECK(b[i] == GuardColor && b[GUARD + 100 + i] == GuardColor);
+	}
+}
+
+int main() {
+	uint32_t seed = 18;
+	make_frames(seed);
+	test_bytes();
+	test_round_trip();
+	test_seek(seed);
+	test_unfinished(seed);
+	test_broken(seed);
+	test_controllers(seed);
+	TEST_RESULT();
+}
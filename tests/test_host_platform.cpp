@@ -0,0 +1,241 @@
+// Checks of the host platform's recording controllers, and of what show() sends through them:
+// byte order, brightness and color correction, dithering, reversed strips, the pulse trains, and
+// which frames change detection skips.
+
+#include "test.h"
+
+#define NUM_LEDS 40
+
+CRGB leds[NUM_LEDS];
+CRGB reversed[NUM_LEDS];
+CRGB spi[NUM_LEDS];
+
+static void fill_test_pattern(CRGB *data, int n) {
+	uint32_t seed = 1;
+	for(int i = 0; i < n; ++i) {
+		uint32_t r = test_random(seed);
+		data[i] = CRGB(r, r >> 8, r >> 16);
+	}
+}
+
+// the bytes of the leds in GRB order, scaled the way PixelController does without dithering
+static void check_grb(HostWire & wire, const CRGB *data, int n, CRGB scale) {
+	CHECK_EQ(wire.size(), n * 3);
+	for(int i = 0; i < n && i * 3 + 2 < wire.size() && !TEST_GIVE_UP(); ++i) {
+		CHECK_EQ(wire.bytes()[i * 3 + 0], scale8(data[i].g, scale.g));
+		CHECK_EQ(wire.bytes()[i * 3 + 1], scale8(data[i].r, scale.r));
+		CHECK_EQ(wire.bytes()[i * 3 + 2], scale8(data[i].b, scale.b));
+	}
+}
+
+static void test_clockless_bytes(CLEDController & controller) {
+	HostWire & wire = HostWire::get(2);
+	fill_test_pattern(leds, NUM_LEDS);
+
+	uint32_t frames = wire.frames();
+	FastLED.show(255);
+	CHECK_EQ(wire.frames(), frames + 1);
+	check_grb(wire, leds, NUM_LEDS, CRGB(255, 255, 255));
+
+	// brightness
+	FastLED.show(100);
+	check_grb(wire, leds, NUM_LEDS, CRGB(100, 100, 100));
+
+	// color correction is applied on top of the brightness
+	controller.setCorrection(CRGB(255, 128, 64));
+	FastLED.show(200);
+	check_grb(wire, leds, NUM_LEDS, CLEDController::computeAdjustment(200, CRGB(255, 128, 64), UncorrectedTemperature));
+	controller.setCorrection(UncorrectedColor);
+}
+
+static void test_dithering(CLEDController & controller) {
+	HostWire & wire = HostWire::get(2);
+	controller.setDither(BINARY_DITHER);
+
+	// a level between two output values is dithered across frames, and averages back to about where it was
+	fill_solid(leds, NUM_LEDS, CRGB(77, 77, 77));
+	uint32_t sum = 0;
+	const int frames = 64;
+	for(int f = 0; f < frames; ++f) {
+		FastLED.show(64);
+		sum += wire.bytes()[0];
+	}
+	// 77 * 64 / 256 is 19.25
+	CHECK(sum >= 19 * frames && sum <= 20 * frames);
+
+	// black stays black
+	fill_solid(leds, NUM_LEDS, CRGB::Black);
+	for(int f = 0; f < 8; ++f) {
+		FastLED.show(64);
+		CHECK_EQ(wire.bytes()[0], 0);
+	}
+	controller.setDither(DISABLE_DITHER);
+}
+
+static void test_reversed() {
+	HostWire & wire = HostWire::get(3);
+	fill_test_pattern(reversed, NUM_LEDS);
+	FastLED.show(255);
+	CHECK_EQ(wire.size(), NUM_LEDS * 3);
+	for(int i = 0; i < NUM_LEDS && !TEST_GIVE_UP(); ++i) {
+		const CRGB & led = reversed[NUM_LEDS - 1 - i];
+		CHECK_EQ(wire.bytes()[i * 3 + 0], led.g);
+		CHECK_EQ(wire.bytes()[i * 3 + 1], led.r);
+		CHECK_EQ(wire.bytes()[i * 3 + 2], led.b);
+	}
+}
+
+static void test_pulses() {
+	HostWire & wire = HostWire::get(2);
+	wire.recordPulses(true);
+	fill_solid(leds, NUM_LEDS, CRGB::Black);
+	leds[0] = CRGB(0, 0x80, 0);  // GRB, so the first bit sent is a 1
+	FastLED.show(255);
+	CHECK_EQ(wire.pulseCount(), NUM_LEDS * 24);
+	if(wire.pulseCount() >= 2) {
+		const HostPulse & one = wire.pulses()[0];
+		const HostPulse & zero = wire.pulses()[1];
+		CHECK(one.high > zero.high);
+		CHECK_EQ(one.high + one.low, zero.high + zero.low);
+	}
+	wire.recordPulses(false);
+}
+
+static void test_spi() {
+	HostWire & wire = HostWire::get(4);
+	fill_test_pattern(spi, NUM_LEDS);
+	FastLED.show(255);
+
+	// a 4 byte start frame, 4 bytes per led (brightness first), then the end frame
+	CHECK(wire.size() >= 4 + NUM_LEDS * 4);
+	for(int i = 0; i < 4; ++i) {
+		CHECK_EQ(wire.bytes()[i], 0);
+	}
+	for(int i = 0; i < NUM_LEDS && 4 + i * 4 + 3 < wire.size() && !TEST_GIVE_UP(); ++i) {
+		const uint8_t *b = wire.bytes() + 4 + i * 4;
+		CHECK_EQ(b[0] & 0xE0, 0xE0);
+		CHECK_EQ(b[1], spi[i].b);
+		CHECK_EQ(b[2], spi[i].g);
+		CHECK_EQ(b[3], spi[i].r);
+	}
+}
+
+// whether show() sent the leds on a wire since the last call
+static bool sent(HostWire & wire, uint32_t & frames) {
+	bool was = wire.frames() != frames;
+	frames = wire.frames();
+	return was;
+}
+
+static void test_change_detection(CLEDController & controller, CLEDController & backward) {
+	HostWire & wire = HostWire::get(2);
+	HostWire & back = HostWire::get(3);
+	uint32_t frames = wire.frames(), backFrames = back.frames();
+	fill_test_pattern(leds, NUM_LEDS);
+	fill_test_pattern(reversed, NUM_LEDS);
+	controller.setChangeDetection(CHANGE_DETECT_HASH, 0);
+	backward.setChangeDetection(CHANGE_DETECT_HASH, 0);
+
+	// the first show after setting it up always sends
+	FastLED.show(200);
+	CHECK(sent(wire, frames));
+	CHECK(sent(back, backFrames));
+	check_grb(wire, leds, NUM_LEDS, CRGB(200, 200, 200));
+
+	// an unchanged frame is skipped, however often it's shown
+	for(int i = 0; i < 3; ++i) {
+		FastLED.show(200);
+		CHECK(!sent(wire, frames));
+		CHECK(!sent(back, backFrames));
+	}
+
+	// a change to a single byte anywhere is sent, including the last led, and the first led in
+	// memory of a reversed strip, which it sends last
+	static const int changed[] = { 0, 17, NUM_LEDS - 1 };
+	for(size_t i = 0; i < sizeof(changed) / sizeof(changed[0]); ++i) {
+		for(int c = 0; c < 3; ++c) {
+			leds[changed[i]].raw[c] ^= 1;
+			FastLED.show(200);
+			CHECK(sent(wire, frames));
+			CHECK(!sent(back, backFrames));
+			check_grb(wire, leds, NUM_LEDS, CRGB(200, 200, 200));
+			FastLED.show(200);
+			CHECK(!sent(wire, frames));
+		}
+	}
+	reversed[0].b ^= 0x80;
+	FastLED.show(200);
+	CHECK(!sent(wire, frames));
+	CHECK(sent(back, backFrames));
+	CHECK_EQ(back.bytes()[NUM_LEDS * 3 - 1], scale8(reversed[0].b, 200));
+
+	// so is a change of brightness or color correction
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+	CHECK(sent(back, backFrames));
+	check_grb(wire, leds, NUM_LEDS, CRGB(201, 201, 201));
+	FastLED.show(201);
+	CHECK(!sent(wire, frames));
+	controller.setCorrection(CRGB(255, 200, 100));
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+	CHECK(!sent(back, backFrames));
+	controller.setCorrection(UncorrectedColor);
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+
+	// setDirty() sends the leds even though nothing changed
+	controller.setDirty();
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+	CHECK(!sent(back, backFrames));
+	FastLED.show(201);
+	CHECK(!sent(wire, frames));
+
+	// with manual detection only setDirty() does
+	controller.setChangeDetection(CHANGE_DETECT_MANUAL, 0);
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+	leds[5] = CRGB::White;
+	FastLED.show(201);
+	CHECK(!sent(wire, frames));
+	controller.setDirty();
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+	check_grb(wire, leds, NUM_LEDS, CRGB(201, 201, 201));
+
+	// the refresh resends an unchanged frame once it's been long enough
+	controller.setChangeDetection(CHANGE_DETECT_HASH, 20);
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+	FastLED.show(201);
+	CHECK(!sent(wire, frames));
+	delay(25);
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+
+	// and without detection every frame is sent
+	controller.setChangeDetection(CHANGE_DETECT_NONE);
+	backward.setChangeDetection(CHANGE_DETECT_NONE);
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+	FastLED.show(201);
+	CHECK(sent(wire, frames));
+	CHECK(sent(back, backFrames));
+}
+
+int main() {
+	CLEDController & controller = FastLED.addLeds<WS2812B, 2, GRB>(leds, NUM_LEDS);
+	CLEDController & backward = FastLED.addLeds<WS2812B, 3, GRB>(reversed + NUM_LEDS - 1, -NUM_LEDS);
+	FastLED.addLeds<APA102, 4, 5, BGR>(spi, NUM_LEDS);
+	FastLED.setDither(DISABLE_DITHER);
+
+	test_clockless_bytes(controller);
+	test_dithering(controller);
+	test_reversed();
+	test_pulses();
+	test_spi();
+	test_change_detection(controller, backward);
+
+	TEST_RESULT();
+}
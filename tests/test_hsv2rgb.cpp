@@ -0,0 +1,77 @@
+// Checks that the array forms of hsv2rgb_rainbow(), hsv2rgb_spectrum() and hsv2rgb_raw(), which
+// convert a block of pixels at a time, give exactly what the single pixel forms give, for every
+// one of the 16M hue, saturation and value inputs and for every array length up to 300.
+
+#include "test.h"
+#include <string.h>
+
+#define MAX_LEDS 300
+
+// extra leds after the ones converted, to check that nothing past the end is written
+#define GUARD 8
+
+typedef void (*ArrayConversion)(const struct CHSV*, struct CRGB*, int);
+typedef void (*PixelConversion)(const struct CHSV&, struct CRGB&);
+
+static CHSV hsv[65536];
+static CRGB got[65536];
+
+static void check_every_input(const char *name, ArrayConversion convert, PixelConversion convert1) {
+	// all the saturations and values of one hue at a time
+	for(int h = 0; h < 256 && !TEST_GIVE_UP(); ++h) {
+		for(int sv = 0; sv < 65536; ++sv) {
+			hsv[sv] = CHSV(h, sv >> 8, sv & 0xFF);
+		}
+		convert(hsv, got, 65536);
+		for(int sv = 0; sv < 65536 && !TEST_GIVE_UP(); ++sv) {
+			CRGB want;
+			convert1(hsv[sv], want);
+			if(got[sv] != want) {
+				printf("%s(%d, %d, %d): got (%d, %d, %d), want (%d, %d, %d)\n", name, h, sv >> 8, sv & 0xFF,
+					got[sv].r, got[sv].g, got[sv].b, want.r, want.g, want.b);
+				++test_failures;
+			}
+		}
+	}
+}
+
+static void check_lengths(const char *name, ArrayConversion convert, PixelConversion convert1) {
+	uint32_t seed = 5;
+	for(int i = 0; i < MAX_LEDS; ++i) {
+		uint32_t r = test_random(seed);
+		hsv[i] = CHSV(r, r >> 8, r >> 16);
+	}
+
+	for(int n = 0; n <= MAX_LEDS && !TEST_GIVE_UP(); ++n) {
+		memset((void*)got, 0x5A, (MAX_LEDS + GUARD) * sizeof(CRGB));
+		convert(hsv, got, n);
+		for(int i = 0; i < n; ++i) {
+			CRGB want;
+			convert1(hsv[i], want);
+			if(got[i] != want) {
+				printf("%s, %d leds: led %d differs\n", name, n, i);
+				++test_failures;
+				break;
+			}
+		}
+		for(int i = n; i < MAX_LEDS + GUARD; ++i) {
+			if(got[i] != CRGB(0x5A, 0x5A, 0x5A)) {
+				printf("%s, %d leds: led %d, past the end, was written\n", name, n, i);
+				++test_failures;
+				break;
+			}
+		}
+	}
+}
+
+int main() {
+	check_every_input("hsv2rgb_rainbow", hsv2rgb_rainbow, hsv2rgb_rainbow);
+	check_every_input("hsv2rgb_spectrum", hsv2rgb_spectrum, hsv2rgb_spectrum);
+	check_every_input("hsv2rgb_raw", hsv2rgb_raw, hsv2rgb_raw);
+
+	check_lengths("hsv2rgb_rainbow", hsv2rgb_rainbow, hsv2rgb_rainbow);
+	check_lengths("hsv2rgb_spectrum", hsv2rgb_spectrum, hsv2rgb_spectrum);
+	check_lengths("hsv2rgb_raw", hsv2rgb_raw, hsv2rgb_raw);
+
+	TEST_RESULT();
+}
@@ -0,0 +1,82 @@
+// Checks of the ESP32 I2S parallel encoding (src/platforms/esp/32/clockless_i2s_encode.h), which
+// doesn't depend on the ESP-IDF, so that it can run on the host: every pulse of every bit, for
+// random pixels, lane masks and pulse timings.
+
+#include "test.h"
+#include "platforms/esp/32/clockless_i2s_encode.h"
+#include <string.h>
+
+#define MAX_CHANNELS 4
+#define MAX_PULSES_PER_BIT 12
+#define NUM_CASES 20000
+
+// the pulse `pulse` of bit `bit` (0 is the MSB) of channel `channel`, worked out a lane at a time
+static uint32_t expected_pulse(const uint8_t lanes[][I2S_NUM_LANES], uint32_t mask, int channel, int bit,
+                               int pulse, int onesForZero, int onesForOne) {
+	if(pulse < onesForZero) { return 0xFFFFFFFF; }
+	if(pulse >= onesForOne) { return 0; }
+	uint32_t word = 0;
+	for(int lane = 0; lane < I2S_NUM_LANES; ++lane) {
+		if(lanes[channel][lane] & (0x80 >> bit)) { word |= 1UL << (lane + 8); }
+	}
+	return word & mask;
+}
+
+int main() {
+	uint32_t seed = 9;
+	const int maxPulses = MAX_CHANNELS * 8 * MAX_PULSES_PER_BIT;
+
+	for(int c = 0; c < NUM_CASES && !TEST_GIVE_UP(); ++c) {
+		uint8_t lanes[MAX_CHANNELS][I2S_NUM_LANES];
+		for(int ch = 0; ch < MAX_CHANNELS; ++ch) {
+			for(int lane = 0; lane < I2S_NUM_LANES; ++lane) { lanes[ch][lane] = test_random(seed); }
+		}
+		// every lane, or some of them (the low 8 bits of a word are never used for data)
+		uint32_t mask = (c & 1) ? 0xFFFFFF00 : ((test_random(seed) << 8) & 0xFFFFFF00);
+		int nChannels = 3 + (c & 2) / 2;
+		int pulsesPerBit = 3 + test_random(seed) % (MAX_PULSES_PER_BIT - 2);
+		int onesForZero = 1 + test_random(seed) % (pulsesPerBit - 2);
+		int onesForOne = onesForZero + 1 + test_random(seed) % (pulsesPerBit - onesForZero - 1);
+
+		// a marker in every pulse, to see which ones were written
+		uint32_t buf[maxPulses + 1];
+		memset(buf, 0xA5, sizeof(buf));
+		const int nBits = nChannels * 8;
+		i2s_init_pulses(buf, nBits, pulsesPerBit, onesForZero, onesForOne);
+		i2s_encode_pixel(lanes, nChannels, mask, buf, pulsesPerBit, onesForZero, onesForOne);
+
+		for(int ch = 0; ch < nChannels; ++ch) {
+			for(int bit = 0; bit < 8; ++bit) {
+				for(int pulse = 0; pulse < pulsesPerBit; ++pulse) {
+					uint32_t got = buf[(ch * 8 + bit) * pulsesPerBit + pulse];
+					uint32_t want = expected_pulse(lanes, mask, ch, bit, pulse, onesForZero, onesForOne);
+					if(got != want) {
+						printf("case %d, channel %d bit %d pulse %d: got %08x, want %08x\n", c, ch, bit, pulse, got, want);
+						++test_failures;
+					}
+				}
+			}
+		}
+		// and nothing after the pixel's pulses
+		CHECK_EQ(buf[nBits * pulsesPerBit], 0xA5A5A5A5);
+	}
+
+	// a volatile buffer, as the DMA buffers are, encodes the same
+	uint8_t lanes[3][I2S_NUM_LANES];
+	for(int lane = 0; lane < I2S_NUM_LANES; ++lane) {
+		lanes[0][lane] = lane;
+		lanes[1][lane] = 255 - lane * 3;
+		lanes[2][lane] = 1 << (lane % 8);
+	}
+	uint32_t plain[24 * 10];
+	volatile uint32_t dma[24 * 10];
+	i2s_init_pulses(plain, 24, 10, 3, 7);
+	i2s_init_pulses(dma, 24, 10, 3, 7);
+	i2s_encode_pixel(lanes, 3, 0xFFFFFF00, plain, 10, 3, 7);
+	i2s_encode_pixel(lanes, 3, 0xFFFFFF00, dma, 10, 3, 7);
+	for(int i = 0; i < 24 * 10; ++i) {
+		CHECK_EQ(dma[i], plain[i]);
+	}
+
+	TEST_RESULT();
+}
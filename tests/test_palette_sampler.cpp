@@ -0,0 +1,160 @@
+// Checks of CPaletteSampler against ColorFromPalette(): every index, for each blend type and
+// a range of brightnesses, on 16, 32 and 256 entry palettes, the fills that take a sampler
+// against the ones that take the palette, and that the table is rebuilt when the palette, the
+// blend type or the brightness change (and only then is anything different returned).
+
+#include "test.h"
+#include <string.h>
+
+#define NUM_LEDS 300
+
+static const TBlendType blends[] = { NOBLEND, LINEARBLEND, LINEARBLEND_NOWRAP };
+static const uint8_t brightnesses[] = { 255, 0, 1, 64, 128, 254, 255, 77 };
+
+CRGB leds[NUM_LEDS];
+CRGB want[NUM_LEDS];
+uint8_t data[NUM_LEDS];
+
+template<typename PALETTE>
+static void fill_random(PALETTE & pal, uint32_t & seed) {
+	const int n = sizeof(pal.entries) / sizeof(pal.entries[0]);
+	for(int i = 0; i < n; ++i) {
+		pal.entries[i] = CRGB(test_random(seed), test_random(seed), test_random(seed));
+	}
+}
+
+// a cross-fade, the way nblendPaletteTowardPalette() does it for the palettes it takes
+static void fade_toward(CRGBPalette16 & pal, CRGBPalette16 & target) { nblendPaletteTowardPalette(pal, target, 24); }
+template<typename PALETTE>
+static void fade_toward(PALETTE & pal, PALETTE & target) {
+	const int n = sizeof(pal.entries) / sizeof(pal.entries[0]);
+	for(int i = 0; i < n; ++i) { nblend(pal.entries[i], target.entries[i], 64); }
+}
+
+static bool same(const CRGB & a, const CRGB & b) { return a == b; }
+
+// every color the sampler gives, from its table and one at a time
+template<typename PALETTE>
+static void check_table(CPaletteSampler<PALETTE> & sampler, const PALETTE & pal, uint8_t brightness,
+                        TBlendType blend, const char *name) {
+	CHECK_EQ(sampler.getBlendType(), blend);
+	const CRGB *table = sampler.getTable(brightness);
+	for(int i = 0; i < 256; ++i) {
+		CRGB c = ColorFromPalette(pal, (uint8_t)i, brightness, blend);
+		CHECK(same(table[i], c));
+		CHECK(same(sampler.sample((uint8_t)i, brightness), c));
+		if(test_failures) {
+			printf("%s, blend %d, brightness %d, index %d differs\n", name, blend, brightness, i);
+			return;
+		}
+	}
+}
+
+// the fills that take a sampler against the ones that take the palette
+template<typename PALETTE>
+static void check_fills(CPaletteSampler<PALETTE> & sampler, const PALETTE & pal, uint8_t brightness,
+                        TBlendType blend, uint32_t & seed) {
+	static const uint8_t incs[] = { 0, 1, 3, 17, 255 };
+	static const uint16_t counts[] = { 0, 1, 7, 256, NUM_LEDS };
+	for(size_t n = 0; n < sizeof(counts) / sizeof(counts[0]); ++n) {
+		uint16_t count = counts[n];
+		uint8_t start = test_random(seed);
+		for(size_t k = 0; k < sizeof(incs) / sizeof(incs[0]); ++k) {
+			fill_palette(want, count, start, incs[k], pal, brightness, blend);
+			fill_palette(leds, count, start, incs[k], sampler, brightness);
+			CHECK(memcmp(leds, want, count * sizeof(CRGB)) == 0);
+		}
+		for(int reversed = 0; reversed < 2; ++reversed) {
+			fill_palette_circular(want, count, start, pal, brightness, blend, reversed);
+			fill_palette_circular(leds, count, start, sampler, brightness, reversed);
+			CHECK(memcmp(leds, want, count * sizeof(CRGB)) == 0);
+		}
+
+		static const uint8_t opacities[] = { 255, 0, 1, 128 };
+		for(size_t o = 0; o < sizeof(opacities) / sizeof(opacities[0]); ++o) {
+			for(int i = 0; i < count; ++i) {
+				data[i] = test_random(seed);
+				leds[i] = want[i] = CRGB(test_random(seed), test_random(seed), test_random(seed));
+			}
+			map_data_into_colors_through_palette(data, count, want, pal, brightness, opacities[o], blend);
+			map_data_into_colors_through_palette(data, count, leds, sampler, brightness, opacities[o]);
+			CHECK(memcmp(leds, want, count * sizeof(CRGB)) == 0);
+		}
+	}
+}
+
+template<typename PALETTE>
+static void test_palette(const char *name, uint32_t & seed) {
+	PALETTE pal;
+	fill_random(pal, seed);
+	CPaletteSampler<PALETTE> sampler(pal);
+	CHECK_EQ(sampler.getBlendType(), LINEARBLEND);
+
+	for(size_t b = 0; b < sizeof(blends) / sizeof(blends[0]) && !TEST_GIVE_UP(); ++b) {
+		// switching the blend type must not hand back the old blend's table
+		sampler.setBlendType(blends[b]);
+		for(size_t v = 0; v < sizeof(brightnesses) / sizeof(brightnesses[0]); ++v) {
+			check_table(sampler, pal, brightnesses[v], blends[b], name);
+			check_fills(sampler, pal, brightnesses[v], blends[b], seed);
+		}
+	}
+
+	// a change to a single entry, then a cross-fade, then a whole new palette
+	sampler.setBlendType(LINEARBLEND);
+	check_table(sampler, pal, 255, LINEARBLEND, name);
+	pal.entries[1].g ^= 0x01;
+	check_table(sampler, pal, 255, LINEARBLEND, name);
+	PALETTE target;
+	fill_random(target, seed);
+	for(int f = 0; f < 4 && !TEST_GIVE_UP(); ++f) {
+		fade_toward(pal, target);
+		check_table(sampler, pal, 200, LINEARBLEND, name);
+	}
+	pal = target;
+	check_table(sampler, pal, 200, LINEARBLEND, name);
+}
+
+// a table that's been built is only rebuilt when something it was built from changes: an
+// entry written into the table by hand shows whether it was kept
+static void test_rebuilds(uint32_t & seed) {
+	CRGBPalette16 pal;
+	fill_random(pal, seed);
+	CPaletteSampler<CRGBPalette16> sampler(pal, NOBLEND);
+	CRGB *table = const_cast<CRGB *>(sampler.getTable(128));
+	const CRGB marker(1, 2, 3);
+
+	// nothing changed, so the table is kept
+	table[5] = marker;
+	CHECK(same(sampler.sample(5, 128), marker));
+	sampler.setBlendType(NOBLEND);
+	CHECK(same(sampler.sample(5, 128), marker));
+
+	// a forced rebuild
+	sampler.invalidate();
+	CHECK(same(sampler.sample(5, 128), ColorFromPalette(pal, 5, 128, NOBLEND)));
+
+	// a new blend type
+	table[5] = marker;
+	sampler.setBlendType(LINEARBLEND);
+	CHECK(same(sampler.sample(5, 128), ColorFromPalette(pal, 5, 128, LINEARBLEND)));
+
+	// a new brightness, and back again
+	table[5] = marker;
+	CHECK(same(sampler.sample(5, 129), ColorFromPalette(pal, 5, 129, LINEARBLEND)));
+	table[5] = marker;
+	CHECK(same(sampler.sample(5, 128), ColorFromPalette(pal, 5, 128, LINEARBLEND)));
+
+	// a palette entry that the index doesn't even use
+	table[5] = marker;
+	pal.entries[15].b ^= 0x80;
+	CHECK(same(sampler.sample(5, 128), ColorFromPalette(pal, 5, 128, LINEARBLEND)));
+}
+
+int main() {
+	uint32_t seed = 13;
+	test_palette<CRGBPalette16>("CRGBPalette16", seed);
+	test_palette<CRGBPalette32>("CRGBPalette32", seed);
+	test_palette<CRGBPalette256>("CRGBPalette256", seed);
+	test_rebuilds(seed);
+	TEST_RESULT();
+}
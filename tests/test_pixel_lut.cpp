@@ -0,0 +1,98 @@
+// Checks of PixelController's dithering and scaling, for every byte value, in both phases of the
+// binary dithering, against qadd8() and scale8(): each load function, lanes, copies, and the
+// first byte dithered out of step.  It's built with and without FASTLED_PIXEL_LUT, so that the
+// lookup tables have to give the same bytes as the plain path.
+
+#include "test.h"
+
+#define NUM_LEDS 256
+#define LANES 2
+
+CRGB leds[NUM_LEDS * LANES];
+
+// dither, then scale, the way loadAndScale() does without the tables
+static uint8_t reference(uint8_t b, uint8_t d, uint8_t scale) {
+	return scale8(b ? qadd8(b, d) : 0, scale);
+}
+
+// the dithering of each channel, in memory order, for the phase each one is in
+struct Dither {
+	uint8_t d[3];
+	uint8_t e[3];
+	void step(int c) { d[c] = e[c] - d[c]; }
+};
+
+template<EOrder RGB_ORDER>
+static void check_pixels(CRGB scale, EDitherMode mode, const char *name) {
+	PixelController<RGB_ORDER, LANES> pixels(leds, NUM_LEDS, scale, mode);
+	Dither dither;
+	for(int c = 0; c < 3; ++c) {
+		dither.d[c] = pixels.d[c];
+		dither.e[c] = pixels.e[c];
+	}
+	const int o[3] = { RGB_BYTE(RGB_ORDER, 0), RGB_BYTE(RGB_ORDER, 1), RGB_BYTE(RGB_ORDER, 2) };
+
+	// some drivers dither the first byte of each pixel ahead of the others
+	bool preStep = (scale.r & 1) != 0;
+	if(preStep) {
+		pixels.preStepFirstByteDithering();
+		dither.step(o[0]);
+	}
+
+	for(int i = 0; i < NUM_LEDS && !TEST_GIVE_UP(); ++i) {
+		// a copy has to carry the tables, and the phase, along
+		PixelController<RGB_ORDER, LANES> copy(pixels);
+		for(int lane = 0; lane < LANES; ++lane) {
+			const CRGB & led = leds[lane * NUM_LEDS + i];
+			uint8_t want[3];
+			for(int slot = 0; slot < 3; ++slot) {
+				want[slot] = reference(led.raw[o[slot]], dither.d[o[slot]], scale.raw[o[slot]]);
+			}
+			if(lane == 0) {
+				CHECK_EQ(pixels.loadAndScale0(), want[0]);
+				CHECK_EQ(pixels.loadAndScale1(), want[1]);
+				CHECK_EQ(pixels.loadAndScale2(), want[2]);
+			}
+			CHECK_EQ(pixels.loadAndScale0(lane), want[0]);
+			CHECK_EQ(pixels.loadAndScale1(lane), want[1]);
+			CHECK_EQ(copy.loadAndScale2(lane), want[2]);
+
+			// the forms that take their scale from the caller don't dither
+			CHECK_EQ(pixels.loadAndScale1(lane, 77), scale8(led.raw[o[1]], 77));
+			CHECK_EQ((PixelController<RGB_ORDER, LANES>::template loadAndScale<2>(pixels, lane, 9, 200)),
+			         reference(led.raw[o[2]], 9, 200));
+		}
+		if(test_failures) {
+			printf("%s, scale %d/%d/%d, led %d differs\n", name, scale.r, scale.g, scale.b, i);
+			return;
+		}
+
+		// advance the way the clockless drivers do, by a byte each pixel
+		pixels.advanceData();
+		pixels.stepDithering();
+		for(int c = 0; c < 3; ++c) { dither.step(c); }
+	}
+}
+
+int main() {
+	// every byte value on every channel of every lane, in a different order for each
+	for(int i = 0; i < NUM_LEDS; ++i) {
+		leds[i] = CRGB(i, 255 - i, (i * 37) & 0xFF);
+		leds[NUM_LEDS + i] = CRGB((i * 101) & 0xFF, i ^ 0x5A, i);
+	}
+
+	static const uint8_t scales[] = { 0, 1, 2, 3, 16, 64, 100, 127, 128, 129, 200, 254, 255 };
+	const int n = sizeof(scales) / sizeof(scales[0]);
+	for(int s = 0; s < n * n && !TEST_GIVE_UP(); ++s) {
+		CRGB scale(scales[s % n], scales[s / n], scales[(s + s / n) % n]);
+		check_pixels<RGB>(scale, BINARY_DITHER, "RGB, dithered");
+		check_pixels<GRB>(scale, BINARY_DITHER, "GRB, dithered");
+		check_pixels<BGR>(scale, DISABLE_DITHER, "BGR, no dithering");
+		// the dithering counter moves on with every PixelController, so go through its phases
+		for(int f = 0; f < 8; ++f) {
+			check_pixels<BRG>(scale, BINARY_DITHER, "BRG, dithered");
+		}
+	}
+
+	TEST_RESULT();
+}
@@ -0,0 +1,117 @@
+// Checks of the nRF52 PWM sequence encoding (src/platforms/arm/nrf52/clockless_pwm_encode.h),
+// which doesn't depend on the nRF SDK, so that it can run on the host: the sequence values for a
+// strip, whether it's encoded in one buffer or streamed through small ones that are refilled.
+// Built with FASTLED_CRGB16 set, it checks 16 bit leds quantized by the encoder too.
+
+#include "test.h"
+#include "platforms/arm/nrf52/clockless_pwm_encode.h"
+#include <string.h>
+
+#define MAX_LEDS 300
+#define CHUNK_PIXELS 16
+
+// the compare values for a "0" and a "1" bit, with the polarity bit set
+static const uint16_t ZERO = 0x8000 | 6;
+static const uint16_t ONE = 0x8000 | 13;
+
+CRGB leds[MAX_LEDS];
+CRGB16 leds16[MAX_LEDS];
+uint8_t err[MAX_LEDS * 3];
+uint8_t err_start[MAX_LEDS * 3];
+
+static uint16_t want[MAX_LEDS * 3 * 12];
+static uint16_t got[MAX_LEDS * 3 * 12 + 1];
+
+// the sequence values worked out a bit at a time, from a copy of the pixels
+template<typename PIXELS>
+static int reference(PIXELS pixels, int xtra0) {
+	int n = 0;
+	while(pixels.has(1)) {
+		uint8_t b[3] = { pixels.loadAndScale0(), pixels.loadAndScale1(), pixels.loadAndScale2() };
+		for(int c = 0; c < 3; ++c) {
+			for(int bit = 7; bit >= 0; --bit) { want[n++] = (b[c] & (1 << bit)) ? ONE : ZERO; }
+			for(int x = 0; x < xtra0; ++x) { want[n++] = ZERO; }
+		}
+		pixels.advanceData();
+		pixels.stepDithering();
+	}
+	return n;
+}
+
+// the whole strip into one buffer, and a few pixels at a time into a buffer that's refilled, as
+// the driver streams long strips
+template<typename PIXELS>
+static void check_encode(const PIXELS & base, int nLeds, int xtra0, const char *name, bool hdr) {
+	if(hdr) { memcpy(err, err_start, sizeof(err)); }
+	const int n = reference(base, xtra0);
+	CHECK_EQ(n, nLeds * 3 * (8 + xtra0));
+
+	if(hdr) { memcpy(err, err_start, sizeof(err)); }
+	PIXELS whole(base);
+	for(size_t i = 0; i < sizeof(got) / sizeof(got[0]); ++i) { got[i] = 0xA5A5; }
+	uint16_t count = nrf52_pwm_encode_pixels(whole, got, MAX_LEDS, xtra0, ZERO, ONE);
+	CHECK_EQ(count, n);
+	CHECK(!whole.has(1));
+	CHECK_EQ(got[count], 0xA5A5);
+	if(memcmp(got, want, n * sizeof(uint16_t)) != 0) {
+		printf("%s, %d leds, %d extra bits: one buffer differs\n", name, nLeds, xtra0);
+		++test_failures;
+	}
+
+	if(hdr) { memcpy(err, err_start, sizeof(err)); }
+	PIXELS streamed(base);
+	int sent = 0;
+	int sequences = 0;
+	while(streamed.has(1) && sent < n) {
+		uint16_t chunk[CHUNK_PIXELS * 3 * 12 + 1];
+		chunk[CHUNK_PIXELS * 3 * (8 + xtra0)] = 0xA5A5;
+		uint16_t c = nrf52_pwm_encode_pixels(streamed, chunk, CHUNK_PIXELS, xtra0, ZERO, ONE);
+		CHECK(c > 0 && c <= CHUNK_PIXELS * 3 * (8 + xtra0));
+		CHECK_EQ(chunk[CHUNK_PIXELS * 3 * (8 + xtra0)], 0xA5A5);
+		if(c == 0 || sent + c > n) { break; }
+		if(memcmp(chunk, want + sent, c * sizeof(uint16_t)) != 0) {
+			printf("%s, %d leds, %d extra bits: sequence %d differs\n", name, nLeds, xtra0, sequences);
+			++test_failures;
+		}
+		sent += c;
+		++sequences;
+	}
+	CHECK_EQ(sent, n);
+	CHECK_EQ(sequences, (nLeds + CHUNK_PIXELS - 1) / CHUNK_PIXELS);
+}
+
+int main() {
+	uint32_t seed = 17;
+	for(int i = 0; i < MAX_LEDS; ++i) {
+		leds[i] = CRGB(test_random(seed), test_random(seed), test_random(seed));
+		leds16[i] = CRGB16(test_random(seed), test_random(seed), test_random(seed));
+	}
+	for(int i = 0; i < MAX_LEDS * 3; ++i) { err_start[i] = test_random(seed); }
+
+	// each bit of a byte is one value, MSB first
+	for(int b = 0; b < 256; ++b) {
+		uint16_t e[8];
+		CHECK(nrf52_pwm_encode_byte(b, e, ZERO, ONE) == e + 8);
+		for(int bit = 0; bit < 8; ++bit) {
+			CHECK_EQ(e[bit], (b & (0x80 >> bit)) ? ONE : ZERO);
+		}
+	}
+
+	CRGB scale(200, 180, 255);
+	static const int lengths[] = { 1, 15, 16, 17, 33, 144, MAX_LEDS };
+	for(size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]) && !TEST_GIVE_UP(); ++l) {
+		int n = lengths[l];
+		// the dithering steps with each pixel, so the copies all start from the same base
+		PixelController<GRB> dithered(leds, n, scale, BINARY_DITHER);
+		check_encode(dithered, n, 0, "dithered", false);
+		PixelController<GRB> plain(leds, n, scale, DISABLE_DITHER);
+		check_encode(plain, n, 0, "no dithering", false);
+		check_encode(plain, n, 4, "no dithering", false);
+#if FASTLED_CRGB16
+		PixelController<GRB> hdr(leds16, err, n, scale);
+		check_encode(hdr, n, 0, "CRGB16", true);
+#endif
+	}
+
+	TEST_RESULT();
+}
@@ -0,0 +1,206 @@
+// Checks of the quantizing of 16 bit leds to 8 bits with temporal error diffusion
+// (PixelController::quantize(), and CLEDController::setLeds(CRGB16*, int)): the output and the
+// residuals against a plain reference over many frames, the residual that each lane and each
+// led of a reversed strip lands on, what show() sends, and that 8 bit leds are unaffected.
+// It's built with and without FASTLED_CRGB16, which moves the quantizing into the drivers.
+
+#include "test.h"
+#include <string.h>
+
+#define NUM_LEDS 37
+#define LANES 3
+#define FRAMES 300
+#define GUARD 8
+
+CRGB16 leds16[NUM_LEDS * LANES];
+uint8_t err[NUM_LEDS * LANES * 3 + GUARD];
+uint8_t err_want[NUM_LEDS * LANES * 3];
+
+CRGB16 strip[NUM_LEDS];
+CRGB16 reversed[NUM_LEDS];
+CRGB16 spi[NUM_LEDS];
+CRGB leds[NUM_LEDS];
+
+// quantize a channel the slow way, carrying the error in err
+static uint8_t ref_quantize(uint16_t v, uint8_t scale, uint8_t & err) {
+	uint32_t t = (uint32_t)scale16by8(v, scale) + err;
+	if(t > 0xFFFF) {
+		err = 0;
+		return 0xFF;
+	}
+	err = t & 0xFF;
+	return t >> 8;
+}
+
+static void fill_random(CRGB16 *data, int n, uint32_t & seed) {
+	for(int i = 0; i < n; ++i) {
+		data[i] = CRGB16(test_random(seed), test_random(seed), test_random(seed));
+	}
+}
+
+// a whole channel held at one level averages out to it, with what's left in the residual
+static void test_diffusion() {
+	static const uint16_t levels[] = { 0, 1, 0x80, 0xFF, 0x100, 0x1234, 0x7FFF, 0xABCD, 0xFF00, 0xFFFE, 0xFFFF };
+	static const uint8_t scales[] = { 255, 200, 128, 1 };
+	for(size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l) {
+		for(size_t s = 0; s < sizeof(scales) / sizeof(scales[0]); ++s) {
+			CRGB scale(scales[s], scales[s], scales[s]);
+			CRGB16 led(levels[l], levels[l], levels[l]);
+			uint8_t e[3] = { 0x40, 0x80, 0xC0 };
+			uint32_t sum[3] = { 0, 0, 0 };
+			for(int f = 0; f < FRAMES; ++f) {
+				PixelController<RGB> pixels(&led, e, 1, scale);
+				sum[0] += pixels.quantize<0>(pixels, 0, scales[s]);
+				sum[1] += pixels.quantize<1>(pixels, 0, scales[s]);
+				sum[2] += pixels.quantize<2>(pixels, 0, scales[s]);
+			}
+			uint16_t v = scale16by8(levels[l], scales[s]);
+			for(int c = 0; c < 3; ++c) {
+				if(v > 0xFF00) {
+					// too close to full on to carry anything
+					CHECK_EQ(sum[c], FRAMES * 0xFF);
+				} else {
+					CHECK_EQ(sum[c] * 256 + e[c], (uint32_t)v * FRAMES + 0x40 * (c + 1));
+				}
+			}
+		}
+	}
+}
+
+// every lane of a parallel controller, frame after frame, each byte landing on its own residual
+static void test_lanes(uint32_t & seed) {
+	fill_random(leds16, NUM_LEDS * LANES, seed);
+	for(int i = 0; i < NUM_LEDS * LANES * 3; ++i) { err[i] = err_want[i] = test_random(seed); }
+	memset(err + NUM_LEDS * LANES * 3, 0xA5, GUARD);
+	CRGB scale(255, 170, 90);
+	for(int f = 0; f < 20 && !TEST_GIVE_UP(); ++f) {
+		PixelController<GRB, LANES> pixels(leds16, err, NUM_LEDS, scale);
+		for(int i = 0; i < NUM_LEDS; ++i) {
+			for(int lane = 0; lane < LANES; ++lane) {
+				uint8_t got[3] = {
+					pixels.quantize<0>(pixels, pixels.mOffsets[lane], scale.raw[RGB_BYTE(GRB, 0)]),
+					pixels.quantize<1>(pixels, pixels.mOffsets[lane], scale.raw[RGB_BYTE(GRB, 1)]),
+					pixels.quantize<2>(pixels, pixels.mOffsets[lane], scale.raw[RGB_BYTE(GRB, 2)]),
+				};
+				for(int slot = 0; slot < 3; ++slot) {
+					int c = RGB_BYTE(GRB, slot);
+					int led = lane * NUM_LEDS + i;
+					CHECK_EQ(got[slot], ref_quantize(leds16[led].raw[c], scale.raw[c], err_want[led * 3 + c]));
+				}
+			}
+			pixels.advanceData();
+		}
+		CHECK(memcmp(err, err_want, NUM_LEDS * LANES * 3) == 0);
+		for(int g = 0; g < GUARD; ++g) { CHECK_EQ(err[NUM_LEDS * LANES * 3 + g], 0xA5); }
+		// nothing is loaded past the end
+		CHECK_EQ(pixels.quantize<0>(pixels, 0, 255), 0);
+	}
+}
+
+// a reversed strip starts at its last led in memory, and so do its residuals
+static void test_reversed_pixels(uint32_t & seed) {
+	fill_random(leds16, NUM_LEDS, seed);
+	for(int i = 0; i < NUM_LEDS * 3; ++i) { err[i] = err_want[i] = test_random(seed); }
+	memset(err + NUM_LEDS * 3, 0xA5, GUARD);
+	CRGB scale(128, 255, 7);
+	for(int f = 0; f < 20 && !TEST_GIVE_UP(); ++f) {
+		PixelController<RGB> pixels(leds16 + NUM_LEDS - 1, err + (NUM_LEDS - 1) * 3, NUM_LEDS, scale);
+		pixels.mAdvance = -pixels.mAdvance;
+		for(int i = NUM_LEDS - 1; i >= 0; --i) {
+			CHECK_EQ(pixels.quantize<0>(pixels, 0, scale.r), ref_quantize(leds16[i].r, scale.r, err_want[i * 3 + 0]));
+			CHECK_EQ(pixels.quantize<1>(pixels, 0, scale.g), ref_quantize(leds16[i].g, scale.g, err_want[i * 3 + 1]));
+			CHECK_EQ(pixels.quantize<2>(pixels, 0, scale.b), ref_quantize(leds16[i].b, scale.b, err_want[i * 3 + 2]));
+			pixels.advanceData();
+		}
+		CHECK(memcmp(err, err_want, NUM_LEDS * 3) == 0);
+		for(int g = 0; g < GUARD; ++g) { CHECK_EQ(err[NUM_LEDS * 3 + g], 0xA5); }
+	}
+}
+
+// 8 bit leds are still dithered and scaled, however 16 bit ones are quantized
+static void test_8bit_pixels(uint32_t & seed) {
+	for(int i = 0; i < NUM_LEDS; ++i) { leds[i] = CRGB(test_random(seed), test_random(seed), test_random(seed)); }
+	leds[3] = CRGB::Black;
+	CRGB scale(255, 100, 31);
+	PixelController<GRB> pixels(leds, NUM_LEDS, scale, BINARY_DITHER);
+	CHECK(pixels.mErr == NULL);
+	for(int i = 0; i < NUM_LEDS; ++i) {
+		uint8_t b[3] = { leds[i].g, leds[i].r, leds[i].b };
+		uint8_t want[3];
+		for(int slot = 0; slot < 3; ++slot) {
+			uint8_t d = pixels.d[RGB_BYTE(GRB, slot)];
+			want[slot] = scale8(b[slot] ? qadd8(b[slot], d) : 0, scale.raw[RGB_BYTE(GRB, slot)]);
+		}
+		CHECK_EQ(pixels.loadAndScale0(), want[0]);
+		CHECK_EQ(pixels.loadAndScale1(), want[1]);
+		CHECK_EQ(pixels.loadAndScale2(), want[2]);
+		pixels.advanceData();
+		pixels.stepDithering();
+	}
+}
+
+// what show() sends for a strip, a reversed strip and an SPI strip of 16 bit leds
+static void test_show(uint32_t & seed) {
+	CLEDController & forward = FastLED.addLeds<WS2812B, 2, GRB>(strip, NUM_LEDS);
+	CLEDController & backward = FastLED.addLeds<WS2812B, 3, GRB>(reversed + NUM_LEDS - 1, -NUM_LEDS);
+	FastLED.addLeds<APA102, 4, 5, BGR>(spi, NUM_LEDS);
+	forward.setCorrection(CRGB(255, 176, 240));
+	FastLED.setMaxRefreshRate(0);
+	uint8_t want_strip[NUM_LEDS * 3] = { 0 };
+	uint8_t want_reversed[NUM_LEDS * 3] = { 0 };
+	uint8_t want_spi[NUM_LEDS * 3] = { 0 };
+	fill_random(strip, NUM_LEDS, seed);
+	fill_random(reversed, NUM_LEDS, seed);
+	fill_random(spi, NUM_LEDS, seed);
+
+	for(int f = 0; f < 50 && !TEST_GIVE_UP(); ++f) {
+		uint8_t brightness = 40 + f * 4;
+		if(f == 25) {
+			// the residuals carry on across a change of the leds
+			fill_random(strip, NUM_LEDS, seed);
+			fill_random(reversed, NUM_LEDS, seed);
+			fill_random(spi, NUM_LEDS, seed);
+		}
+		FastLED.show(brightness);
+
+		CRGB scale = forward.getAdjustment(brightness);
+		HostWire & wire = HostWire::get(2);
+		CHECK_EQ(wire.size(), NUM_LEDS * 3);
+		for(int i = 0; i < NUM_LEDS && wire.size() == NUM_LEDS * 3; ++i) {
+			CHECK_EQ(wire.bytes()[i * 3 + 0], ref_quantize(strip[i].g, scale.g, want_strip[i * 3 + 1]));
+			CHECK_EQ(wire.bytes()[i * 3 + 1], ref_quantize(strip[i].r, scale.r, want_strip[i * 3 + 0]));
+			CHECK_EQ(wire.bytes()[i * 3 + 2], ref_quantize(strip[i].b, scale.b, want_strip[i * 3 + 2]));
+		}
+
+		scale = backward.getAdjustment(brightness);
+		HostWire & back = HostWire::get(3);
+		CHECK_EQ(back.size(), NUM_LEDS * 3);
+		for(int i = 0; i < NUM_LEDS && back.size() == NUM_LEDS * 3; ++i) {
+			int led = NUM_LEDS - 1 - i;
+			CHECK_EQ(back.bytes()[i * 3 + 0], ref_quantize(reversed[led].g, scale.g, want_reversed[led * 3 + 1]));
+			CHECK_EQ(back.bytes()[i * 3 + 1], ref_quantize(reversed[led].r, scale.r, want_reversed[led * 3 + 0]));
+			CHECK_EQ(back.bytes()[i * 3 + 2], ref_quantize(reversed[led].b, scale.b, want_reversed[led * 3 + 2]));
+		}
+
+		// a 4 byte start frame, then 4 bytes per led, brightness first
+		scale = CRGB(brightness, brightness, brightness);
+		HostWire & spiWire = HostWire::get(4);
+		CHECK(spiWire.size() >= 4 + NUM_LEDS * 4);
+		for(int i = 0; i < NUM_LEDS && spiWire.size() >= 4 + NUM_LEDS * 4; ++i) {
+			const uint8_t *b = spiWire.bytes() + 4 + i * 4;
+			CHECK_EQ(b[1], ref_quantize(spi[i].b, scale.b, want_spi[i * 3 + 2]));
+			CHECK_EQ(b[2], ref_quantize(spi[i].g, scale.g, want_spi[i * 3 + 1]));
+			CHECK_EQ(b[3], ref_quantize(spi[i].r, scale.r, want_spi[i * 3 + 0]));
+		}
+	}
+}
+
+int main() {
+	uint32_t seed = 5;
+	test_diffusion();
+	test_lanes(seed);
+	test_reversed_pixels(seed);
+	test_8bit_pixels(seed);
+	test_show(seed);
+	TEST_RESULT();
+}
@@ -0,0 +1,107 @@
+// Checks of the ESP32 RMT encoding (src/platforms/esp/32/clockless_rmt_encode.h), which doesn't
+// depend on the ESP-IDF, so that it can run on the host: the nibble table that bytes are encoded
+// from, and the translator that the RMT driver calls as it refills its memory.
+
+#include "test.h"
+#include "platforms/esp/32/clockless_rmt_encode.h"
+
+#define NUM_BYTES 1000
+#define MAX_WANTED 512
+
+// the items that a zero and a one bit are sent as (the 32 bit value of an rmt_item32_t)
+static const uint32_t ZERO = 0x80208010;
+static const uint32_t ONE = 0x80108020;
+
+static uint8_t pixels[NUM_BYTES];
+
+// the item for bit `bit` (0 is the first sent, the MSB) of byte `i` of the pixel data
+static uint32_t expected_item(int i, int bit) {
+	return (pixels[i] & (0x80 >> bit)) ? ONE : ZERO;
+}
+
+// encoding from the nibble table gives the same items as a bit at a time, for every byte, into
+// plain and volatile (RMT memory) destinations
+static void test_nibble_table(uint32_t zero, uint32_t one) {
+	rmt_nibble_table_t table;
+	rmt_build_nibble_table(table, zero, one);
+	for(int b = 0; b < 256 && !TEST_GIVE_UP(); ++b) {
+		uint32_t want[RMT_ITEMS_PER_BYTE];
+		uint32_t got[RMT_ITEMS_PER_BYTE];
+		volatile uint32_t got_volatile[RMT_ITEMS_PER_BYTE];
+		rmt_encode_byte(b, want, zero, one);
+		rmt_encode_byte(b, got, table);
+		rmt_encode_byte(b, got_volatile, table);
+		for(int bit = 0; bit < 8; ++bit) {
+			CHECK_EQ(want[bit], (b & (0x80 >> bit)) ? one : zero);
+			CHECK_EQ(got[bit], want[bit]);
+			CHECK_EQ(got_volatile[bit], want[bit]);
+		}
+	}
+}
+
+// the driver calls the translator for each refill of the RMT memory, with the space left there,
+// until all the pixel data has been sent
+static void test_translator(const rmt_nibble_table_t table, int nBytes, size_t wanted) {
+	static uint32_t items[NUM_BYTES * RMT_ITEMS_PER_BYTE + MAX_WANTED + 1];
+	int sent = 0;
+	int calls = 0;
+	while(sent < nBytes && calls <= nBytes) {
+		size_t translated = 12345, num = 12345;
+		// a marker after the space for items, which must be left alone
+		items[sent * RMT_ITEMS_PER_BYTE + wanted] = 0xDEADBEEF;
+		rmt_encode_bytes(pixels + sent, nBytes - sent, items + sent * RMT_ITEMS_PER_BYTE, wanted, table, &translated, &num);
+		CHECK(num <= wanted);
+		CHECK_EQ(num, translated * RMT_ITEMS_PER_BYTE);
+		CHECK_EQ(items[sent * RMT_ITEMS_PER_BYTE + wanted], 0xDEADBEEF);
+		// whole bytes, as many as fit, or as many as are left
+		size_t fit = wanted / RMT_ITEMS_PER_BYTE;
+		CHECK_EQ(translated, fit < (size_t)(nBytes - sent) ? fit : (size_t)(nBytes - sent));
+		if(translated == 0 || TEST_GIVE_UP()) { break; }
+		sent += translated;
+		++calls;
+	}
+
+	if(wanted < RMT_ITEMS_PER_BYTE) {
+		// no room for a byte, so nothing is sent
+		CHECK_EQ(sent, 0);
+		return;
+	}
+	CHECK_EQ(sent, nBytes);
+	for(int i = 0; i < sent && !TEST_GIVE_UP(); ++i) {
+		for(int bit = 0; bit < 8; ++bit) {
+			CHECK_EQ(items[i * RMT_ITEMS_PER_BYTE + bit], expected_item(i, bit));
+		}
+	}
+}
+
+int main() {
+	uint32_t seed = 3;
+	for(int i = 0; i < NUM_BYTES; ++i) { pixels[i] = test_random(seed); }
+
+	test_nibble_table(ZERO, ONE);
+	test_nibble_table(0, 0xFFFFFFFF);
+	for(int i = 0; i < 100; ++i) {
+		uint32_t zero = test_random(seed) ^ (test_random(seed) << 24);
+		uint32_t one = test_random(seed) ^ (test_random(seed) << 24);
+		test_nibble_table(zero, one);
+	}
+
+	rmt_nibble_table_t table;
+	rmt_build_nibble_table(table, ZERO, ONE);
+
+	static const int sizes[] = { 0, 1, 3, 7, 8, 9, 64, 300, NUM_BYTES };
+	static const size_t wanted[] = { 0, 7, 8, 9, 32, 63, 64, 100, MAX_WANTED };
+	for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+		for(size_t w = 0; w < sizeof(wanted) / sizeof(wanted[0]); ++w) {
+			test_translator(table, sizes[s], wanted[w]);
+		}
+	}
+
+	// the driver may call it with no data left
+	size_t translated = 1, num = 1;
+	rmt_encode_bytes(NULL, 10, NULL, 64, table, &translated, &num);
+	CHECK_EQ(translated, 0);
+	CHECK_EQ(num, 0);
+
+	TEST_RESULT();
+}
@@ -0,0 +1,87 @@
+// Checks that the bulk scaling of led arrays (nscale8, nscale8_video and the fades built on
+// them) gives exactly what the CRGB member functions give led by led, for every scale and
+// every byte value, over a range of lengths and start alignments.
+
+#include "test.h"
+#include <string.h>
+
+#define MAX_LEDS 300
+#define MAX_OFFSET 8
+
+// extra leds before and after the ones scaled, to check that nothing outside of them changes
+#define GUARD 4
+
+CRGB source[MAX_LEDS];
+
+// every byte value, in a different order on each channel so each lands at every alignment
+static void fill_every_byte(CRGB *data, int n) {
+	for(int i = 0; i < n; ++i) {
+		data[i] = CRGB(i, (i * 7 + 3), (i * 31 + 200));
+	}
+}
+
+enum ScaleOp { OP_NSCALE8, OP_NSCALE8_VIDEO, OP_FADE_TO_BLACK, OP_FADE_RAW, OP_FADE_VIDEO, OP_FADE_LIGHT };
+static const char *op_names[] = { "nscale8", "nscale8_video", "fadeToBlackBy", "fade_raw", "fade_video", "fadeLightBy" };
+
+static void bulk(ScaleOp op, CRGB *leds, uint16_t n, uint8_t v) {
+	switch(op) {
+		case OP_NSCALE8: nscale8(leds, n, v); break;
+		case OP_NSCALE8_VIDEO: nscale8_video(leds, n, v); break;
+		case OP_FADE_TO_BLACK: fadeToBlackBy(leds, n, v); break;
+		case OP_FADE_RAW: fade_raw(leds, n, v); break;
+		case OP_FADE_VIDEO: fade_video(leds, n, v); break;
+		case OP_FADE_LIGHT: fadeLightBy(leds, n, v); break;
+	}
+}
+
+static void scalar(ScaleOp op, CRGB & led, uint8_t v) {
+	switch(op) {
+		case OP_NSCALE8: led.nscale8(v); break;
+		case OP_NSCALE8_VIDEO: led.nscale8_video(v); break;
+		case OP_FADE_TO_BLACK: led.fadeToBlackBy(v); break;
+		case OP_FADE_RAW: led.nscale8(255 - v); break;
+		case OP_FADE_VIDEO: led.nscale8_video(255 - v); break;
+		case OP_FADE_LIGHT: led.fadeLightBy(v); break;
+	}
+}
+
+static void check_op(ScaleOp op, int n, int offset) {
+	// a byte buffer, so that the leds can start at any address
+	static uint8_t buf[(MAX_LEDS + 2 * GUARD) * 3 + MAX_OFFSET];
+	static uint8_t expected[sizeof(buf)];
+	CRGB *leds = (CRGB*)(buf + offset) + GUARD;
+	CRGB *want = (CRGB*)(expected + offset) + GUARD;
+
+	for(int v = 0; v < 256 && !TEST_GIVE_UP(); ++v) {
+		memset(buf, 0x5A, sizeof(buf));
+		memcpy(leds, source, n * sizeof(CRGB));
+		memcpy(expected, buf, sizeof(buf));
+		for(int i = 0; i < n; ++i) {
+			scalar(op, want[i], v);
+		}
+
+		bulk(op, leds, n, v);
+
+		if(memcmp(buf, expected, sizeof(buf)) != 0) {
+			printf("%s, %d leds at offset %d, by %d: mismatch\n", op_names[op], n, offset, v);
+			for(size_t i = 0; i < sizeof(buf) && !TEST_GIVE_UP(); ++i) {
+				CHECK_EQ(buf[i], expected[i]);
+			}
+		}
+	}
+}
+
+int main() {
+	fill_every_byte(source, MAX_LEDS);
+
+	static const int lengths[] = { 0, 1, 2, 3, 5, 7, 8, 11, 16, 21, 85, 86, 256, MAX_LEDS };
+	for(int op = OP_NSCALE8; op <= OP_FADE_LIGHT; ++op) {
+		for(size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+			for(int offset = 0; offset < MAX_OFFSET; ++offset) {
+				check_op((ScaleOp)op, lengths[l], offset);
+			}
+		}
+	}
+
+	TEST_RESULT();
+}
@@ -0,0 +1,90 @@
+// Checks of transposeLanes() (bitswap.h), the bit transpose that the parallel output drivers
+// share, against transposing a bit at a time: for 8, 16, 24 and 32 lanes, both plane orders,
+// strided input and output, and several plane types.  Every input with a single bit set is
+// checked, which pins down where each bit goes, then random inputs.
+
+#include "test.h"
+#include <string.h>
+
+#define NUM_RANDOM 20000
+
+// bit `bit` of lane `lane`, with the lanes `m` bytes apart
+static inline int lane_bit(const uint8_t *A, int m, int lane, int bit) {
+	return (A[lane * m] >> bit) & 1;
+}
+
+template<int LANES, bool MSB, int m, int n, typename PLANE>
+static void check_transpose(const uint8_t *A, const char *name) {
+	// the planes, with a marker in the gaps between them, and after them
+	PLANE B[8 * n + 1];
+	memset(B, 0xA5, sizeof(B));
+	PLANE marker = B[0];
+	transposeLanes<LANES, MSB, m, n>(A, B);
+
+	for(int k = 0; k < 8; ++k) {
+		int bit = MSB ? 7 - k : k;
+		uint64_t want = 0;
+		for(int lane = 0; lane < LANES; ++lane) {
+			want |= (uint64_t)lane_bit(A, m, lane, bit) << lane;
+		}
+		if((uint64_t)B[k * n] != want) {
+			printf("%s: plane %d is %llx, want %llx\n", name, k, (unsigned long long)B[k * n], (unsigned long long)want);
+			++test_failures;
+		}
+		for(int gap = 1; gap < n; ++gap) {
+			CHECK_EQ(B[k * n + gap], marker);
+		}
+	}
+	CHECK_EQ(B[8 * n], marker);
+}
+
+template<int LANES, bool MSB, int m, int n, typename PLANE>
+static void check_all(const char *name) {
+	uint8_t A[32 * m];
+
+	// every single bit input: each one lands in one bit of one plane
+	for(int lane = 0; lane < LANES && !TEST_GIVE_UP(); ++lane) {
+		for(int bit = 0; bit < 8; ++bit) {
+			memset(A, 0, sizeof(A));
+			A[lane * m] = 1 << bit;
+			check_transpose<LANES, MSB, m, n, PLANE>(A, name);
+		}
+	}
+
+	// all ones, and random lanes (with random bytes between them when strided)
+	memset(A, 0xFF, sizeof(A));
+	check_transpose<LANES, MSB, m, n, PLANE>(A, name);
+	uint32_t seed = LANES * 4 + m * 2 + n;
+	for(int i = 0; i < NUM_RANDOM && !TEST_GIVE_UP(); ++i) {
+		for(size_t j = 0; j < sizeof(A); ++j) { A[j] = test_random(seed); }
+		check_transpose<LANES, MSB, m, n, PLANE>(A, name);
+	}
+}
+
+#define CHECK_LANES(LANES, MSB, m, n, PLANE) \
+	check_all<LANES, MSB, m, n, PLANE>("transposeLanes<" #LANES ", " #MSB ", " #m ", " #n "> into " #PLANE)
+
+int main() {
+	CHECK_LANES(8, true, 1, 1, uint8_t);
+	CHECK_LANES(8, false, 1, 1, uint8_t);
+	CHECK_LANES(8, true, 1, 1, uint32_t);
+	CHECK_LANES(8, true, 3, 2, uint8_t);
+	CHECK_LANES(8, false, 3, 1, uint16_t);
+
+	CHECK_LANES(16, true, 1, 1, uint16_t);
+	CHECK_LANES(16, false, 1, 1, uint16_t);
+	CHECK_LANES(16, true, 3, 1, uint32_t);
+	CHECK_LANES(16, false, 1, 3, uint16_t);
+
+	CHECK_LANES(24, true, 1, 1, uint32_t);
+	CHECK_LANES(24, false, 1, 1, uint32_t);
+	CHECK_LANES(24, true, 3, 2, uint32_t);
+	CHECK_LANES(24, false, 2, 1, uint64_t);
+
+	CHECK_LANES(32, true, 1, 1, uint32_t);
+	CHECK_LANES(32, false, 1, 1, uint32_t);
+	CHECK_LANES(32, true, 3, 1, uint32_t);
+	CHECK_LANES(32, false, 1, 2, uint32_t);
+
+	TEST_RESULT();
+}
@@ -0,0 +1,242 @@
+// Checks of XYMap: the layouts against tables worked out by hand, and against a walk along
+// the strip for bigger matrices (row-major, serpentine, tiled panels, each at every rotation),
+// the function and table layouts, storage passed in, a map without a table, and the noise
+// fills that write through a map against the ones that don't.
+
+#include "test.h"
+#include <string.h>
+
+#define MAX_LEDS 1024
+
+uint16_t expected[MAX_LEDS];
+uint16_t storage[MAX_LEDS];
+uint16_t shuffled[MAX_LEDS];
+CRGB leds[MAX_LEDS];
+CRGB want[MAX_LEDS];
+
+static bool check_map(const XYMap & xymap, const uint16_t *table, const char *name) {
+	for(uint16_t y = 0; y < xymap.getHeight(); ++y) {
+		for(uint16_t x = 0; x < xymap.getWidth(); ++x) {
+			uint16_t want = table[y * xymap.getWidth() + x];
+			if(xymap(x, y) != want || xymap.mapXY(x, y) != want) {
+				printf("%s, %dx%d: (%d, %d) maps to %d, not %d\n", name, xymap.getWidth(), xymap.getHeight(), x, y, xymap(x, y), want);
+				++test_failures;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// a 3x2 matrix, in every layout and rotation, worked out by hand:
+//
+//   row-major   serpentine   the strip mounted at quarter turns, 2 wide and 3 high for odd turns
+//     0 1 2       0 1 2
+//     3 4 5       5 4 3
+static void test_small() {
+	static const uint16_t rowMajor[4][6] = {
+		{ 0, 1, 2, 3, 4, 5 },
+		{ 1, 3, 5, 0, 2, 4 },
+		{ 5, 4, 3, 2, 1, 0 },
+		{ 4, 2, 0, 5, 3, 1 },
+	};
+	static const uint16_t serpentine[4][6] = {
+		{ 0, 1, 2, 5, 4, 3 },
+		{ 1, 2, 5, 0, 3, 4 },
+		{ 3, 4, 5, 2, 1, 0 },
+		{ 4, 3, 0, 5, 2, 1 },
+	};
+	XYMap xymap(3, 2);
+	CHECK(check_map(xymap, rowMajor[0], "row-major by default"));
+	for(uint8_t r = 0; r < 4; ++r) {
+		xymap.setRowMajor(r);
+		CHECK(check_map(xymap, rowMajor[r], "row-major"));
+		xymap.setSerpentine(r);
+		CHECK(check_map(xymap, serpentine[r], "serpentine"));
+		// only the quarter turns count
+		xymap.setSerpentine(r + 4);
+		CHECK(check_map(xymap, serpentine[r], "serpentine, more than a full turn"));
+	}
+
+	// 4x4 of 2x2 panels, serpentine inside each panel and from one row of panels to the next
+	static const uint16_t panels[16] = {
+		 0,  1,  4,  5,
+		 3,  2,  7,  6,
+		12, 13,  8,  9,
+		15, 14, 11, 10,
+	};
+	XYMap tiled(4, 4);
+	tiled.setPanels(2, 2, true, true);
+	CHECK(check_map(tiled, panels, "panels"));
+}
+
+// the physical position of a logical one, for a matrix mounted at a quarter turn (the turns
+// that test_small() works through by hand)
+static void rotate(uint16_t w, uint16_t h, uint16_t x, uint16_t y, uint8_t rotation, uint16_t & px, uint16_t & py) {
+	switch(rotation & 3) {
+		case 0: px = x; py = y; break;
+		case 1: px = h - 1 - y; py = x; break;
+		case 2: px = w - 1 - x; py = h - 1 - y; break;
+		case 3: px = y; py = w - 1 - x; break;
+	}
+}
+
+// follow the strip from its first led, panel by panel and row by row, numbering the physical
+// positions it passes through, then look each logical position up
+static void walk(uint16_t w, uint16_t h, uint16_t panelW, uint16_t panelH, bool serpentine, bool serpentinePanels, uint8_t rotation) {
+	uint16_t physW = (rotation & 1) ? h : w;
+	uint16_t physH = (rotation & 1) ? w : h;
+	static uint16_t physical[MAX_LEDS];
+	uint16_t led = 0;
+	for(uint16_t pr = 0; pr < physH / panelH; ++pr) {
+		for(uint16_t n = 0; n < physW / panelW; ++n) {
+			uint16_t pc = (serpentinePanels && (pr & 1)) ? physW / panelW - 1 - n : n;
+			for(uint16_t ly = 0; ly < panelH; ++ly) {
+				for(uint16_t k = 0; k < panelW; ++k) {
+					uint16_t lx = (serpentine && (ly & 1)) ? panelW - 1 - k : k;
+					physical[(pr * panelH + ly) * physW + pc * panelW + lx] = led++;
+				}
+			}
+		}
+	}
+	for(uint16_t y = 0; y < h; ++y) {
+		for(uint16_t x = 0; x < w; ++x) {
+			uint16_t px, py;
+			rotate(w, h, x, y, rotation, px, py);
+			expected[y * w + x] = physical[py * physW + px];
+		}
+	}
+}
+
+// every layout of bigger matrices, which also have to use every led exactly once
+static void test_layouts() {
+	struct Layout { uint16_t w, h, panelW, panelH; };
+	static const Layout layouts[] = {
+		{ 16, 16, 0, 0 }, { 37, 11, 0, 0 }, { 1, 20, 0, 0 }, { 20, 1, 0, 0 },
+		{ 32, 16, 8, 8 }, { 24, 8, 8, 4 }, { 30, 12, 5, 3 }, { 16, 16, 16, 4 },
+	};
+	for(size_t l = 0; l < sizeof(layouts) / sizeof(layouts[0]) && !TEST_GIVE_UP(); ++l) {
+		const Layout & t = layouts[l];
+		XYMap xymap(t.w, t.h);
+		CHECK_EQ(xymap.getSize(), t.w * t.h);
+		for(uint8_t r = 0; r < 4; ++r) {
+			// the panels are given in physical size, so they have to fit the turned matrix
+			uint16_t physW = (r & 1) ? t.h : t.w;
+			uint16_t physH = (r & 1) ? t.w : t.h;
+			uint16_t panelW = (t.panelW && physW % t.panelW == 0) ? t.panelW : physW;
+			uint16_t panelH = (t.panelH && physH % t.panelH == 0) ? t.panelH : physH;
+			for(int mode = 0; mode < 4; ++mode) {
+				bool serpentine = mode & 1;
+				bool serpentinePanels = mode & 2;
+				xymap.setPanels(panelW == physW ? 0 : panelW, panelH == physH ? 0 : panelH, serpentine, serpentinePanels, r);
+				walk(t.w, t.h, panelW, panelH, serpentine, serpentinePanels, r);
+				CHECK(check_map(xymap, expected, "panels"));
+
+				static bool used[MAX_LEDS];
+				memset(used, 0, sizeof(used));
+				for(uint32_t i = 0; i < xymap.getSize(); ++i) {
+					uint16_t led = xymap.getTable()[i];
+					CHECK(led < xymap.getSize() && !used[led]);
+					used[led] = true;
+				}
+			}
+			// the shorthands are single panels
+			xymap.setSerpentine(r);
+			walk(t.w, t.h, physW, physH, true, false, r);
+			CHECK(check_map(xymap, expected, "serpentine"));
+			xymap.setRowMajor(r);
+			walk(t.w, t.h, physW, physH, false, false, r);
+			CHECK(check_map(xymap, expected, "row-major"));
+		}
+	}
+}
+
+static uint16_t diagonal(uint16_t x, uint16_t y) { return (x * 7 + y * 13) % 1000; }
+
+// the function and table layouts, storage passed in, and a map without a table
+static void test_sources(uint32_t & seed) {
+	const uint16_t w = 20, h = 9;
+	XYMap xymap(w, h, storage);
+	CHECK(xymap.getTable() == storage);
+	for(uint16_t i = 0; i < w * h; ++i) { expected[i] = i; }
+	CHECK(check_map(xymap, expected, "storage, row-major by default"));
+
+	xymap.setFunction(diagonal);
+	for(uint16_t y = 0; y < h; ++y) {
+		for(uint16_t x = 0; x < w; ++x) { expected[y * w + x] = diagonal(x, y); }
+	}
+	CHECK(check_map(xymap, expected, "function"));
+	CHECK(xymap.getTable() == storage);
+
+	for(uint16_t i = 0; i < w * h; ++i) { shuffled[i] = test_random(seed); }
+	xymap.setTable(shuffled);
+	CHECK(check_map(xymap, shuffled, "table"));
+	// the table is copied
+	memcpy(expected, shuffled, sizeof(shuffled));
+	shuffled[0] ^= 1;
+	CHECK(check_map(xymap, expected, "table, changed after"));
+
+	// with no table, it's row-major, and stays that way
+	XYMap none(w, h, NULL);
+	CHECK(none.getTable() == NULL);
+	none.setSerpentine(1).setFunction(diagonal).setTable(shuffled);
+	for(uint16_t i = 0; i < w * h; ++i) { expected[i] = i; }
+	CHECK(check_map(none, expected, "no table"));
+}
+
+static void fill_random(CRGB *data, int n, uint32_t & seed) {
+	for(int i = 0; i < n; ++i) {
+		data[i] = CRGB(test_random(seed), test_random(seed), test_random(seed));
+	}
+}
+
+// the noise fills through a map, against the serpentine flag, and against filling row-major
+// and moving each pixel to where the map puts it
+static void test_noise(uint32_t & seed) {
+	const uint16_t w = 23, h = 10;
+	const int n = w * h;
+	static CRGB rowMajor[MAX_LEDS];
+	XYMap xymap(w, h);
+	for(int b = 0; b < 2 && !TEST_GIVE_UP(); ++b) {
+		bool blend = b != 0;
+		uint16_t t = test_random(seed);
+
+		xymap.setSerpentine();
+		fill_random(leds, n, seed);
+		memcpy(want, leds, sizeof(CRGB) * n);
+		fill_2dnoise8(leds, xymap, 2, 1000, 300, 2000, 300, t, 1, 500, 30, 700, 30, t, blend);
+		fill_2dnoise8(want, w, h, true, 2, 1000, 300, 2000, 300, t, 1, 500, 30, 700, 30, t, blend);
+		CHECK(memcmp(leds, want, sizeof(CRGB) * n) == 0);
+
+		fill_random(leds, n, seed);
+		memcpy(want, leds, sizeof(CRGB) * n);
+		fill_2dnoise16(leds, xymap, 2, 100000, 2000, 200000, 2000, t * 16, 1, 5000, 300, 7000, 300, t, blend, 0x1200);
+		fill_2dnoise16(want, w, h, true, 2, 100000, 2000, 200000, 2000, t * 16, 1, 5000, 300, 7000, 300, t, blend, 0x1200);
+		CHECK(memcmp(leds, want, sizeof(CRGB) * n) == 0);
+
+		xymap.setPanels(0, 5, true, true, 2);
+		fill_random(rowMajor, n, seed);
+		for(uint16_t y = 0; y < h; ++y) {
+			for(uint16_t x = 0; x < w; ++x) { leds[xymap(x, y)] = rowMajor[y * w + x]; }
+		}
+		fill_2dnoise8(rowMajor, w, h, false, 1, 3000, 100, 400, 500, t, 2, 50, 60, 70, 80, t, blend);
+		fill_2dnoise8(leds, xymap, 1, 3000, 100, 400, 500, t, 2, 50, 60, 70, 80, t, blend);
+		for(uint16_t y = 0; y < h; ++y) {
+			for(uint16_t x = 0; x < w; ++x) { CHECK(leds[xymap(x, y)] == rowMajor[y * w + x]); }
+		}
+		fill_2dnoise16(rowMajor, w, h, false, 1, 30000, 1000, 4000, 5000, t, 2, 50, 60, 70, 80, t, blend);
+		fill_2dnoise16(leds, xymap, 1, 30000, 1000, 4000, 5000, t, 2, 50, 60, 70, 80, t, blend);
+		for(uint16_t y = 0; y < h; ++y) {
+			for(uint16_t x = 0; x < w; ++x) { CHECK(leds[xymap(x, y)] == rowMajor[y * w + x]); }
+		}
+	}
+}
+
+int main() {
+	uint32_t seed = 10;
+	test_small();
+	test_layouts();
+	test_sources(seed);
+	test_noise(seed);
+	TEST_RESULT();
+}